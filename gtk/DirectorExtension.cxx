@@ -34,6 +34,7 @@
 // The License.txt file describes the conditions under which this software may be distributed.
 
 #include <cstdlib>
+#include <cstdint>
 #include <cstring>
 #include <cstdio>
 #include <ctime>
@@ -79,6 +80,7 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
 #include "DirectorExtension.h"
@@ -4,6 +4,7 @@
 // The License.txt file describes the conditions under which this software may be distributed.
 
 #include <cstdlib>
+#include <cstdint>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
@@ -26,6 +27,7 @@
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <thread>
 
 #include <fcntl.h>
 #include <unistd.h>
@@ -55,6 +57,7 @@
 #include "StringList.h"
 #include "StringHelpers.h"
 #include "FilePath.h"
+#include "PhaseProfile.h"
 #include "StyleDefinition.h"
 #include "PropSetFile.h"
 
@@ -68,6 +71,7 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
 #include "StripDefinition.h"
@@ -387,9 +391,11 @@ class DialogFindInFiles : public FindDialog, public SearchUI {
 public:
 	WComboBoxEntry wComboFiles;
 	WComboBoxEntry wComboFindInFiles;
+	WComboBoxEntry wComboReplace;
 	WComboBoxEntry comboDir;
 	WToggle toggleWord;
 	WToggle toggleCase;
+	WToggle toggleRegExp;
 	WButton btnDotDot;
 	WButton btnBrowse;
 	void GrabFields();
@@ -625,7 +631,8 @@ protected:
 
 	// GTK Signal Handlers
 
-	void FindInFilesCmd();
+	void FindInFilesCmd(bool replace);
+	void FindInFilesChanged();
 	void FindInFilesDotDot();
 	void FindInFilesBrowse();
 
@@ -2015,22 +2022,34 @@ void DialogFindInFiles::GrabFields() {
 		pSearcher->wholeWord = toggleWord.Active();
 	if (toggleCase.Sensitive())
 		pSearcher->matchCase = toggleCase.Active();
+	if (toggleRegExp.Sensitive())
+		pSearcher->regExp = toggleRegExp.Active();
 }
 
 void DialogFindInFiles::FillFields() {
 	wComboFindInFiles.FillFromMemory(pSearcher->memFinds.AsVector());
+	wComboReplace.FillFromMemory(pSearcher->memReplaces.AsVector());
 	if (toggleWord.Sensitive())
 		toggleWord.SetActive(pSearcher->wholeWord);
 	if (toggleCase.Sensitive())
 		toggleCase.SetActive(pSearcher->matchCase);
+	if (toggleRegExp.Sensitive())
+		toggleRegExp.SetActive(pSearcher->regExp);
 }
 
 void DialogFindInFiles::FillCombosInDialog() {
 	wComboFindInFiles.FillFromMemory(pSearcher->memFinds.AsVector());
+	wComboReplace.FillFromMemory(pSearcher->memReplaces.AsVector());
 }
 
-void SciTEGTK::FindInFilesCmd() {
+void SciTEGTK::FindInFilesCmd(bool replace) {
 	dlgFindInFiles.GrabFields();
+	if (replace && findWhat.empty()) {
+		return;
+	}
+	if (replace) {
+		SetReplace(dlgFindInFiles.wComboReplace.Text());
+	}
 
 	const char *dirEntry = dlgFindInFiles.comboDir.Text();
 	props.Set("find.directory", dirEntry);
@@ -2047,7 +2066,8 @@ void SciTEGTK::FindInFilesCmd() {
 	}
 
 	SelectionIntoProperties();
-	std::string findCommand = props.GetNewExpandString("find.command");
+	// Only the internal search can replace
+	std::string findCommand = replace ? std::string() : props.GetNewExpandString("find.command");
 	if (findCommand == "") {
 		findCommand = sciteExecutable.AsInternal();
 		findCommand += " -grep ";
@@ -2055,6 +2075,12 @@ void SciTEGTK::FindInFilesCmd() {
 		findCommand += (matchCase ? "c" : "~");
 		findCommand += props.GetInt("find.in.dot") ? "d" : "~";
 		findCommand += props.GetInt("find.in.binary") ? "b" : "~";
+		findCommand += (regExp ? "r" : "~");
+		findCommand += props.GetInt("find.replace.regexp.posix") ? "p" : "~";
+		findCommand += props.GetInt("find.in.files.index") ? "i" : "~";
+		findCommand += props.GetInt("find.in.files.ignore") ? "g" : "~";
+		findCommand += (replace ? "s" : "~");
+		findCommand += GrepLimitsText();
 		findCommand += " \"";
 		findCommand += props.GetString("find.files");
 		findCommand += "\" \"";
@@ -2063,6 +2089,11 @@ void SciTEGTK::FindInFilesCmd() {
 		std::string quotedForm = Slash(props.GetString("find.what"), true);
 		findCommand += quotedForm;
 		findCommand += "\"";
+		if (replace) {
+			findCommand += " \"";
+			findCommand += Slash(replaceWhat, true);
+			findCommand += "\"";
+		}
 	}
 	AddCommand(findCommand, props.GetString("find.directory"), JobSubsystem::cli);
 	if (jobQueue.HasCommandToRun())
@@ -2073,6 +2104,13 @@ void SciTEGTK::FindInFilesCmd() {
 	}
 }
 
+void SciTEGTK::FindInFilesChanged() {
+	// An empty search matches at every position so there is nothing sensible to replace
+	const char *findEntry = gtk_entry_get_text(dlgFindInFiles.wComboFindInFiles.Entry());
+	gtk_dialog_set_response_sensitive(GTK_DIALOG(PWidget(dlgFindInFiles)), GTK_RESPONSE_APPLY,
+		findEntry && *findEntry);
+}
+
 void SciTEGTK::FindInFilesDotDot() {
 	FilePath findInDir(dlgFindInFiles.comboDir.Text());
 	gtk_entry_set_text(dlgFindInFiles.comboDir.Entry(), findInDir.Directory().AsInternal());
@@ -2123,7 +2161,11 @@ const SearchOption toggles[] = {
 void SciTEGTK::FindInFilesResponse(int responseID) {
 	switch (responseID) {
 		case GTK_RESPONSE_OK:
-			FindInFilesCmd() ;
+			FindInFilesCmd(false);
+			break;
+
+		case GTK_RESPONSE_APPLY:
+			FindInFilesCmd(true);
 			break;
 
 		case GTK_RESPONSE_CANCEL:
@@ -2147,7 +2189,7 @@ void SciTEGTK::FindInFiles() {
 
 	dlgFindInFiles.Create(localiser.Text("Find in Files"));
 
-	WTable table(4, 5);
+	WTable table(5, 5);
 	table.PackInto(GTK_BOX(dlgFindInFiles.ContentArea()));
 
 	WStatic labelFind;
@@ -2162,6 +2204,15 @@ void SciTEGTK::FindInFiles() {
 	dlgFindInFiles.wComboFindInFiles.ActivatesDefault();
 	labelFind.SetMnemonicFor(dlgFindInFiles.wComboFindInFiles);
 
+	WStatic labelReplace;
+	labelReplace.Create(localiser.Text("Rep_lace with:"));
+	table.Label(labelReplace);
+
+	dlgFindInFiles.wComboReplace.Create();
+	table.Add(dlgFindInFiles.wComboReplace, 4, true);
+	gtk_entry_set_text(dlgFindInFiles.wComboReplace.Entry(), replaceWhat.c_str());
+	labelReplace.SetMnemonicFor(dlgFindInFiles.wComboReplace);
+
 	WStatic labelFiles;
 	labelFiles.Create(localiser.Text("_Files:"));
 	table.Label(labelFiles);
@@ -2205,13 +2256,23 @@ void SciTEGTK::FindInFiles() {
 	dlgFindInFiles.toggleCase.Create(localiser.Text(toggles[SearchOption::tCase].label));
 	table.Add(dlgFindInFiles.toggleCase, 1, true, 3, 0);
 
+	// Regular Expression
+	dlgFindInFiles.toggleRegExp.Create(localiser.Text(toggles[SearchOption::tRegExp].label));
+	table.Add(dlgFindInFiles.toggleRegExp, 1, true, 3, 0);
+
 	AttachResponse<&SciTEGTK::FindInFilesResponse>(PWidget(dlgFindInFiles), this);
 	dlgFindInFiles.ResponseButton(localiser.Text("_Cancel"), GTK_RESPONSE_CANCEL);
+	dlgFindInFiles.ResponseButton(localiser.Text("_Replace"), GTK_RESPONSE_APPLY);
 	dlgFindInFiles.ResponseButton(localiser.Text("F_ind"), GTK_RESPONSE_OK);
 	gtk_dialog_set_default_response(GTK_DIALOG(PWidget(dlgFindInFiles)), GTK_RESPONSE_OK);
 
 	dlgFindInFiles.FillFields();
 
+	Signal<&SciTEGTK::FindInFilesChanged> sigChanged;
+	g_signal_connect(G_OBJECT(dlgFindInFiles.wComboFindInFiles.Entry()), "changed",
+		G_CALLBACK(sigChanged.Function), this);
+	FindInFilesChanged();
+
 	gtk_widget_grab_focus(GTK_WIDGET(dlgFindInFiles.wComboFindInFiles.Entry()));
 
 	dlgFindInFiles.Display(PWidget(wSciTE));
@@ -3804,6 +3865,7 @@ void SciTEGTK::LayoutUI() {
 }
 
 void SciTEGTK::CreateUI() {
+	const PhaseTimer timer("CreateUI");
 #if !GTK_CHECK_VERSION(3,0,0)
 	gtk_rc_parse_string(
 		"style \"toggler-style\" {\n"
@@ -3935,6 +3997,10 @@ void SciTEGTK::CreateUI() {
 	g_signal_connect(G_OBJECT(PWidget(wOutput)), SCINTILLA_NOTIFY,
 	                   G_CALLBACK(NotifySignal), this);
 
+	// Never shown and no notification handler
+	wReplacer.SetScintilla(scintilla_new());
+	g_object_ref_sink(G_OBJECT(PWidget(wReplacer)));
+
 	splitVertical = props.GetInt("split.vertical", 0);
 	LayoutUI();
 
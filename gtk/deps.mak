@@ -45,6 +45,7 @@ SciTEGTK.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/Extender.h \
@@ -83,6 +84,14 @@ Widget.o: \
 	../src/GUI.h \
 	../src/StringHelpers.h \
 	Widget.h
+BufferReplacer.o: \
+	../src/BufferReplacer.cxx \
+	../../scintilla/include/ILoader.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/ScintillaTypes.h \
+	../../scintilla/include/ScintillaCall.h \
+	../src/GUI.h \
+	../src/BufferReplacer.h
 Cookie.o: \
 	../src/Cookie.cxx \
 	../src/GUI.h \
@@ -108,6 +117,7 @@ Credits.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 EditorConfig.o: \
@@ -137,6 +147,7 @@ ExportHTML.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportPDF.o: \
@@ -159,6 +170,7 @@ ExportPDF.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportRTF.o: \
@@ -181,6 +193,7 @@ ExportRTF.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportTEX.o: \
@@ -203,6 +216,7 @@ ExportTEX.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportXML.o: \
@@ -225,6 +239,7 @@ ExportXML.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 FilePath.o: \
@@ -242,11 +257,31 @@ FileWorker.o: \
 	../src/Worker.h \
 	../src/Utf8_16.h \
 	../src/FileWorker.h
+Grep.o: \
+	../src/Grep.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/Cookie.h \
+	../src/Utf8_16.h \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h \
+	../src/TrigramIndex.h \
+	../src/IgnoreRules.h \
+	../src/ThreadPool.h \
+	../src/Grep.h
 IFaceTable.o: \
 	../src/IFaceTable.cxx \
 	../src/GUI.h \
 	../src/StringHelpers.h \
 	../src/IFaceTable.h
+IgnoreRules.o: \
+	../src/IgnoreRules.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/PathMatch.h \
+	../src/IgnoreRules.h
 JobQueue.o: \
 	../src/JobQueue.cxx \
 	../src/GUI.h \
@@ -277,6 +312,10 @@ MatchMarker.o: \
 	../../scintilla/include/ScintillaTypes.h \
 	../../scintilla/include/ScintillaCall.h \
 	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h \
+	../src/ThreadPool.h \
 	../src/MatchMarker.h
 MultiplexExtension.o: \
 	../src/MultiplexExtension.cxx \
@@ -291,14 +330,29 @@ PathMatch.o: \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
 	../src/PathMatch.h
+PhaseProfile.o: \
+	../src/PhaseProfile.cxx \
+	../src/GUI.h \
+	../src/PhaseProfile.h
 PropSetFile.o: \
 	../src/PropSetFile.cxx \
 	../src/GUI.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
 	../src/PathMatch.h \
+	../src/PhaseProfile.h \
 	../src/PropSetFile.h \
 	../src/EditorConfig.h
+PropSetSnapshot.o: \
+	../src/PropSetSnapshot.cxx \
+	../src/GUI.h \
+	../src/FilePath.h \
+	../src/PropSetFile.h \
+	../src/PropSetSnapshot.h
+RegexSearch.o: \
+	../src/RegexSearch.cxx \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h
 ScintillaWindow.o: \
 	../src/ScintillaWindow.cxx \
 	../../scintilla/include/ScintillaTypes.h \
@@ -322,6 +376,7 @@ SciTEBase.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -333,6 +388,8 @@ SciTEBase.o: \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
+	../src/WordIndex.h \
 	../src/EditorConfig.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
@@ -348,6 +405,7 @@ SciTEBuffers.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -359,6 +417,7 @@ SciTEBuffers.o: \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 SciTEIO.o: \
@@ -382,7 +441,9 @@ SciTEIO.o: \
 	../src/Worker.h \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
+	../src/Grep.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 SciTEProps.o: \
@@ -401,8 +462,10 @@ SciTEProps.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
+	../src/PropSetSnapshot.h \
 	../src/StyleWriter.h \
 	../src/Extender.h \
 	../src/SciTE.h \
@@ -410,6 +473,7 @@ SciTEProps.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/EditorConfig.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h \
@@ -422,7 +486,8 @@ StringList.o: \
 	../src/StringList.cxx \
 	../src/GUI.h \
 	../src/StringList.h \
-	../src/StringHelpers.h
+	../src/StringHelpers.h \
+	../src/FilePath.h
 StyleDefinition.o: \
 	../src/StyleDefinition.cxx \
 	../../scintilla/include/ScintillaTypes.h \
@@ -436,10 +501,31 @@ StyleWriter.o: \
 	../../scintilla/include/ScintillaStructures.h \
 	../src/GUI.h \
 	../src/StyleWriter.h
+SubstringSearch.o: \
+	../src/SubstringSearch.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/SubstringSearch.h
+ThreadPool.o: \
+	../src/ThreadPool.cxx \
+	../src/ThreadPool.h
+TrigramIndex.o: \
+	../src/TrigramIndex.cxx \
+	../src/GUI.h \
+	../src/FilePath.h \
+	../src/TrigramIndex.h
 Utf8_16.o: \
 	../src/Utf8_16.cxx \
 	../src/Cookie.h \
 	../src/Utf8_16.h
+WordIndex.o: \
+	../src/WordIndex.cxx \
+	../../scintilla/include/ScintillaTypes.h \
+	../../scintilla/include/ScintillaCall.h \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/WordIndex.h
 lapi.o: \
 	../lua/src/lapi.c \
 	../lua/src/lprefix.h \
@@ -0,0 +1,148 @@
+// SciTE - Scintilla based Text Editor
+/** @file BufferReplacer.cxx
+ ** Replace all the matches of a string in a set of documents.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+
+#include "ILoader.h"
+#include "ScintillaTypes.h"
+#include "ScintillaCall.h"
+
+#include "GUI.h"
+
+#include "BufferReplacer.h"
+
+namespace SA = Scintilla;
+
+BufferReplacer::BufferReplacer() noexcept = default;
+
+BufferReplacer::~BufferReplacer() {
+	Release();
+}
+
+void BufferReplacer::Release() noexcept {
+	for (SA::IDocumentEditable *pDoc : documents) {
+		try {
+			pDoc->Release();
+		} catch (...) {
+			// Release must not throw, ignore if it does.
+		}
+	}
+	documents.clear();
+	current = 0;
+}
+
+void BufferReplacer::Start(SA::ScintillaCall *pSci_, const std::vector<SA::IDocumentEditable *> &documents_,
+			   const std::string &findTarget_, const std::string &replaceTarget_,
+			   SA::FindOption flags_, bool regExp_) {
+	Stop();
+	pSci = pSci_;
+	findTarget = findTarget_;
+	replaceTarget = replaceTarget_;
+	flags = flags_;
+	regExp = regExp_;
+	replacements = 0;
+	documents = documents_;
+	for (SA::IDocumentEditable *pDoc : documents) {
+		pDoc->AddRef();
+	}
+}
+
+bool BufferReplacer::Complete() const noexcept {
+	return current >= documents.size();
+}
+
+SA::IDocumentEditable *BufferReplacer::Continue(double duration) {
+	GUI::ElapsedTime elapsed;
+	if (Complete()) {
+		return nullptr;
+	}
+	if (!attached) {
+		pSci->SetDocPointer(documents[current]);
+		pSci->SetSearchFlags(flags);
+		attached = true;
+		position = 0;
+		notEmptyAtStart = false;
+	}
+	bool finished = pSci->ReadOnly();
+	bool grouped = false;
+	while (!finished) {
+		const SA::Position length = pSci->Length();
+		if (position > length) {
+			// Document shortened by the user between steps
+			position = length;
+		}
+		pSci->SetTarget(SA::Span(position, length));
+		SA::Position posFind = pSci->SearchInTarget(findTarget);
+		if (notEmptyAtStart && (posFind == position) && (pSci->TargetEnd() == posFind)) {
+			// Do not match the empty string again at the end of the previous replacement
+			if (position >= length) {
+				posFind = SA::InvalidPosition;
+			} else {
+				pSci->SetTarget(SA::Span(pSci->PositionAfter(position), length));
+				posFind = pSci->SearchInTarget(findTarget);
+			}
+		}
+		if (posFind < 0) {
+			finished = true;
+			break;
+		}
+		const SA::Position lenTarget = pSci->TargetEnd() - posFind;
+		if (!grouped) {
+			pSci->BeginUndoAction();
+			grouped = true;
+		}
+		SA::Position lenReplaced = replaceTarget.length();
+		if (regExp) {
+			lenReplaced = pSci->ReplaceTargetRE(replaceTarget);
+			notEmptyAtStart = lenTarget <= 0;
+		} else {
+			pSci->ReplaceTarget(replaceTarget);
+		}
+		replacements++;
+		position = posFind + lenReplaced;
+		if (position >= pSci->Length()) {
+			// Run off the end of the document with an empty match
+			finished = true;
+		} else if (elapsed.Duration() > duration) {
+			break;
+		}
+	}
+	if (grouped) {
+		pSci->EndUndoAction();
+	}
+	if (!finished) {
+		return nullptr;
+	}
+	// Left attached until the next step so the caller can examine the document
+	attached = false;
+	return documents[current++];
+}
+
+void BufferReplacer::Stop() {
+	if (pSci) {
+		pSci->SetDocPointer(nullptr);
+	}
+	attached = false;
+	Release();
+}
+
+size_t BufferReplacer::Total() const noexcept {
+	return documents.size();
+}
+
+size_t BufferReplacer::Progress() const noexcept {
+	return current;
+}
+
+intptr_t BufferReplacer::Replacements() const noexcept {
+	return replacements;
+}
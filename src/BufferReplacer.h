@@ -0,0 +1,52 @@
+// SciTE - Scintilla based Text Editor
+/** @file BufferReplacer.h
+ ** Replace all the matches of a string in a set of documents.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef BUFFERREPLACER_H
+#define BUFFERREPLACER_H
+
+/**
+ * Replaces in documents through a Scintilla instance that is not shown so the documents
+ * do not have to be made current. Works in steps of limited duration called from the
+ * idle loop. The replacements made in each step are one undo action so that edits made
+ * between steps to a document also open in an editor are not merged with them.
+ */
+class BufferReplacer {
+	Scintilla::ScintillaCall *pSci = nullptr;
+	std::string findTarget;
+	std::string replaceTarget;
+	Scintilla::FindOption flags = static_cast<Scintilla::FindOption>(0);
+	bool regExp = false;
+	// References are held so documents closed while replacing remain valid.
+	std::vector<Scintilla::IDocumentEditable *> documents;
+	size_t current = 0;
+	Scintilla::Position position = 0;
+	bool notEmptyAtStart = false;
+	bool attached = false;
+	intptr_t replacements = 0;
+	void Release() noexcept;
+public:
+	BufferReplacer() noexcept;
+	// Deleted so BufferReplacer objects can not be copied.
+	BufferReplacer(const BufferReplacer &) = delete;
+	BufferReplacer(BufferReplacer &&) = delete;
+	BufferReplacer &operator=(const BufferReplacer &) = delete;
+	BufferReplacer &operator=(BufferReplacer &&) = delete;
+	~BufferReplacer();
+	void Start(Scintilla::ScintillaCall *pSci_, const std::vector<Scintilla::IDocumentEditable *> &documents_,
+		   const std::string &findTarget_, const std::string &replaceTarget_,
+		   Scintilla::FindOption flags_, bool regExp_);
+	bool Complete() const noexcept;
+	/// Replace for about duration seconds and return the document finished, if any,
+	/// while it is still attached to pSci so its state can be read.
+	Scintilla::IDocumentEditable *Continue(double duration);
+	void Stop();
+	size_t Total() const noexcept;
+	size_t Progress() const noexcept;
+	intptr_t Replacements() const noexcept;
+};
+
+#endif
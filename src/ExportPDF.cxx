@@ -48,6 +48,7 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
 
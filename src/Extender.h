@@ -27,6 +27,14 @@ public:
 	virtual ~ExtensionAPI() {
 	}
 	enum Pane { paneEditor=1, paneOutput=2, paneFindOutput=3 };
+	/// Lookups of one property key through one operation counted while props.stats is set.
+	struct PropertyStatistic {
+		std::string operation;
+		std::string key;
+		size_t calls;
+		size_t depth;
+		double seconds;
+	};
 	virtual intptr_t Send(Pane p, Scintilla::Message msg, uintptr_t wParam=0, intptr_t lParam=0)=0;
 	virtual std::string Range(Pane p, Scintilla::Span range)=0;
 	virtual void Remove(Pane p, Scintilla::Position start, Scintilla::Position end)=0;
@@ -45,6 +53,8 @@ public:
 	virtual void UserStripSetList(int control, const char *value)=0;
 	virtual std::string UserStripValue(int control)=0;
 	virtual Scintilla::ScintillaCall &PaneCaller(Pane p) noexcept =0;
+	virtual std::vector<Scintilla::Line> FindMatchLines()=0;
+	virtual std::vector<PropertyStatistic> PropertyStatistics()=0;
 };
 
 /**
@@ -6,11 +6,13 @@
 // The License.txt file describes the conditions under which this software may be distributed.
 
 #include <cstdlib>
+#include <cstdint>
 #include <cstring>
 #include <cstdio>
 #include <ctime>
 #include <cerrno>
 
+#include <limits>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -26,6 +28,7 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/mman.h>
 
 #endif
 
@@ -456,7 +459,15 @@ void FilePath::List(FilePathSet &directories, FilePathSet &files) const {
 		std::string_view entryName = ent->d_name;
 		if ((entryName != currentDirectory) && (entryName != parentDirectory)) {
 			FilePath pathFull(AsInternal(), ent->d_name);
-			if (pathFull.IsDirectory()) {
+#if defined(DT_DIR)
+			// Avoid a stat call when the file system reports the type.
+			// Symbolic links are followed so the type of their target is needed.
+			const bool isDirectory = (ent->d_type == DT_DIR) ||
+				(((ent->d_type == DT_UNKNOWN) || (ent->d_type == DT_LNK)) && pathFull.IsDirectory());
+#else
+			const bool isDirectory = pathFull.IsDirectory();
+#endif
+			if (isDirectory) {
 				directories.push_back(pathFull);
 			} else {
 				files.push_back(pathFull);
@@ -499,6 +510,178 @@ void FilePath::Remove() const noexcept {
 	unlink(AsInternal());
 }
 
+bool FilePath::Replace(const FilePath &target) const noexcept {
+#if defined(_WIN32)
+	return ::MoveFileExW(AsInternal(), target.AsInternal(),
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	FileStatus statusTarget;
+	if (stat(target.AsInternal(), &statusTarget) == 0) {
+		// Keep the owner where permitted, which is often only the group for other users' files
+		if (chown(AsInternal(), statusTarget.st_uid, statusTarget.st_gid) != 0) {
+			[[maybe_unused]] const int unchanged = chown(AsInternal(), -1, statusTarget.st_gid);
+		}
+		// Keep permissions such as being executable. After chown as that may clear set-id bits.
+		chmod(AsInternal(), statusTarget.st_mode & 07777);
+	}
+	return rename(AsInternal(), target.AsInternal()) == 0;
+#endif
+}
+
+FilePath FilePath::Resolved() const {
+#if defined(_WIN32)
+	HANDLE hFile = ::CreateFileW(AsInternal(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return *this;
+	}
+	std::wstring finalPath(MAX_PATH, L'\0');
+	DWORD length = ::GetFinalPathNameByHandleW(hFile, finalPath.data(), static_cast<DWORD>(finalPath.size()), FILE_NAME_NORMALIZED);
+	if (length >= finalPath.size()) {
+		finalPath.resize(length);
+		length = ::GetFinalPathNameByHandleW(hFile, finalPath.data(), static_cast<DWORD>(finalPath.size()), FILE_NAME_NORMALIZED);
+	}
+	::CloseHandle(hFile);
+	if ((length == 0) || (length >= finalPath.size())) {
+		return *this;
+	}
+	finalPath.resize(length);
+	// Remove the prefix that allows long paths as other code does not expect it
+	constexpr std::wstring_view prefixUNC = L"\\\\?\\UNC\\";
+	constexpr std::wstring_view prefixLong = L"\\\\?\\";
+	if (StartsWith(finalPath, prefixUNC)) {
+		return FilePath(L"\\\\" + finalPath.substr(prefixUNC.length()));
+	} else if (StartsWith(finalPath, prefixLong)) {
+		return FilePath(finalPath.substr(prefixLong.length()));
+	}
+	return FilePath(finalPath);
+#else
+	char *resolved = realpath(AsInternal(), nullptr);
+	if (!resolved) {
+		return *this;
+	}
+	FilePath target(resolved);
+	free(resolved);
+	return target;
+#endif
+}
+
+namespace {
+
+// Leave room in a 32-bit address space for everything else.
+constexpr unsigned long long maximumMapping = std::numeric_limits<size_t>::max() / 4;
+
+}
+
+MappedFile::MappedFile(FILE *fp, size_t minimumLength) noexcept {
+	if (!fp) {
+		return;
+	}
+#if defined(_WIN32)
+	HANDLE hFile = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+	LARGE_INTEGER fileSize {};
+	if ((hFile == INVALID_HANDLE_VALUE) || (::GetFileType(hFile) != FILE_TYPE_DISK) ||
+		!::GetFileSizeEx(hFile, &fileSize)) {
+		return;
+	}
+	const unsigned long long size = fileSize.QuadPart;
+	if ((size == 0) || (size < minimumLength) || (size > maximumMapping)) {
+		return;
+	}
+	HANDLE hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!hMapping) {
+		return;
+	}
+	// The view keeps the mapping alive so its handle is not needed.
+	const void *view = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(hMapping);
+	if (view) {
+		data = static_cast<const char *>(view);
+		length = static_cast<size_t>(size);
+	}
+#else
+	struct stat statusFile;
+	if ((fstat(fileno(fp), &statusFile) == -1) || !S_ISREG(statusFile.st_mode)) {
+		return;
+	}
+	const unsigned long long size = statusFile.st_size;
+	if ((size == 0) || (size < minimumLength) || (size > maximumMapping)) {
+		return;
+	}
+	void *view = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+	if (view != MAP_FAILED) {
+		// Files are read from start to end so ask for aggressive read-ahead.
+		posix_madvise(view, static_cast<size_t>(size), POSIX_MADV_SEQUENTIAL);
+		data = static_cast<const char *>(view);
+		length = static_cast<size_t>(size);
+	}
+#endif
+}
+
+MappedFile::~MappedFile() {
+	if (data) {
+#if defined(_WIN32)
+		::UnmapViewOfFile(data);
+#else
+		munmap(const_cast<char *>(data), length);
+#endif
+	}
+}
+
+bool WriteReplacing(const FilePath &file, std::string_view data) {
+	return WriteReplacingWith(file, [data](FILE *fp) {
+		return fwrite(data.data(), 1, data.length(), fp) == data.length();
+	});
+}
+
+void AppendU32(std::string &data, uint32_t value) {
+	data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void AppendI64(std::string &data, long long value) {
+	const int64_t value64 = value;
+	data.append(reinterpret_cast<const char *>(&value64), sizeof(value64));
+}
+
+void AppendString(std::string &data, std::string_view value) {
+	AppendU32(data, static_cast<uint32_t>(value.length()));
+	data.append(value);
+}
+
+bool BinaryReader::Bytes(size_t length, std::string_view &value) noexcept {
+	if (data.length() < length) {
+		return false;
+	}
+	value = data.substr(0, length);
+	data.remove_prefix(length);
+	return true;
+}
+
+bool BinaryReader::U32(uint32_t &value) noexcept {
+	std::string_view bytes;
+	if (!Bytes(sizeof(value), bytes)) {
+		return false;
+	}
+	memcpy(&value, bytes.data(), sizeof(value));
+	return true;
+}
+
+bool BinaryReader::I64(long long &value) noexcept {
+	std::string_view bytes;
+	int64_t value64 = 0;
+	if (!Bytes(sizeof(value64), bytes)) {
+		return false;
+	}
+	memcpy(&value64, bytes.data(), sizeof(value64));
+	value = value64;
+	return true;
+}
+
+bool BinaryReader::String(std::string_view &value) noexcept {
+	uint32_t length = 0;
+	return U32(length) && Bytes(length, value);
+}
+
 #ifndef R_OK
 // Microsoft does not define the constants used to call access
 #define R_OK 4
@@ -532,6 +715,17 @@ long long FilePath::GetFileLength() const noexcept {
 #endif
 }
 
+// A single stat for callers that check many files for changes.
+bool FilePath::GetModifiedTimeAndLength(time_t &modified, long long &length) const noexcept {
+	FileStatus statusFile;
+	if (stat(AsInternal(), &statusFile) == -1) {
+		return false;
+	}
+	modified = statusFile.st_mtime;
+	length = statusFile.st_size;
+	return true;
+}
+
 bool FilePath::Exists() const noexcept {
 	if (IsSet()) {
 		FileHolder fp(Open(fileRead));
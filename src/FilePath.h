@@ -73,14 +73,105 @@ public:
 	FILE *Open(const GUI::gui_char *mode) const noexcept;
 	std::string Read() const;
 	void Remove() const noexcept;
+	/// Move this file over target in one step so target is never seen partly written.
+	bool Replace(const FilePath &target) const noexcept;
+	/// The file reached by following any symbolic links or this path when that fails.
+	FilePath Resolved() const;
 	time_t ModifiedTime() const noexcept;
 	long long GetFileLength() const noexcept;
+	bool GetModifiedTimeAndLength(time_t &modified, long long &length) const noexcept;
 	bool Exists() const noexcept;
 	bool IsDirectory() const noexcept;
 	bool Matches(GUI::gui_string_view pattern) const;
 	static bool CaseSensitive() noexcept;
 };
 
+/**
+ * Read-only view of the contents of an open file mapped into memory so it can be read
+ * without copying into a buffer.
+ * Pipes, devices and files smaller than minimumLength are not mapped and should be read
+ * with fread.
+ * On POSIX, reading pages beyond the end of a file truncated by another process while it is
+ * mapped raises SIGBUS which terminates the application. So mapping is only used where that
+ * risk is accepted for speed, as in Find in Files, and for files written by replacing them
+ * whole such as saved indexes. Documents are opened with fread so unsaved work is not lost.
+ */
+class MappedFile {
+	const char *data = nullptr;
+	size_t length = 0;
+public:
+	MappedFile(FILE *fp, size_t minimumLength) noexcept;
+	// Deleted so MappedFile objects can not be copied.
+	MappedFile(const MappedFile &) = delete;
+	MappedFile(MappedFile &&) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile &operator=(MappedFile &&) = delete;
+	~MappedFile();
+	bool Mapped() const noexcept {
+		return data != nullptr;
+	}
+	std::string_view Contents() const noexcept {
+		return std::string_view(data, length);
+	}
+};
+
+/// Files modified this recently may be modified again without their time changing as
+/// times may be recorded to the second or coarser, so caches should not rely on them.
+constexpr time_t secondsUnsettled = 2;
+
+constexpr bool Unsettled(long long modified, time_t now) noexcept {
+	return modified >= now - secondsUnsettled;
+}
+
+/**
+ * Write to a temporary file beside file then move it over file so file is never seen partly
+ * written, is left unchanged on failure, and is not changed under another reader mapping it.
+ * write is called with the open temporary file and returns whether it was written.
+ */
+template <typename WriteContents>
+bool WriteReplacingWith(const FilePath &file, WriteContents write) {
+	GUI::gui_string temporaryName = GUI_TEXT(".");
+	temporaryName += file.Name().AsInternal();
+	temporaryName += GUI_TEXT(".saving");
+	const FilePath temporary(file.Directory(), FilePath(temporaryName));
+	FileHolder fp(temporary.Open(fileWrite));
+	if (!fp) {
+		return false;
+	}
+	const bool written = write(fp.get());
+	if ((fclose(fp.release()) != 0) || !written || !temporary.Replace(file)) {
+		temporary.Remove();
+		return false;
+	}
+	return true;
+}
+
+bool WriteReplacing(const FilePath &file, std::string_view data);
+
+// Values in files such as indexes are in native byte order as the files are only read on the
+// machine that wrote them. Each file starts with a version so other byte orders are rejected.
+void AppendU32(std::string &data, uint32_t value);
+void AppendI64(std::string &data, long long value);
+/// Append the length of value then value.
+void AppendString(std::string &data, std::string_view value);
+
+/**
+ * Reads values written by the Append functions, failing on any truncation.
+ */
+class BinaryReader {
+	std::string_view data;
+public:
+	explicit BinaryReader(std::string_view data_) noexcept : data(data_) {
+	}
+	bool Bytes(size_t length, std::string_view &value) noexcept;
+	bool U32(uint32_t &value) noexcept;
+	bool I64(long long &value) noexcept;
+	bool String(std::string_view &value) noexcept;
+	bool AtEnd() const noexcept {
+		return data.empty();
+	}
+};
+
 std::string CommandExecute(const GUI::gui_char *command, const GUI::gui_char *directoryForRun);
 
 #endif
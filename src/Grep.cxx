@@ -0,0 +1,766 @@
+// SciTE - Scintilla based Text Editor
+/** @file Grep.cxx
+ ** Search for text in a tree of files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <bitset>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "GUI.h"
+
+#include "StringHelpers.h"
+#include "FilePath.h"
+#include "Cookie.h"
+#include "Utf8_16.h"
+#include "SubstringSearch.h"
+#include "RegexSearch.h"
+#include "TrigramIndex.h"
+#include "IgnoreRules.h"
+#include "ThreadPool.h"
+#include "Grep.h"
+
+namespace {
+
+/**
+ * Reads a file in blocks that each hold only complete lines so searching can
+ * work directly on the bytes read without splitting them into lines first.
+ * Large regular files are mapped into memory and blocks are views of the mapping.
+ * Mapping is limited to searching as a file truncated while mapped can end the process.
+ */
+class BlockReader {
+	FileHolder fp;
+	MappedFile mapped;
+	size_t mappedPosition = 0;
+	std::vector<char> buffer;
+	size_t valid = 0;
+	size_t blockEnd = 0;
+	bool atEnd = false;
+	bool endsWithCR = false;
+	bool leadContainsNull = false;
+	void Fill() {
+		const size_t lengthRead = fread(buffer.data() + valid, 1, buffer.size() - valid, fp.get());
+		if (lengthRead < buffer.size() - valid) {
+			atEnd = true;
+		}
+		valid += lengthRead;
+	}
+	std::string_view NextMappedBlock() noexcept;
+	std::string_view NextBufferedBlock();
+public:
+	static constexpr size_t blockSize = 64 * 1024;
+	// Mapped blocks need no copying so are larger, limited to allow prompt cancellation.
+	static constexpr size_t mappedBlockSize = 1024 * 1024;
+	explicit BlockReader(const FilePath &fPath) : fp(fPath.Open(fileRead)), mapped(fp.get(), blockSize) {
+		if (mapped.Mapped()) {
+			const std::string_view lead = mapped.Contents().substr(0, blockSize);
+			leadContainsNull = lead.find('\0') != std::string_view::npos;
+		} else if (fp) {
+			buffer.resize(blockSize);
+			Fill();
+			leadContainsNull = memchr(buffer.data(), 0, valid) != nullptr;
+		} else {
+			atEnd = true;
+		}
+	}
+	/// For Find in Files, a binary file is a file that contains a NUL byte in the first 64K block.
+	bool LeadContainsNull() const noexcept {
+		return leadContainsNull;
+	}
+	bool Exhausted() const noexcept {
+		if (mapped.Mapped()) {
+			return mappedPosition == mapped.Contents().length();
+		}
+		return atEnd && (blockEnd == valid);
+	}
+	/// Return the next block of complete lines.
+	std::string_view NextBlock() {
+		std::string_view block = mapped.Mapped() ? NextMappedBlock() : NextBufferedBlock();
+		if (endsWithCR && !block.empty() && (block.front() == '\n')) {
+			// Second half of "\r\n" split over blocks
+			block.remove_prefix(1);
+			endsWithCR = false;
+		}
+		if (!block.empty()) {
+			endsWithCR = block.back() == '\r';
+		}
+		return block;
+	}
+};
+
+std::string_view BlockReader::NextMappedBlock() noexcept {
+	const std::string_view contents = mapped.Contents();
+	const size_t start = mappedPosition;
+	size_t end = std::min(start + mappedBlockSize, contents.length());
+	if (end < contents.length()) {
+		// End after the last line end in the block or, for a very long line, after the next line end.
+		const size_t lineEnd = contents.find_last_of("\r\n", end - 1);
+		if ((lineEnd != std::string_view::npos) && (lineEnd >= start)) {
+			end = lineEnd + 1;
+		} else {
+			const size_t lineEndNext = contents.find_first_of("\r\n", end);
+			end = (lineEndNext == std::string_view::npos) ? contents.length() : lineEndNext + 1;
+		}
+	}
+	mappedPosition = end;
+	return contents.substr(start, end - start);
+}
+
+std::string_view BlockReader::NextBufferedBlock() {
+	// Retain any partial line from the previous block
+	std::copy(buffer.begin() + blockEnd, buffer.begin() + valid, buffer.begin());
+	valid -= blockEnd;
+	blockEnd = 0;
+	for (;;) {
+		if (!atEnd && (valid < buffer.size())) {
+			Fill();
+		}
+		if (atEnd) {
+			blockEnd = valid;
+			break;
+		}
+		const auto itLineEnd = std::find_if(buffer.rbegin(), buffer.rend(), [](char ch) noexcept {
+			return ch == '\r' || ch == '\n';
+		});
+		if (itLineEnd != buffer.rend()) {
+			blockEnd = buffer.rend() - itLineEnd;
+			break;
+		}
+		// Line longer than buffer so grow
+		buffer.resize(buffer.size() * 2);
+	}
+	return std::string_view(buffer.data(), blockEnd);
+}
+
+constexpr bool IsWordCharacter(int ch) noexcept {
+	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')  || (ch >= '0' && ch <= '9')  || (ch == '_');
+}
+
+// How often waiting threads check whether the search has been cancelled.
+constexpr std::chrono::milliseconds cancelCheckInterval(100);
+// Results are output once this much has accumulated or this much time has passed.
+constexpr size_t batchLimit = 64 * 1024;
+constexpr std::chrono::milliseconds flushInterval(100);
+// Searching threads wait while more results than this are held before output.
+constexpr size_t pendingLimit = 16 * 1024 * 1024;
+
+bool GrepIntoDirectory(const FilePath &directory) {
+	const GUI::gui_char *sDirectory = directory.AsInternal();
+	return sDirectory[0] != '.';
+}
+
+bool WriteReplaced(const FilePath &pathFound, std::string_view text, UniMode unicodeMode) {
+	// Write the file a symbolic link points to so the link remains
+	return WriteReplacingWith(pathFound.Resolved(), [text, unicodeMode](FILE *fp) {
+		std::unique_ptr<Utf8_16::Writer> convert = Utf8_16::Writer::Allocate(unicodeMode, text.length());
+		return text.empty() || (convert->fwrite(text, fp) != 0);
+	});
+}
+
+// The tree is built by listing tasks and searched by file tasks while the calling
+// thread walks it in order, writing out results as they arrive.
+// Each task claims its node so, when the calling thread reaches a node that has not
+// been claimed, it can do the work itself instead of waiting for a busy pool.
+// Nodes are shared with their tasks so a task that finds its node claimed does not
+// touch released memory.
+
+struct FileSlot {
+	FilePath path;
+	// Results not yet taken by the calling thread.
+	std::string result;
+	// Path relative to the root, the file's new index entry, and whether the old entry was current.
+	std::string indexKey;
+	std::unique_ptr<TrigramIndex::Entry> indexEntry;
+	bool indexSeen = false;
+	bool done = false;
+	std::atomic_bool claimed = false;
+	explicit FileSlot(const FilePath &path_) : path(path_) {
+	}
+};
+
+struct DirectoryNode {
+	FilePath path;
+	// Path relative to the top of the tree in UTF-8, empty or ending with '/'.
+	std::string relative;
+	int depth = 0;
+	std::shared_ptr<const IgnoreStack> ignores;
+	std::vector<std::shared_ptr<FileSlot>> files;
+	std::vector<std::shared_ptr<DirectoryNode>> directories;
+	bool listed = false;
+	std::atomic_bool claimed = false;
+	explicit DirectoryNode(const FilePath &path_) : path(path_) {
+	}
+};
+
+class TreeSearch {
+	const GrepOptions options;
+	const GUI::gui_string fileTypes;
+	const GUI::gui_string excludedTypes;
+	SubstringSearch searcher;
+	std::unique_ptr<RegexProgram> regex;
+	// One for each pool thread as each holds a cache that is built while searching.
+	std::vector<std::unique_ptr<RegexSearch>> regexSearches;
+	bool searchable;
+	std::unique_ptr<TrigramIndex> index;
+	std::vector<Trigram> query;
+	size_t rootLength = 0;
+	time_t startTime = 0;
+	GrepOutput &output;
+	std::string batch;
+	std::chrono::steady_clock::time_point lastFlush;
+	std::atomic<size_t> filesReplaced = 0;
+	std::atomic<size_t> replacements = 0;
+
+	// Protects the done, listed, and result fields of the tree along with pendingBytes and head.
+	std::mutex mutexTree;
+	std::condition_variable cvTree;
+	// Searching threads wait while too many results are held so memory use is bounded.
+	std::condition_variable cvRoom;
+	size_t pendingBytes = 0;
+	// The file the calling thread is waiting for, which is never made to wait for room.
+	const FileSlot *head = nullptr;
+
+	DirectoryNode root;
+	// Declared after root so threads are joined before the tree is destroyed.
+	ThreadPool pool;
+
+	void Complete(bool &flag) {
+		{
+			std::lock_guard<std::mutex> guard(mutexTree);
+			flag = true;
+		}
+		cvTree.notify_one();
+	}
+	bool WaitFor(const bool &flag);
+	void ReadIgnoreFiles(DirectoryNode *node, const FilePathSet &files);
+	bool Ignored(const DirectoryNode *node, const FilePath &fPath, bool isDirectory) const;
+	void ListDirectory(DirectoryNode *node);
+	bool ConsultIndex(FileSlot *slot, std::unique_ptr<TrigramCollector> &collector);
+	void Publish(FileSlot *slot, std::string &found);
+	bool WholeWordAt(std::string_view text, size_t position) const noexcept;
+	std::string ReplaceInText(std::string_view text, const std::string &pathUTF8, std::string &found);
+	void ReplaceFile(FileSlot *slot);
+	void SearchFile(FileSlot *slot);
+	void Flush();
+	bool EmitFile(FileSlot &slot);
+	bool Emit(DirectoryNode &node);
+public:
+	TreeSearch(const GrepOptions &options_, const FilePath &directory,
+		GUI::gui_string_view fileTypes_, GUI::gui_string_view excludedTypes_,
+		std::string_view search, GrepOutput &output_);
+	void Search();
+};
+
+TreeSearch::TreeSearch(const GrepOptions &options_, const FilePath &directory,
+	GUI::gui_string_view fileTypes_, GUI::gui_string_view excludedTypes_,
+	std::string_view search, GrepOutput &output_) :
+	options(options_),
+	fileTypes(fileTypes_),
+	excludedTypes(excludedTypes_),
+	searcher(search, options.matchCase),
+	searchable(options.regularExpression || (search.find_first_of("\r\n") == std::string_view::npos)),
+	output(output_),
+	root(directory) {
+	if (options.regularExpression) {
+		regex = std::make_unique<RegexProgram>(search, options.matchCase, options.wholeWord, options.posix);
+		// Extra search for the calling thread
+		regexSearches.resize(pool.Size() + 1);
+	}
+	if (options.indexFile.IsSet()) {
+		index = std::make_unique<TrigramIndex>(options.indexFile);
+		// Only fixed text can be looked up in the index
+		query = TrigramsOf(regex ? std::string_view(regex->literal) : search);
+		rootLength = root.path.AsUTF8().length();
+		startTime = time(nullptr);
+	}
+}
+
+bool TreeSearch::WaitFor(const bool &flag) {
+	std::unique_lock<std::mutex> lock(mutexTree);
+	if (flag) {
+		return true;
+	}
+	// About to block so deliver what has been found so far.
+	lock.unlock();
+	Flush();
+	lock.lock();
+	while (!flag) {
+		if (output.Cancelled()) {
+			return false;
+		}
+		cvTree.wait_for(lock, cancelCheckInterval);
+	}
+	return true;
+}
+
+// Add the rules of any ignore files in the directory to those inherited from above.
+void TreeSearch::ReadIgnoreFiles(DirectoryNode *node, const FilePathSet &files) {
+	IgnoreRules rules;
+	for (const std::string_view ignoreFileName : IgnoreStack::ignoreFileNames) {
+		for (const FilePath &fPath : files) {
+			if (fPath.Name().AsUTF8() == ignoreFileName) {
+				rules.Add(fPath.Read());
+			}
+		}
+	}
+	if (!rules.Empty()) {
+		node->ignores = std::make_shared<const IgnoreStack>(std::move(rules), node->relative, node->ignores);
+	}
+}
+
+bool TreeSearch::Ignored(const DirectoryNode *node, const FilePath &fPath, bool isDirectory) const {
+	return node->ignores && node->ignores->Ignored(node->relative + fPath.Name().AsUTF8(), isDirectory);
+}
+
+void TreeSearch::ListDirectory(DirectoryNode *node) {
+	if (!output.Cancelled()) {
+		FilePathSet directories;
+		FilePathSet files;
+		node->path.List(directories, files);
+		if (options.ignoreFiles) {
+			ReadIgnoreFiles(node, files);
+		}
+		for (const FilePath &fPath : files) {
+			if ((fileTypes.empty() || fPath.Matches(fileTypes)) &&
+				((excludedTypes.empty() || !fPath.Matches(excludedTypes))) &&
+				!Ignored(node, fPath, false) &&
+				((options.maxFileSize <= 0) || (fPath.GetFileLength() <= options.maxFileSize))) {
+				node->files.push_back(std::make_shared<FileSlot>(fPath));
+			}
+		}
+		const bool descend = (options.maxDepth < 0) || (node->depth < options.maxDepth);
+		for (const FilePath &fPath : directories) {
+			if (descend && (options.dot || GrepIntoDirectory(fPath.Name()))) {
+				if ((excludedTypes.empty() || !fPath.Matches(excludedTypes)) &&
+					!Ignored(node, fPath, true)) {
+					auto child = std::make_shared<DirectoryNode>(fPath);
+					child->depth = node->depth + 1;
+					if (options.ignoreFiles) {
+						child->relative = node->relative + fPath.Name().AsUTF8() + "/";
+						child->ignores = node->ignores;
+					}
+					node->directories.push_back(std::move(child));
+				}
+			}
+		}
+		// Submitted in reverse as each thread takes its most recent task first
+		// and the walk wants earlier files completed earlier.
+		for (auto it = node->directories.rbegin(); it != node->directories.rend(); ++it) {
+			pool.Submit([this, child = *it]() {
+				if (!child->claimed.exchange(true)) {
+					ListDirectory(child.get());
+				}
+			});
+		}
+		for (auto it = node->files.rbegin(); it != node->files.rend(); ++it) {
+			pool.Submit([this, slot = *it]() {
+				if (!slot->claimed.exchange(true)) {
+					SearchFile(slot.get());
+				}
+			});
+		}
+	}
+	// Once listed is set, node may be released so must not be touched.
+	Complete(node->listed);
+}
+
+constexpr bool IsLineEnd(char ch) noexcept {
+	return ch == '\r' || ch == '\n';
+}
+
+// Return false when the index shows the file can not match. When the file's entry is
+// missing or incomplete, start collecting its trigrams so the entry can be updated.
+bool TreeSearch::ConsultIndex(FileSlot *slot, std::unique_ptr<TrigramCollector> &collector) {
+	time_t modified = 0;
+	long long length = 0;
+	if (!slot->path.GetModifiedTimeAndLength(modified, length)) {
+		return true;
+	}
+	slot->indexKey = slot->path.AsUTF8().substr(rootLength);
+	const TrigramIndex::Entry *entry = index->Find(slot->indexKey, modified, length);
+	if (entry) {
+		slot->indexSeen = true;
+		if ((entry->flags & TrigramIndex::flagBinary) && !options.binary) {
+			return false;
+		}
+		if (!TrigramIndex::MayContain(*entry, query)) {
+			return false;
+		}
+		if (!entry->filter.empty() || (entry->flags & TrigramIndex::flagLarge)) {
+			return true;
+		}
+	}
+	if (!Unsettled(modified, startTime)) {
+		slot->indexEntry = std::make_unique<TrigramIndex::Entry>();
+		slot->indexEntry->modified = modified;
+		slot->indexEntry->length = length;
+		collector = std::make_unique<TrigramCollector>();
+	}
+	return true;
+}
+
+bool TreeSearch::WholeWordAt(std::string_view text, size_t position) const noexcept {
+	const size_t after = position + searcher.Length();
+	return !(((position > 0) && IsWordCharacter(text[position - 1])) ||
+		((after < text.length()) && IsWordCharacter(text[after])));
+}
+
+// Return text with every match replaced and, for each line changed, append to found
+// the line before and after replacement prefixed with '-' and '+'.
+std::string TreeSearch::ReplaceInText(std::string_view text, const std::string &pathUTF8, std::string &found) {
+	std::string result;
+	// Text before copied has been added to result.
+	size_t copied = 0;
+	// All positions before counted have had their line ends added to lineEnds.
+	size_t counted = 0;
+	size_t lineEnds = 0;
+	size_t match = searcher.Find(text);
+	while ((match != std::string_view::npos) && !output.Cancelled()) {
+		size_t lineStart = match;
+		while ((lineStart > copied) && !IsLineEnd(text[lineStart - 1])) {
+			lineStart--;
+		}
+		size_t lineEnd = match + searcher.Length();
+		while ((lineEnd < text.length()) && !IsLineEnd(text[lineEnd])) {
+			lineEnd++;
+		}
+		// Replace each match in the line, stopping at the first match after the line.
+		std::string line;
+		size_t position = lineStart;
+		size_t replaced = 0;
+		while ((match != std::string_view::npos) && (match < lineEnd)) {
+			if (!options.wholeWord || WholeWordAt(text, match)) {
+				line.append(text.substr(position, match - position));
+				line.append(options.replacement);
+				position = match + searcher.Length();
+				replaced++;
+				match = searcher.Find(text, position);
+			} else {
+				match = searcher.Find(text, match + 1);
+			}
+		}
+		if (replaced) {
+			line.append(text.substr(position, lineEnd - position));
+			lineEnds += CountLineEnds(text.substr(counted, lineStart - counted));
+			counted = lineStart;
+			const std::string location = pathUTF8 + ":" + StdStringFromSizeT(lineEnds + 1) + ":";
+			found.append(location);
+			found.append("-");
+			found.append(text.substr(lineStart, lineEnd - lineStart));
+			found.append("\n");
+			found.append(location);
+			found.append("+");
+			found.append(line);
+			found.append("\n");
+			result.append(text.substr(copied, lineStart - copied));
+			result.append(line);
+			copied = lineEnd;
+			replacements += replaced;
+		}
+	}
+	result.append(text.substr(copied));
+	return result;
+}
+
+// Files are read completely and decoded so matches are also found in UTF-16 files, which
+// are then written back in their original encoding.
+void TreeSearch::ReplaceFile(FileSlot *slot) {
+	std::string found;
+	try {
+		std::unique_ptr<TrigramCollector> collector;
+		if (searchable && !output.Cancelled() && (!index || ConsultIndex(slot, collector))) {
+			// The file is rewritten so its old index entry would not match
+			slot->indexEntry.reset();
+			const std::string contents = slot->path.Read();
+			std::unique_ptr<Utf8_16::Reader> convert = Utf8_16::Reader::Allocate();
+			std::string text(convert->convert(contents));
+			// Handle case where convert is holding a lead surrogate but no more data
+			text.append(convert->convert(""));
+			if (options.binary || (text.find('\0') == std::string::npos)) {
+				const std::string pathUTF8 = slot->path.AsUTF8();
+				const std::string replaced = ReplaceInText(text, pathUTF8, found);
+				if (!found.empty()) {
+					if (output.Cancelled()) {
+						found.clear();
+					} else if (WriteReplaced(slot->path, replaced, convert->getEncoding())) {
+						filesReplaced++;
+					} else {
+						found = "Could not write " + pathUTF8 + "\n";
+					}
+				}
+			}
+		}
+	} catch (const std::exception &) {
+		// Allocation failure: leave the file unchanged.
+		found.clear();
+	}
+	if (!found.empty()) {
+		Publish(slot, found);
+	}
+	Complete(slot->done);
+}
+
+void TreeSearch::SearchFile(FileSlot *slot) {
+	if (options.replace) {
+		ReplaceFile(slot);
+		return;
+	}
+	try {
+		std::unique_ptr<TrigramCollector> collector;
+		if (searchable && !output.Cancelled() && (!index || ConsultIndex(slot, collector))) {
+			BlockReader reader(slot->path);
+			if (reader.LeadContainsNull() && slot->indexEntry) {
+				slot->indexEntry->flags |= TrigramIndex::flagBinary;
+			}
+			if (options.binary || !reader.LeadContainsNull()) {
+				RegexSearch *regexSearch = nullptr;
+				if (regex) {
+					std::unique_ptr<RegexSearch> &threadSearch = regexSearches[pool.CurrentThread()];
+					if (!threadSearch) {
+						threadSearch = std::make_unique<RegexSearch>(*regex);
+					}
+					regexSearch = threadSearch.get();
+				}
+				std::string pathUTF8;
+				std::string found;
+				size_t lineEnds = 0;
+				while (!reader.Exhausted() && !output.Cancelled()) {
+					const std::string_view block = reader.NextBlock();
+					if (collector) {
+						collector->Add(block);
+					}
+					// All positions before counted have had their line ends added to lineEnds.
+					size_t counted = 0;
+					size_t position = 0;
+					while (position < block.length()) {
+						// A regular expression search returns a position somewhere in the matching line
+						const size_t match = regexSearch ? regexSearch->Find(block, position) : searcher.Find(block, position);
+						if (match == std::string_view::npos) {
+							break;
+						}
+						size_t lineStart = match;
+						while ((lineStart > counted) && !IsLineEnd(block[lineStart - 1])) {
+							lineStart--;
+						}
+						const size_t afterMatch = regexSearch ? match : match + searcher.Length();
+						size_t lineEnd = afterMatch;
+						while ((lineEnd < block.length()) && !IsLineEnd(block[lineEnd])) {
+							lineEnd++;
+						}
+						if (!regexSearch && options.wholeWord &&
+							(((match > lineStart) && IsWordCharacter(block[match - 1])) ||
+							((afterMatch < lineEnd) && IsWordCharacter(block[afterMatch])))) {
+							position = match + 1;
+							continue;
+						}
+						lineEnds += CountLineEnds(block.substr(counted, lineStart - counted));
+						counted = lineStart;
+						if (pathUTF8.empty()) {
+							pathUTF8 = slot->path.AsUTF8();
+						}
+						found.append(pathUTF8);
+						found.append(":");
+						found.append(StdStringFromSizeT(lineEnds + 1));
+						found.append(":");
+						found.append(block.substr(lineStart, lineEnd - lineStart));
+						found.append("\n");
+						// Continue at start of next line
+						position = lineEnd;
+						if (position < block.length()) {
+							position++;
+							if ((block[position - 1] == '\r') && (position < block.length()) && (block[position] == '\n')) {
+								position++;
+							}
+						}
+					}
+					lineEnds += CountLineEnds(block.substr(counted));
+					if (!found.empty()) {
+						Publish(slot, found);
+					}
+				}
+				if (collector) {
+					if (!reader.Exhausted()) {
+						// Cancelled so contents incomplete
+						slot->indexEntry.reset();
+					} else if (collector->Overflowed()) {
+						slot->indexEntry->flags |= TrigramIndex::flagLarge;
+					} else {
+						slot->indexEntry->filter = TrigramIndex::FilterOf(collector->Finish());
+					}
+				}
+			}
+		}
+	} catch (const std::exception &) {
+		// Allocation failure: report what was found before the failure.
+	}
+	Complete(slot->done);
+}
+
+// Hand over the results found so far in a file. Then wait while too many results are held
+// unless this is the file being output as the calling thread can not progress without it.
+void TreeSearch::Publish(FileSlot *slot, std::string &found) {
+	if (pool.CurrentThread() == pool.Size()) {
+		// Searching on the calling thread so this is the file being output
+		batch.append(found);
+		found.clear();
+		if (batch.length() > batchLimit) {
+			Flush();
+		}
+		return;
+	}
+	std::unique_lock<std::mutex> lock(mutexTree);
+	slot->result.append(found);
+	pendingBytes += found.length();
+	found.clear();
+	if (slot == head) {
+		cvTree.notify_one();
+	}
+	while ((pendingBytes > pendingLimit) && (slot != head) && !output.Cancelled()) {
+		cvRoom.wait_for(lock, cancelCheckInterval);
+	}
+}
+
+void TreeSearch::Flush() {
+	if (!batch.empty()) {
+		output.Output(batch);
+		batch.clear();
+	}
+	lastFlush = std::chrono::steady_clock::now();
+}
+
+// Output the results of a file, taking them as they are found so a file with many
+// matches appears progressively and does not hold back the threads searching later files.
+bool TreeSearch::EmitFile(FileSlot &slot) {
+	const bool claimed = !slot.claimed.exchange(true);
+	std::unique_lock<std::mutex> lock(mutexTree);
+	head = &slot;
+	// The thread searching this file may be waiting for room
+	cvRoom.notify_all();
+	if (claimed) {
+		lock.unlock();
+		Flush();
+		SearchFile(&slot);
+		lock.lock();
+	}
+	for (;;) {
+		if (!slot.result.empty()) {
+			batch.append(slot.result);
+			pendingBytes -= slot.result.length();
+			slot.result.clear();
+			cvRoom.notify_all();
+		}
+		if (slot.done) {
+			break;
+		}
+		// About to block so deliver what has been found so far.
+		lock.unlock();
+		Flush();
+		lock.lock();
+		if (slot.done || !slot.result.empty()) {
+			continue;
+		}
+		if (output.Cancelled()) {
+			head = nullptr;
+			return false;
+		}
+		cvTree.wait_for(lock, cancelCheckInterval);
+	}
+	head = nullptr;
+	return true;
+}
+
+bool TreeSearch::Emit(DirectoryNode &node) {
+	if (!node.claimed.exchange(true)) {
+		// Pool has not reached this directory so list it here.
+		Flush();
+		ListDirectory(&node);
+	}
+	if (!WaitFor(node.listed)) {
+		return false;
+	}
+	for (std::shared_ptr<FileSlot> &slot : node.files) {
+		if (!EmitFile(*slot)) {
+			return false;
+		}
+		if (index) {
+			if (slot->indexEntry) {
+				index->Update(slot->indexKey, std::move(*slot->indexEntry));
+			} else if (slot->indexSeen) {
+				index->Touch(slot->indexKey);
+			}
+		}
+		slot.reset();
+		if ((batch.length() > batchLimit) ||
+			(std::chrono::steady_clock::now() - lastFlush > flushInterval)) {
+			Flush();
+		}
+	}
+	for (std::shared_ptr<DirectoryNode> &child : node.directories) {
+		if (!Emit(*child)) {
+			return false;
+		}
+		child.reset();
+	}
+	return true;
+}
+
+void TreeSearch::Search() {
+	if (regex && !regex->IsValid()) {
+		output.Output("Invalid regular expression: " + regex->error + "\n");
+		return;
+	}
+	if (regex && options.replace) {
+		output.Output("Regular expressions can not be replaced in files.\n");
+		return;
+	}
+	if (searcher.Length() == 0) {
+		// Would match at every position
+		output.Output("Search string must not be empty.\n");
+		return;
+	}
+	lastFlush = std::chrono::steady_clock::now();
+	pool.Submit([this]() {
+		if (!root.claimed.exchange(true)) {
+			ListDirectory(&root);
+		}
+	});
+	const bool completed = Emit(root);
+	if (options.replace) {
+		batch.append("Replaced " + StdStringFromSizeT(replacements) + " in " +
+			StdStringFromSizeT(filesReplaced) + " files.\n");
+	}
+	Flush();
+	if (completed && index) {
+		index->Save();
+	}
+}
+
+}
+
+void Grep(const GrepOptions &options, const FilePath &directory,
+	  GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
+	  std::string_view search, GrepOutput &output) {
+	TreeSearch treeSearch(options, directory, fileTypes, excludedTypes, search, output);
+	treeSearch.Search();
+}
@@ -0,0 +1,57 @@
+// SciTE - Scintilla based Text Editor
+/** @file Grep.h
+ ** Search for text in a tree of files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef GREP_H
+#define GREP_H
+
+struct GrepOptions {
+	bool wholeWord = false;
+	bool matchCase = false;
+	bool dot = false;
+	bool binary = false;
+	bool regularExpression = false;
+	bool posix = false;
+	/// Skip what is matched by .gitignore and .ignore files found in the tree.
+	bool ignoreFiles = false;
+	/// Skip files longer than this when greater than 0.
+	long long maxFileSize = 0;
+	/// Only descend this many levels of directories below the top when not negative.
+	int maxDepth = -1;
+	/// When set, a TrigramIndex stored in this file is used to skip files that can not match.
+	FilePath indexFile;
+	/// Replace each match with replacement, rewriting the files that change.
+	bool replace = false;
+	std::string replacement;
+};
+
+/**
+ * Receives the results of a search.
+ * Output is called, in the order of a depth-first walk of the tree, only on the thread
+ * that called Grep. Results arrive in batches as they are found, including partial
+ * results of a file with many matches. Cancelled may be called from any of the searching threads.
+ */
+class GrepOutput {
+public:
+	virtual ~GrepOutput() = default;
+	virtual void Output(std::string_view text) = 0;
+	virtual bool Cancelled() noexcept = 0;
+};
+
+/**
+ * Search the files below directory that match fileTypes and not excludedTypes,
+ * producing lines of the form "path:line:text".
+ * With regularExpression, search is a pattern for RegexProgram.
+ * With replace, each changed line produces "path:line:-text" for its old contents and
+ * "path:line:+text" for its new contents, followed by a count at the end. Only fixed
+ * text can be replaced.
+ * Directories are listed and files searched on a pool of threads.
+ */
+void Grep(const GrepOptions &options, const FilePath &directory,
+	  GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
+	  std::string_view search, GrepOutput &output);
+
+#endif
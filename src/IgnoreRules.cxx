@@ -0,0 +1,142 @@
+// SciTE - Scintilla based Text Editor
+/** @file IgnoreRules.cxx
+ ** Decide which files and directories are excluded by .gitignore and .ignore files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+
+#include "GUI.h"
+
+#include "StringHelpers.h"
+#include "FilePath.h"
+#include "PathMatch.h"
+#include "IgnoreRules.h"
+
+namespace {
+
+constexpr std::string_view anyDepthPrefix = "**/";
+constexpr std::u32string_view middleAnyDepth = U"/**/";
+
+std::u32string FoldedUTF32(std::string_view text) {
+	if (!FilePath::CaseSensitive()) {
+		return UTF32FromUTF8(GUI::LowerCaseUTF8(text));
+	}
+	return UTF32FromUTF8(text);
+}
+
+// PatternMatch requires a directory between the slashes of "/**/" so add each form of
+// pattern with some of those replaced by a single "/".
+std::vector<std::u32string> PatternForms(std::u32string pattern) {
+	std::vector<std::u32string> forms { std::move(pattern) };
+	for (size_t form = 0; form < forms.size(); form++) {
+		for (size_t position = forms[form].find(middleAnyDepth); position != std::u32string::npos;
+			position = forms[form].find(middleAnyDepth, position + 1)) {
+			std::u32string shorter = forms[form];
+			shorter.erase(position, middleAnyDepth.length() - 1);
+			if (std::find(forms.begin(), forms.end(), shorter) == forms.end()) {
+				forms.push_back(std::move(shorter));
+			}
+		}
+	}
+	return forms;
+}
+
+}
+
+void IgnoreRules::Add(std::string_view text) {
+	while (!text.empty()) {
+		const size_t endLine = text.find('\n');
+		std::string_view line = text.substr(0, endLine);
+		text.remove_prefix((endLine == std::string_view::npos) ? text.length() : endLine + 1);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		// Trailing spaces are removed unless escaped
+		while (!line.empty() && IsASpace(line.back()) &&
+			!((line.length() >= 2) && (line[line.length() - 2] == '\\'))) {
+			line.remove_suffix(1);
+		}
+		if (line.empty() || line.front() == '#') {
+			continue;
+		}
+		Rule rule;
+		if (line.front() == '!') {
+			rule.negated = true;
+			line.remove_prefix(1);
+		}
+		if (!line.empty() && line.back() == '/') {
+			rule.directoryOnly = true;
+			line.remove_suffix(1);
+		}
+		if (StartsWith(line, anyDepthPrefix)) {
+			const std::string_view rest = line.substr(anyDepthPrefix.length());
+			if (rest.find('/') == std::string_view::npos) {
+				// "**/name" is the same as "name"
+				line = rest;
+			} else {
+				rule.anyDepth = true;
+			}
+		}
+		if (!line.empty() && line.front() == '/') {
+			rule.anchored = true;
+			line.remove_prefix(1);
+		} else if (line.find('/') != std::string_view::npos) {
+			rule.anchored = true;
+		}
+		if (line.empty()) {
+			continue;
+		}
+		rule.patterns = PatternForms(FoldedUTF32(line));
+		rules.push_back(std::move(rule));
+	}
+}
+
+IgnoreRules::Decision IgnoreRules::Check(std::string_view relativePath, bool isDirectory) const {
+	if (rules.empty()) {
+		return Decision::none;
+	}
+	const std::u32string path = FoldedUTF32(relativePath);
+	const size_t lastSlash = path.rfind('/');
+	const std::u32string_view name = (lastSlash == std::u32string::npos) ?
+		std::u32string_view(path) : std::u32string_view(path).substr(lastSlash + 1);
+	for (auto it = rules.rbegin(); it != rules.rend(); ++it) {
+		if (it->directoryOnly && !isDirectory) {
+			continue;
+		}
+		for (const std::u32string &pattern : it->patterns) {
+			bool matched = PatternMatch(pattern, it->anchored ? std::u32string_view(path) : name);
+			if (!matched && it->anyDepth) {
+				matched = PatternMatch(std::u32string_view(pattern).substr(anyDepthPrefix.length()), path);
+			}
+			if (matched) {
+				return it->negated ? Decision::include : Decision::ignore;
+			}
+		}
+	}
+	return Decision::none;
+}
+
+IgnoreStack::IgnoreStack(IgnoreRules &&rules_, std::string_view prefix_, std::shared_ptr<const IgnoreStack> outer_) :
+	rules(std::move(rules_)), prefix(prefix_), outer(std::move(outer_)) {
+}
+
+bool IgnoreStack::Ignored(std::string_view relativePath, bool isDirectory) const {
+	// Rules closer to the path take precedence
+	for (const IgnoreStack *stack = this; stack; stack = stack->outer.get()) {
+		const IgnoreRules::Decision decision = stack->rules.Check(relativePath.substr(stack->prefix.length()), isDirectory);
+		if (decision != IgnoreRules::Decision::none) {
+			return decision == IgnoreRules::Decision::ignore;
+		}
+	}
+	return false;
+}
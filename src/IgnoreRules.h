@@ -0,0 +1,56 @@
+// SciTE - Scintilla based Text Editor
+/** @file IgnoreRules.h
+ ** Decide which files and directories are excluded by .gitignore and .ignore files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef IGNORERULES_H
+#define IGNORERULES_H
+
+/**
+ * The patterns of the ignore files in one directory, matched with PatternMatch.
+ * Follows .gitignore: blank lines and lines starting with '#' are skipped, '!' re-includes,
+ * a trailing '/' only matches directories and a pattern containing another '/' is
+ * anchored to the directory instead of matching names at any depth. A "**" between
+ * slashes matches any number of directories including none.
+ * Later patterns override earlier ones.
+ */
+class IgnoreRules {
+	struct Rule {
+		// The pattern and, when it contains "/**/", forms with those matching no directories
+		std::vector<std::u32string> patterns;
+		bool negated = false;
+		bool directoryOnly = false;
+		bool anchored = false;
+		// Started with "**/" so may also match at the top of the directory
+		bool anyDepth = false;
+	};
+	std::vector<Rule> rules;
+public:
+	enum class Decision { none, ignore, include };
+	void Add(std::string_view text);
+	bool Empty() const noexcept {
+		return rules.empty();
+	}
+	/// relativePath is in UTF-8 with '/' separators relative to the directory of the rules.
+	Decision Check(std::string_view relativePath, bool isDirectory) const;
+};
+
+/**
+ * The rules for one directory of a tree linked to the rules of the directories above it.
+ * Shared between the directories below so their rules need not be copied.
+ */
+class IgnoreStack {
+	IgnoreRules rules;
+	// Location of the rules relative to the top of the tree, empty or ending with '/'.
+	std::string prefix;
+	std::shared_ptr<const IgnoreStack> outer;
+public:
+	static constexpr std::string_view ignoreFileNames[] = { ".gitignore", ".ignore" };
+	IgnoreStack(IgnoreRules &&rules_, std::string_view prefix_, std::shared_ptr<const IgnoreStack> outer_);
+	/// relativePath is relative to the top of the tree.
+	bool Ignored(std::string_view relativePath, bool isDirectory) const;
+};
+
+#endif
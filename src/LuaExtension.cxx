@@ -353,6 +353,38 @@ int cf_scite_strip_value(lua_State *L) {
 	return 1;
 }
 
+int cf_scite_find_match_lines(lua_State *L) {
+	const std::vector<SA::Line> lines = host->FindMatchLines();
+	lua_createtable(L, static_cast<int>(lines.size()), 0);
+	int index = 1;
+	for (const SA::Line line : lines) {
+		lua_pushinteger(L, line);
+		lua_rawseti(L, -2, index++);
+	}
+	return 1;
+}
+
+int cf_scite_property_statistics(lua_State *L) {
+	const std::vector<ExtensionAPI::PropertyStatistic> statistics = host->PropertyStatistics();
+	lua_createtable(L, static_cast<int>(statistics.size()), 0);
+	int index = 1;
+	for (const ExtensionAPI::PropertyStatistic &statistic : statistics) {
+		lua_createtable(L, 0, 5);
+		lua_pushstring(L, statistic.operation.c_str());
+		lua_setfield(L, -2, "operation");
+		lua_pushlstring(L, statistic.key.data(), statistic.key.length());
+		lua_setfield(L, -2, "key");
+		lua_pushinteger(L, static_cast<lua_Integer>(statistic.calls));
+		lua_setfield(L, -2, "calls");
+		lua_pushinteger(L, static_cast<lua_Integer>(statistic.depth));
+		lua_setfield(L, -2, "depth");
+		lua_pushnumber(L, statistic.seconds);
+		lua_setfield(L, -2, "seconds");
+		lua_rawseti(L, -2, index++);
+	}
+	return 1;
+}
+
 ExtensionAPI::Pane check_pane_object(lua_State *L, int index) {
 	ExtensionAPI::Pane *pPane = static_cast<ExtensionAPI::Pane *>(checkudata(L, index, "SciTE_MT_Pane"));
 
@@ -1292,6 +1324,7 @@ void PublishGlobalBufferData() noexcept {
 }
 
 bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
+	const PhaseTimer timer("InitGlobalScope");
 	bool reload = forceReload;
 	if (checkProperties) {
 		const int resetMode = GetPropertyInt("ext.lua.reset");
@@ -1439,6 +1472,12 @@ bool InitGlobalScope(bool checkProperties, bool forceReload = false) {
 	lua_pushcfunction(luaState, cf_scite_strip_value);
 	lua_setfield(luaState, -2, "StripValue");
 
+	lua_pushcfunction(luaState, cf_scite_find_match_lines);
+	lua_setfield(luaState, -2, "FindMatchLines");
+
+	lua_pushcfunction(luaState, cf_scite_property_statistics);
+	lua_setfield(luaState, -2, "PropertyStatistics");
+
 	lua_setglobal(luaState, "scite");
 
 	// append a Metatable onto global namespace, to publish iface constants
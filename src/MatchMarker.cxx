@@ -8,20 +8,138 @@
 #include <string>
 #include <string_view>
 #include <vector>
+#include <deque>
+#include <bitset>
+#include <map>
 #include <set>
 #include <optional>
 #include <algorithm>
+#include <functional>
+#include <memory>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "ScintillaTypes.h"
 #include "ScintillaCall.h"
 
 #include "GUI.h"
 
+#include "StringHelpers.h"
+#include "SubstringSearch.h"
+#include "RegexSearch.h"
+#include "ThreadPool.h"
 #include "MatchMarker.h"
 
 namespace SA = Scintilla;
 
+namespace {
+
+// Time spent applying indicators in each call to Continue so the application stays responsive.
+constexpr double durationStep = 0.05;
+// Below this amount of text outside the visible lines, searching with threads is not worthwhile.
+constexpr SA::Position minimumThreaded = 0x100000;
+constexpr size_t sizeChunk = 0x100000;
+
+template <typename T>
+constexpr bool FlagSet(T flags, T option) noexcept {
+	return (static_cast<int>(flags) & static_cast<int>(option)) != 0;
+}
+
+// Position after the line end at or after position or the length of text.
+size_t LineEndAfter(std::string_view text, size_t position) noexcept {
+	const size_t lineEnd = text.find_first_of("\r\n", position);
+	if (lineEnd == std::string_view::npos) {
+		return text.length();
+	}
+	if ((text[lineEnd] == '\r') && (lineEnd + 1 < text.length()) && (text[lineEnd + 1] == '\n')) {
+		return lineEnd + 2;
+	}
+	return lineEnd + 1;
+}
+
+}
+
+/**
+ * A search shared between a MatchMarker and the worker threads. Threads take chunks in
+ * order so those nearest the visible lines are completed first.
+ */
+struct MatchSearch {
+	// Snapshot of the document so threads are not affected by changes.
+	std::shared_ptr<const std::string> text;
+	// Each chunk starts at a line start and ends after a line end.
+	std::vector<SA::Span> chunks;
+	std::unique_ptr<SubstringSearch> substring;
+	std::unique_ptr<RegexProgram> program;
+	// Word options are checked by Scintilla so all occurrences are candidates.
+	bool confirm = false;
+	std::atomic_size_t next {0};
+	std::atomic_bool cancelled {false};
+
+	std::mutex mutex;
+	std::condition_variable cvFound;
+	std::vector<MatchRegion> found;
+	size_t finished = 0;
+
+	std::vector<MatchRegion> Search(SA::Span chunk);
+	void Work();
+};
+
+std::vector<MatchRegion> MatchSearch::Search(SA::Span chunk) {
+	std::vector<MatchRegion> regions;
+	const std::string_view view = std::string_view(*text).substr(0, chunk.end);
+	if (program) {
+		// Lines containing a match are found then Scintilla finds the matches within them.
+		RegexSearch regexSearch(*program);
+		size_t position = chunk.start;
+		while (position < view.length() && !cancelled) {
+			const size_t found = regexSearch.Find(view, position);
+			if (found == std::string_view::npos) {
+				break;
+			}
+			size_t lineStart = position;
+			if (found > position) {
+				const size_t lineEndPrevious = view.find_last_of("\r\n", found - 1);
+				if ((lineEndPrevious != std::string_view::npos) && (lineEndPrevious >= position)) {
+					lineStart = lineEndPrevious + 1;
+				}
+			}
+			position = LineEndAfter(view, found);
+			const SA::Position start = lineStart;
+			if (!regions.empty() && (regions.back().end == start)) {
+				regions.back().end = position;
+			} else {
+				regions.push_back({start, static_cast<SA::Position>(position), false});
+			}
+		}
+	} else {
+		// Needles do not contain line ends so matches do not extend past the chunk.
+		const size_t length = substring->Length();
+		const size_t step = confirm ? 1 : length;
+		for (size_t position = substring->Find(view, chunk.start);
+			position != std::string_view::npos && !cancelled;
+			position = substring->Find(view, position + step)) {
+			const SA::Position start = position;
+			regions.push_back({start, start + static_cast<SA::Position>(length), !confirm});
+		}
+	}
+	return regions;
+}
+
+void MatchSearch::Work() {
+	for (size_t chunk = next++; (chunk < chunks.size()) && !cancelled; chunk = next++) {
+		const std::vector<MatchRegion> regions = Search(chunks[chunk]);
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			found.insert(found.end(), regions.begin(), regions.end());
+			finished++;
+		}
+		cvFound.notify_one();
+	}
+}
+
 std::vector<LineRange> LinesBreak(SA::ScintillaCall *pSci) {
 	std::vector<LineRange> lineRanges;
 	if (pSci) {
@@ -44,14 +162,81 @@ std::vector<LineRange> LinesBreak(SA::ScintillaCall *pSci) {
 	return lineRanges;
 }
 
+void MatchIndex::MoveGap(SA::Position position) {
+	while (!before.empty() && (before.back().start >= position)) {
+		const SA::Span range = before.back();
+		before.pop_back();
+		after.emplace_back(length - range.start, length - range.end);
+	}
+	while (!after.empty() && (length - after.back().start < position)) {
+		const SA::Span distances = after.back();
+		after.pop_back();
+		before.emplace_back(length - distances.start, length - distances.end);
+	}
+}
+
+void MatchIndex::Clear(SA::Position length_) noexcept {
+	before.clear();
+	after.clear();
+	length = length_;
+}
+
+void MatchIndex::Add(SA::Span range) {
+	MoveGap(range.start);
+	before.push_back(range);
+}
+
+void MatchIndex::Edit(SA::Position start, SA::Position endOld, SA::Position lengthChange) {
+	MoveGap(start);
+	while (!after.empty() && (length - after.back().start < endOld)) {
+		after.pop_back();
+	}
+	length += lengthChange;
+}
+
+size_t MatchIndex::Count() const noexcept {
+	return before.size() + after.size();
+}
+
+std::vector<SA::Position> MatchIndex::Starts() const {
+	std::vector<SA::Position> starts;
+	starts.reserve(Count());
+	for (const SA::Span &range : before) {
+		starts.push_back(range.start);
+	}
+	for (auto it = after.rbegin(); it != after.rend(); ++it) {
+		starts.push_back(length - it->start);
+	}
+	return starts;
+}
+
 MatchMarker::MatchMarker() :
-	pSci(nullptr), styleMatch(-1), flagsMatch(static_cast<SA::FindOption>(0)), indicator(0), bookMark(-1) {
+	pSci(nullptr), styleMatch(-1), flagsMatch(static_cast<SA::FindOption>(0)), indicator(0), bookMark(-1),
+	document(nullptr), length(0), regionNext(0), matchPrevious(0, 0), chunksOutstanding(0),
+	documentSnapshot(nullptr) {
+}
+
+MatchMarker::~MatchMarker() {
+	Stop();
+	ReleaseSnapshot();
+}
+
+void MatchMarker::ReleaseSnapshot() noexcept {
+	snapshot.reset();
+	if (documentSnapshot) {
+		try {
+			documentSnapshot->Release();
+		} catch (...) {
+			// Release must not throw, ignore if it does.
+		}
+		documentSnapshot = nullptr;
+	}
 }
 
 void MatchMarker::StartMatch(SA::ScintillaCall *pSci_,
 			     const std::string &textMatch_, SA::FindOption flagsMatch_, int styleMatch_,
 			     int indicator_, int bookMark_, std::optional<Scintilla::Line> showContext_) {
-	lineRanges.clear();
+	Stop();
 	pSci = pSci_;
 	textMatch = textMatch_;
 	flagsMatch = flagsMatch_;
@@ -59,115 +244,351 @@ void MatchMarker::StartMatch(SA::ScintillaCall *pSci_,
 	indicator = indicator_;
 	bookMark = bookMark_;
 	showContext = showContext_;
-	lineRanges = LinesBreak(pSci);
 	matches.clear();
+	matchPrevious = SA::Span(0, 0);
+	if (!pSci) {
+		return;
+	}
+	document = pSci->DocPointer();
+	length = pSci->Length();
+	index.Clear(length);
+
+	if (indicator >= 0) {
+		// Remove old indicators if any exist.
+		pSci->SetIndicatorCurrent(indicator);
+		pSci->IndicatorClearRange(0, length);
+	}
+
+	std::vector<SA::Span> spans;
+	for (const LineRange &range : LinesBreak(pSci)) {
+		spans.emplace_back(pSci->LineStart(range.lineStart), pSci->LineStart(range.lineEnd));
+	}
+	if (spans.empty()) {
+		return;
+	}
+	regions.push_back({spans.front().start, spans.front().end, false});
+	SA::Position remaining = 0;
+	for (size_t i = 1; i < spans.size(); i++) {
+		remaining += spans[i].Length();
+	}
+	if ((remaining < minimumThreaded) || !SearchInThreads(spans)) {
+		for (size_t i = 1; i < spans.size(); i++) {
+			regions.push_back({spans[i].start, spans[i].end, false});
+		}
+	}
 	// Perform the initial marking immediately to avoid flashing
 	Continue();
 }
 
+bool MatchMarker::SearchInThreads(const std::vector<SA::Span> &spans) {
+	const int codePage = pSci->CodePage();
+	if ((codePage != 0) && (codePage != SA::CpUtf8)) {
+		// Matches in DBCS text must start on character boundaries
+		return false;
+	}
+	const bool matchCase = FlagSet(flagsMatch, SA::FindOption::MatchCase);
+	if (!matchCase && !std::all_of(textMatch.begin(), textMatch.end(), IsASCII)) {
+		// Case folding of non-ASCII text is only known to Scintilla
+		return false;
+	}
+	std::shared_ptr<MatchSearch> searchNew = std::make_shared<MatchSearch>();
+	if (FlagSet(flagsMatch, SA::FindOption::RegExp)) {
+		if (FlagSet(flagsMatch, SA::FindOption::Cxx11RegEx)) {
+			return false;
+		}
+		// Scintilla ignores word options for regular expressions but uses the document's
+		// word characters for \w \W \< \>
+		searchNew->program = std::make_unique<RegexProgram>(textMatch, matchCase, false,
+			FlagSet(flagsMatch, SA::FindOption::Posix), pSci->WordChars());
+		if (!searchNew->program->IsValid()) {
+			return false;
+		}
+	} else {
+		if (textMatch.find_first_of("\r\n") != std::string::npos) {
+			return false;
+		}
+		if ((codePage == SA::CpUtf8) && ((static_cast<unsigned char>(textMatch.front()) & 0xC0) == 0x80)) {
+			// Scintilla does not find text starting inside a character
+			return false;
+		}
+		searchNew->substring = std::make_unique<SubstringSearch>(textMatch, matchCase);
+		searchNew->confirm = FlagSet(flagsMatch, SA::FindOption::WholeWord) ||
+			FlagSet(flagsMatch, SA::FindOption::WordStart);
+	}
+
+	// Changes are seen through TextChanged which depends on insertion and deletion notifications
+	const SA::ModificationFlags mask = pSci->ModEventMask();
+	const bool notified = FlagSet(mask, SA::ModificationFlags::InsertText) && FlagSet(mask, SA::ModificationFlags::DeleteText);
+	if (!notified || !snapshot || (documentSnapshot != document) ||
+		(static_cast<SA::Position>(snapshot->length()) != length)) {
+		ReleaseSnapshot();
+		const char *characters = static_cast<const char *>(pSci->CharacterPointer());
+		snapshot = std::make_shared<const std::string>(characters, length);
+		documentSnapshot = document;
+		documentSnapshot->AddRef();
+	}
+	searchNew->text = snapshot;
+	for (size_t i = 1; i < spans.size(); i++) {
+		size_t position = spans[i].start;
+		const size_t end = spans[i].end;
+		while (position < end) {
+			const size_t endChunk = std::min(LineEndAfter(*snapshot, std::min(position + sizeChunk, end)), end);
+			searchNew->chunks.emplace_back(position, endChunk);
+			position = endChunk;
+		}
+	}
+
+	if (!pool) {
+		pool = std::make_unique<ThreadPool>();
+	}
+	chunksOutstanding = searchNew->chunks.size();
+	const size_t workers = std::min(pool->Size(), searchNew->chunks.size());
+	for (size_t worker = 0; worker < workers; worker++) {
+		pool->Submit([searchNew]() {
+			searchNew->Work();
+		});
+	}
+	search = searchNew;
+	return true;
+}
+
 bool MatchMarker::Complete() const noexcept {
-	return lineRanges.empty();
+	return (regionNext >= regions.size()) && (chunksOutstanding == 0);
 }
 
-void MatchMarker::Continue() {
-	constexpr int segment = 2000;
+bool MatchMarker::Active() const noexcept {
+	return pSci != nullptr;
+}
 
-	// Remove old indicators if any exist.
-	pSci->SetIndicatorCurrent(indicator);
+size_t MatchMarker::Count() const noexcept {
+	return index.Count();
+}
 
-	const LineRange rangeSearch = lineRanges[0];
-	SA::Line lineEndSegment = rangeSearch.lineStart + segment;
-	if (lineEndSegment > rangeSearch.lineEnd)
-		lineEndSegment = rangeSearch.lineEnd;
+std::vector<SA::Line> MatchMarker::Lines() const {
+	std::vector<SA::Line> lines;
+	if (pSci) {
+		for (const SA::Position start : index.Starts()) {
+			const SA::Line line = pSci->LineFromPosition(start);
+			if (lines.empty() || (lines.back() != line)) {
+				lines.push_back(line);
+			}
+		}
+	}
+	return lines;
+}
 
-	pSci->SetSearchFlags(flagsMatch);
-	const SA::Position positionStart = pSci->LineStart(rangeSearch.lineStart);
-	const SA::Position positionEnd = pSci->LineStart(lineEndSegment);
-	pSci->SetTarget(SA::Span(positionStart, positionEnd));
-	pSci->IndicatorClearRange(positionStart, positionEnd - positionStart);
+bool MatchMarker::Matching(SA::ScintillaCall *pSci_, const std::string &textMatch_,
+			   SA::FindOption flagsMatch_, int styleMatch_, int indicator_) const {
+	return pSci && (pSci == pSci_) && (textMatch == textMatch_) && (flagsMatch == flagsMatch_) &&
+		(styleMatch == styleMatch_) && (indicator == indicator_) &&
+		(pSci->DocPointer() == document) && (pSci->Length() == length);
+}
 
-	//Monitor the amount of time took by the search.
-	GUI::ElapsedTime searchElapsedTime;
+bool MatchMarker::Modified(SA::ScintillaCall *pSciModified, SA::Position position,
+			   SA::Position lengthInserted, SA::Position lengthDeleted) {
+	if (!pSci || (pSci != pSciModified)) {
+		return false;
+	}
+	const SA::Position lengthChange = lengthInserted - lengthDeleted;
+	// Scintilla's own regular expressions do not match across lines
+	const bool lineBound = FlagSet(flagsMatch, SA::FindOption::RegExp) ?
+		!FlagSet(flagsMatch, SA::FindOption::Cxx11RegEx) :
+		(textMatch.find_first_of("\r\n") == std::string::npos);
+	if ((chunksOutstanding > 0) || showContext || !lineBound ||
+		(pSci->DocPointer() != document) || (pSci->Length() != length + lengthChange)) {
+		// Threads are searching a snapshot, lines are hidden around matches, matches may span
+		// the changed lines or the document was changed without notification.
+		Stop();
+		return false;
+	}
 
-	SA::Position matchPrevious = SA::InvalidPosition;
+	const SA::Position start = pSci->LineStart(pSci->LineFromPosition(position));
+	const SA::Position end = pSci->LineStart(pSci->LineFromPosition(position + lengthInserted) + 1);
+	const SA::Position endOld = end - lengthChange;
+	index.Edit(start, endOld, lengthChange);
+	length += lengthChange;
 
-	// Find the first occurrence of word.
-	SA::Span rangeFound = pSci->SpanSearchInTarget(textMatch);
-	while ((rangeFound.start >= 0) && (rangeFound.start != matchPrevious)) {
-		matchPrevious = rangeFound.start;
-		// Limit the search duration to 250 ms. Avoid to freeze editor for huge lines.
-		if (searchElapsedTime.Duration() > 0.25) {
-			// Clear all indicators because timer has expired.
-			pSci->IndicatorClearRange(0, pSci->Length());
-			lineRanges.clear();
-			break;
+	MatchRegion changed {start, end, false};
+	std::vector<MatchRegion> pending;
+	for (size_t i = regionNext; i < regions.size(); i++) {
+		MatchRegion region = regions[i];
+		if (region.end <= start) {
+			pending.push_back(region);
+		} else if (region.start >= endOld) {
+			region.start += lengthChange;
+			region.end += lengthChange;
+			pending.push_back(region);
+		} else if (!region.exact) {
+			changed.start = std::min(changed.start, region.start);
+			changed.end = std::max(changed.end, region.end + lengthChange);
 		}
+		// Exact matches in the changed lines are found again when they are searched
+	}
+	// Search the changed lines first as they are where the user is working
+	pending.insert(pending.begin(), changed);
+	regions = std::move(pending);
+	regionNext = 0;
+	matchPrevious = SA::Span(0, 0);
+	return true;
+}
 
-		if ((styleMatch < 0) || (styleMatch == pSci->UnsignedStyleAt(rangeFound.start))) {
-			pSci->IndicatorFillRange(rangeFound.start, rangeFound.Length());
-			const SA::Line line = pSci->LineFromPosition(rangeFound.start);
-			if ((bookMark >= 0) && (showContext != 0)) {
-				pSci->MarkerAdd(line, bookMark);
-			}
-			if (showContext >= 0) {
-				matches.insert(line);
-			}
+void MatchMarker::TextChanged(const SA::IDocumentEditable *documentChanged) noexcept {
+	if (documentChanged == documentSnapshot) {
+		ReleaseSnapshot();
+	}
+}
+
+void MatchMarker::Collect(bool wait) {
+	if (!search) {
+		return;
+	}
+	std::unique_lock<std::mutex> lock(search->mutex);
+	if (wait) {
+		// Avoid spinning in the idle loop while the threads are busy
+		search->cvFound.wait_for(lock, std::chrono::milliseconds(10), [this] {
+			return search->finished > 0;
+		});
+	}
+	if (!search->found.empty()) {
+		regions.erase(regions.begin(), regions.begin() + regionNext);
+		regionNext = 0;
+		regions.insert(regions.end(), search->found.begin(), search->found.end());
+		search->found.clear();
+	}
+	chunksOutstanding -= search->finished;
+	search->finished = 0;
+	lock.unlock();
+	if (chunksOutstanding == 0) {
+		// The snapshot is kept by this for searching again
+		search.reset();
+	}
+}
+
+void MatchMarker::Mark(SA::Span range) {
+	if ((range.start >= matchPrevious.start) && (range.start < matchPrevious.end)) {
+		// Overlaps a match that Scintilla would have found first
+		return;
+	}
+	matchPrevious = range;
+	if ((styleMatch < 0) || (styleMatch == pSci->UnsignedStyleAt(range.start))) {
+		if (indicator >= 0) {
+			pSci->IndicatorFillRange(range.start, range.Length());
+		}
+		index.Add(range);
+		const SA::Line line = pSci->LineFromPosition(range.start);
+		if ((bookMark >= 0) && (showContext != 0)) {
+			pSci->MarkerAdd(line, bookMark);
+		}
+		if (showContext >= 0) {
+			matches.insert(line);
 		}
+	}
+}
+
+bool MatchMarker::SearchRegion(MatchRegion &region, GUI::ElapsedTime &elapsed) {
+	SA::Position positionPrevious = SA::InvalidPosition;
+	if (indicator >= 0) {
+		pSci->IndicatorClearRange(region.start, region.end - region.start);
+	}
+	pSci->SetTarget(SA::Span(region.start, region.end));
+	SA::Span rangeFound = pSci->SpanSearchInTarget(textMatch);
+	while ((rangeFound.start >= 0) && (rangeFound.start != positionPrevious)) {
+		positionPrevious = rangeFound.start;
+		Mark(rangeFound);
 		if (rangeFound.Length() == 0) {
 			// Empty matches are possible for regex
 			rangeFound.end = pSci->PositionAfter(rangeFound.end);
 		}
+		if (elapsed.Duration() > durationStep) {
+			// Resume after this match next time
+			region.start = rangeFound.end;
+			return false;
+		}
 		// Try to find next occurrence of word.
-		pSci->SetTarget(SA::Span(rangeFound.end, positionEnd));
+		pSci->SetTarget(SA::Span(rangeFound.end, region.end));
 		rangeFound = pSci->SpanSearchInTarget(textMatch);
 	}
+	return true;
+}
 
-	// Retire searched lines
-	if (!lineRanges.empty()) {
-		// Check in case of re-entrance
-		if (lineEndSegment >= rangeSearch.lineEnd) {
-			lineRanges.erase(lineRanges.begin());
-		} else {
-			lineRanges[0].lineStart = lineEndSegment;
-		}
-	}
-	if (lineRanges.empty() && showContext) {
-		// Hide / show lines so that matches and their context are visible
-		// Could do this incrementally but there are problems near segment edges
-		const SA::Line lineCount = pSci->LineCount();
-		std::vector<bool> visible(lineCount);
-		for (const SA::Line line : matches) {
-			for (SA::Line context = line - *showContext; context <= line + *showContext; context++) {
-				if (context >= 0 && context < lineCount) {
-					visible[context] = true;
-				}
-			}
+void MatchMarker::Continue() {
+	if (!pSci) {
+		return;
+	}
+	if ((pSci->DocPointer() != document) || (pSci->Length() != length)) {
+		// Positions found in the snapshot no longer apply
+		Stop();
+		return;
+	}
+
+	GUI::ElapsedTime elapsed;
+	Collect(regionNext >= regions.size());
+
+	if (indicator >= 0) {
+		pSci->SetIndicatorCurrent(indicator);
+	}
+	pSci->SetSearchFlags(flagsMatch);
+	while ((regionNext < regions.size()) && (elapsed.Duration() < durationStep)) {
+		MatchRegion &region = regions[regionNext];
+		if (region.exact) {
+			Mark(SA::Span(region.start, region.end));
+		} else if (!SearchRegion(region, elapsed)) {
+			break;
 		}
-		// Batch up show to minimize calls
-		// Seems a bit smoother to show/hide each group instead of
-		// hiding all then showing groups even though that means more calls
-		SA::Line startGroup = 0;
-		bool state = true;
-		for (SA::Line line = 0; line < lineCount; line++) {
-			if (state != visible[line]) {
-				if (state) {
-					pSci->ShowLines(startGroup, line - 1);
-				} else {
-					pSci->HideLines(startGroup, line - 1);
-				}
-				startGroup = line;
-				state = visible[line];
+		regionNext++;
+	}
+	if (regionNext >= regions.size()) {
+		regions.clear();
+		regionNext = 0;
+	}
+
+	if (Complete() && showContext) {
+		ShowContext();
+	}
+}
+
+void MatchMarker::ShowContext() {
+	// Hide / show lines so that matches and their context are visible
+	// Could do this incrementally but there are problems near segment edges
+	const SA::Line lineCount = pSci->LineCount();
+	std::vector<bool> visible(lineCount);
+	for (const SA::Line line : matches) {
+		for (SA::Line context = line - *showContext; context <= line + *showContext; context++) {
+			if (context >= 0 && context < lineCount) {
+				visible[context] = true;
 			}
 		}
-		if (state) {
-			pSci->ShowLines(startGroup, lineCount - 1);
-		} else {
-			pSci->HideLines(startGroup, lineCount - 1);
+	}
+	// Batch up show to minimize calls
+	// Seems a bit smoother to show/hide each group instead of
+	// hiding all then showing groups even though that means more calls
+	SA::Line startGroup = 0;
+	bool state = true;
+	for (SA::Line line = 0; line < lineCount; line++) {
+		if (state != visible[line]) {
+			if (state) {
+				pSci->ShowLines(startGroup, line - 1);
+			} else {
+				pSci->HideLines(startGroup, line - 1);
+			}
+			startGroup = line;
+			state = visible[line];
 		}
 	}
+	if (state) {
+		pSci->ShowLines(startGroup, lineCount - 1);
+	} else {
+		pSci->HideLines(startGroup, lineCount - 1);
+	}
 }
 
 void MatchMarker::Stop() noexcept {
+	if (search) {
+		search->cancelled = true;
+		search.reset();
+	}
+	chunksOutstanding = 0;
+	regions.clear();
+	regionNext = 0;
 	pSci = nullptr;
-	lineRanges.clear();
 }
@@ -16,6 +16,46 @@ struct LineRange {
 
 std::vector<LineRange> LinesBreak(Scintilla::ScintillaCall *pSci);
 
+struct MatchRegion {
+	Scintilla::Position start;
+	Scintilla::Position end;
+	// Exactly one match, otherwise the region is searched by Scintilla.
+	bool exact;
+};
+
+/**
+ * Sorted matches split at a gap so an edit only moves the matches between it and the
+ * previous edit. Matches after the gap are held as distances from the end of the document
+ * so they are unchanged by insertions and deletions before them.
+ */
+class MatchIndex {
+	std::vector<Scintilla::Span> before;
+	// Nearest the gap at the back.
+	std::vector<Scintilla::Span> after;
+	Scintilla::Position length = 0;
+	void MoveGap(Scintilla::Position position);
+public:
+	void Clear(Scintilla::Position length_) noexcept;
+	void Add(Scintilla::Span range);
+	/// Text from start to endOld was changed by lengthChange so remove the matches starting there.
+	void Edit(Scintilla::Position start, Scintilla::Position endOld, Scintilla::Position lengthChange);
+	size_t Count() const noexcept;
+	std::vector<Scintilla::Position> Starts() const;
+};
+
+struct MatchSearch;
+class ThreadPool;
+
+/**
+ * The lines around the visible lines are searched immediately. The rest of a large
+ * document is copied and searched by worker threads in parallel with the nearest lines
+ * first. The copy is kept for later searches until the document's text changes. Only
+ * applying the indicators is performed on the calling thread, from the idle loop.
+ * Searches that can not be performed exactly by the threads, such as those ignoring the
+ * case of non-ASCII text, narrow the lines and leave Scintilla to find the matches.
+ * Once started, matches are maintained through edits by searching the changed lines again.
+ * With an indicator less than 0, matches are only counted and indexed.
+ */
 class MatchMarker {
 	Scintilla::ScintillaCall *pSci;
 	std::string textMatch;
@@ -24,14 +64,53 @@ class MatchMarker {
 	int indicator;
 	int bookMark;
 	std::optional<Scintilla::Line> showContext;
-	std::vector<LineRange> lineRanges;
+	// The document searched and its length to detect when it changes.
+	Scintilla::IDocumentEditable *document;
+	Scintilla::Position length;
+	std::vector<MatchRegion> regions;
+	size_t regionNext;
+	Scintilla::Span matchPrevious;
 	std::set<Scintilla::Line> matches;
+	MatchIndex index;
+	std::shared_ptr<MatchSearch> search;
+	size_t chunksOutstanding;
+	std::unique_ptr<ThreadPool> pool;
+	// Copy of the text of documentSnapshot which is referenced so its address is not reused.
+	std::shared_ptr<const std::string> snapshot;
+	Scintilla::IDocumentEditable *documentSnapshot;
+	void ReleaseSnapshot() noexcept;
+	bool SearchInThreads(const std::vector<Scintilla::Span> &spans);
+	void Collect(bool wait);
+	void Mark(Scintilla::Span range);
+	bool SearchRegion(MatchRegion &region, GUI::ElapsedTime &elapsed);
+	void ShowContext();
 public:
 	MatchMarker();	// Not noexcept as std::vector constructor throws
+	// Deleted so MatchMarker objects can not be copied.
+	MatchMarker(const MatchMarker &) = delete;
+	MatchMarker(MatchMarker &&) = delete;
+	MatchMarker &operator=(const MatchMarker &) = delete;
+	MatchMarker &operator=(MatchMarker &&) = delete;
+	~MatchMarker();
 	void StartMatch(Scintilla::ScintillaCall *pSci_,
 			const std::string &textMatch_, Scintilla::FindOption flagsMatch_, int styleMatch_,
 			int indicator_, int bookMark_, std::optional<Scintilla::Line> showContext_={});
 	bool Complete() const noexcept;
+	/// Started and not stopped since, although may not be complete.
+	bool Active() const noexcept;
+	size_t Count() const noexcept;
+	/// Lines containing matches in ascending order.
+	std::vector<Scintilla::Line> Lines() const;
+	/// Is this searching pSci_ for the same matches with the results still valid.
+	bool Matching(Scintilla::ScintillaCall *pSci_, const std::string &textMatch_,
+		      Scintilla::FindOption flagsMatch_, int styleMatch_, int indicator_) const;
+	/// Adjust for text inserted or deleted in pSciModified and queue the changed lines to be
+	/// searched again by Continue. Returns false if the matches can not be maintained.
+	bool Modified(Scintilla::ScintillaCall *pSciModified, Scintilla::Position position,
+		      Scintilla::Position lengthInserted, Scintilla::Position lengthDeleted);
+	/// Must be called for every change to the text of any document, including those not
+	/// passed to Modified, so that a copy of the old text is not searched.
+	void TextChanged(const Scintilla::IDocumentEditable *documentChanged) noexcept;
 	void Continue();
 	void Stop() noexcept;
 };
@@ -0,0 +1,131 @@
+// SciTE - Scintilla based Text Editor
+/** @file PhaseProfile.cxx
+ ** Time the phases of starting the application.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstdint>
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "GUI.h"
+#include "PhaseProfile.h"
+
+namespace {
+
+// Constructed before main so times are measured from close to when the application started.
+PhaseProfile startup;
+
+std::string Milliseconds(double seconds) {
+	char buffer[40];
+	snprintf(buffer, sizeof(buffer), "%.3f", seconds * 1000.0);
+	return buffer;
+}
+
+// Keep each phase on one line of the table.
+std::string Field(std::string_view text) {
+	std::string field(text);
+	std::replace_if(field.begin(), field.end(), [](char ch) noexcept {
+		return ch == '\t' || ch == '\r' || ch == '\n';
+	}, ' ');
+	return field;
+}
+
+}
+
+PhaseProfile::PhaseProfile() noexcept : thread(std::this_thread::get_id()) {
+}
+
+PhaseProfile &PhaseProfile::Startup() noexcept {
+	return startup;
+}
+
+bool PhaseProfile::Recording() const noexcept {
+	return recording && (std::this_thread::get_id() == thread);
+}
+
+size_t PhaseProfile::Begin(std::string_view name, std::string_view detail) {
+	if (!Recording()) {
+		return noPhase;
+	}
+	phases.push_back({ std::string(name), std::string(detail), depth, elapsed.Duration(), -1.0 });
+	depth++;
+	return phases.size() - 1;
+}
+
+void PhaseProfile::End(size_t phase) noexcept {
+	if (!Recording() || (phase >= phases.size())) {
+		return;
+	}
+	phases[phase].duration = elapsed.Duration() - phases[phase].start;
+	depth = phases[phase].depth;
+}
+
+void PhaseProfile::Mark(std::string_view name) {
+	if (Recording()) {
+		phases.push_back({ std::string(name), {}, depth, elapsed.Duration(), -1.0 });
+	}
+}
+
+void PhaseProfile::Stop(bool keep) noexcept {
+	recording = false;
+	if (!keep) {
+		phases.clear();
+		phases.shrink_to_fit();
+	}
+}
+
+std::string PhaseProfile::Report() const {
+	std::string report = "Startup profile: start ms, duration ms, phase\n";
+	for (const Phase &phase : phases) {
+		std::string line = Milliseconds(phase.start);
+		line.insert(0, std::max<size_t>(10, line.length()) - line.length(), ' ');
+		std::string duration = (phase.duration >= 0.0) ? Milliseconds(phase.duration) : std::string();
+		duration.insert(0, std::max<size_t>(10, duration.length()) - duration.length(), ' ');
+		line += duration;
+		line += "  ";
+		line.append(phase.depth * 2, ' ');
+		line += phase.name;
+		if (!phase.detail.empty()) {
+			line += " ";
+			line += Field(phase.detail);
+		}
+		report += line;
+		report += "\n";
+	}
+	return report;
+}
+
+std::string PhaseProfile::Tabulated() const {
+	std::string table = "name\tdetail\tdepth\tstart\tduration\n";
+	for (const Phase &phase : phases) {
+		table += Field(phase.name);
+		table += "\t";
+		table += Field(phase.detail);
+		table += "\t";
+		table += std::to_string(phase.depth);
+		table += "\t";
+		table += Milliseconds(phase.start);
+		table += "\t";
+		if (phase.duration >= 0.0) {
+			table += Milliseconds(phase.duration);
+		}
+		table += "\n";
+	}
+	return table;
+}
+
+PhaseTimer::PhaseTimer(std::string_view name, std::string_view detail) :
+	phase(PhaseProfile::Startup().Begin(name, detail)) {
+}
+
+PhaseTimer::~PhaseTimer() {
+	PhaseProfile::Startup().End(phase);
+}
@@ -0,0 +1,65 @@
+// SciTE - Scintilla based Text Editor
+/** @file PhaseProfile.h
+ ** Time the phases of starting the application.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef PHASEPROFILE_H
+#define PHASEPROFILE_H
+
+/**
+ * Records when each phase of starting began and how long it took.
+ * Phases may be nested, such as the files imported while reading a properties file.
+ * Recording happens only on the thread that started the application and finishes when
+ * Stop is called, after which Begin and End do nothing so their cost is negligible.
+ */
+class PhaseProfile {
+	struct Phase {
+		std::string name;
+		std::string detail;
+		size_t depth = 0;
+		double start = 0.0;
+		double duration = -1.0;
+	};
+	GUI::ElapsedTime elapsed;
+	std::thread::id thread;
+	std::vector<Phase> phases;
+	size_t depth = 0;
+	bool recording = true;
+public:
+	static constexpr size_t noPhase = SIZE_MAX;
+
+	PhaseProfile() noexcept;
+	/// The profile started when the application was loaded.
+	static PhaseProfile &Startup() noexcept;
+	bool Recording() const noexcept;
+	size_t Begin(std::string_view name, std::string_view detail = {});
+	void End(size_t phase) noexcept;
+	/// A moment, such as the first paint, rather than a phase.
+	void Mark(std::string_view name);
+	/// Stop recording and, when keep is false, discard what has been recorded.
+	void Stop(bool keep) noexcept;
+	/// A table indented by depth with times in milliseconds.
+	std::string Report() const;
+	/// Tab separated values with a header line: name, detail, depth, start and duration
+	/// in milliseconds. Marks have an empty duration.
+	std::string Tabulated() const;
+};
+
+/**
+ * Times a phase of the startup profile from construction to destruction.
+ */
+class PhaseTimer {
+	size_t phase;
+public:
+	explicit PhaseTimer(std::string_view name, std::string_view detail = {});
+	// Deleted so PhaseTimer objects can not be copied.
+	PhaseTimer(const PhaseTimer &) = delete;
+	PhaseTimer(PhaseTimer &&) = delete;
+	PhaseTimer &operator=(const PhaseTimer &) = delete;
+	PhaseTimer &operator=(PhaseTimer &&) = delete;
+	~PhaseTimer();
+};
+
+#endif
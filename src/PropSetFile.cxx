@@ -7,6 +7,7 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstdint>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
@@ -19,10 +20,16 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
+#include <iterator>
+#include <functional>
 #include <memory>
 #include <chrono>
+#include <atomic>
 #include <sstream>
+#include <thread>
 
 #include <fcntl.h>
 
@@ -37,6 +44,7 @@
 #include "StringHelpers.h"
 #include "FilePath.h"
 #include "PathMatch.h"
+#include "PhaseProfile.h"
 #include "PropSetFile.h"
 #include "EditorConfig.h"
 
@@ -56,15 +64,372 @@ bool ImportFilter::IsValid(const std::string &name) const {
 	}
 }
 
+/**
+ * The values found for keys looked up through a set and its base sets, so that a key
+ * used repeatedly is found with one hash lookup instead of a search of each set.
+ * Each key is held once and may be found without allocating. The values point into
+ * the maps of the sets so are valid while each set has the version recorded in chain.
+ */
+struct PropSetLookups {
+	struct KeyHash {
+		using is_transparent = void;
+		size_t operator()(std::string_view key) const noexcept {
+			return std::hash<std::string_view>{}(key);
+		}
+	};
+	struct Result {
+		std::string_view value = "";
+		bool found = false;
+		// Number of sets searched
+		size_t depth = 0;
+	};
+	std::vector<std::pair<const PropSetFile *, unsigned long long>> chain;
+	std::unordered_map<std::string, Result, KeyHash, std::equal_to<>> results;
+	// Fully expanded values of variables with the variables they depend on
+	struct Expansion {
+		std::string value;
+		std::vector<std::string> variables;
+		int expansions = 0;
+	};
+	std::unordered_map<std::string, Expansion, KeyHash, std::equal_to<>> expansions;
+	// For each variable, the expansions that depend on it
+	std::unordered_map<std::string, std::unordered_set<std::string>, KeyHash, std::equal_to<>> dependents;
+	/**
+	 * The values GetWild may return for a keybase, numbered in the order they are tried,
+	 * with their filename patterns sorted so most can be found by hashing instead of
+	 * trying each pattern in turn.
+	 */
+	struct WildIndex {
+		bool caseSensitive;
+		std::vector<std::string_view> values;
+		// First value that applies to every filename
+		size_t always = SIZE_MAX;
+		// Patterns without wildcards
+		std::unordered_map<std::string, size_t, KeyHash, std::equal_to<>> names;
+		// Patterns like "*.cxx" keyed by the part following the '*'
+		std::unordered_map<std::string, size_t, KeyHash, std::equal_to<>> extensions;
+		// Other patterns in order
+		std::vector<std::pair<std::string, size_t>> globs;
+		// Variables expanded to find patterns
+		std::vector<std::string> variables;
+		explicit WildIndex(bool caseSensitive_) noexcept : caseSensitive(caseSensitive_) {}
+		void Add(std::string_view patternSet, size_t value);
+		size_t Match(std::string_view filename) const;
+	};
+	std::unordered_map<std::string, WildIndex, KeyHash, std::equal_to<>> wilds;
+	void Clear() noexcept {
+		results.clear();
+		expansions.clear();
+		dependents.clear();
+		wilds.clear();
+	}
+};
+
+/**
+ * Files imported with ImportFilter::lazy. When imported only the keys needed before
+ * a file's language is chosen are read, such as lexer.* and filter.*, along with the
+ * lexers named by its lexer.* keys. The remaining keys are read when ReadLanguage is
+ * called for one of those lexers or when a value read in full uses one of them as a variable.
+ * Each import is numbered so that reading it later does not replace keys set after it.
+ */
+struct PropSetLazy {
+	struct File {
+		FilePath filename;
+		FilePath directoryForImports;
+		ImportFilter filter;
+		size_t depth = 0;
+		size_t ordinal = 0;
+		std::vector<std::string> lexers;
+		// Keys set by the file that have not been read
+		std::set<std::string, std::less<>> keys;
+	};
+	std::vector<File> files;
+	// For each key set since the first lazy import, the number of the import it followed
+	std::map<std::string, size_t, std::less<>> ordinals;
+	size_t ordinal = 0;
+	// Ordinal of the file being read in full
+	size_t reading = 0;
+	bool scanning = false;
+	// Variables used by values that have been read
+	std::set<std::string, std::less<>> used;
+	// Variables added to used that have not yet been looked for in files
+	std::vector<std::string> pending;
+	void Use(std::string_view value);
+	bool Uses(const File &file) const;
+};
+
+void PropSetLazy::Use(std::string_view value) {
+	// For nested variables like $(a$(b)) only the inner variable is known
+	size_t varStart = value.find("$(");
+	while (varStart != std::string_view::npos) {
+		const size_t varEnd = value.find_first_of(")$ ", varStart + 2);
+		if (varEnd == std::string_view::npos) {
+			break;
+		}
+		if (value[varEnd] == ')') {
+			const std::string_view var = value.substr(varStart + 2, varEnd - (varStart + 2));
+			if (!used.contains(var)) {
+				used.emplace(var);
+				pending.emplace_back(var);
+			}
+		}
+		varStart = value.find("$(", varStart + 2);
+	}
+}
+
+bool PropSetLazy::Uses(const File &file) const {
+	return std::any_of(file.keys.begin(), file.keys.end(), [this](const std::string &key) {
+		return used.contains(key);
+	});
+}
+
+namespace {
+
+// Keys read from lazily imported files before their language is used
+constexpr std::string_view eagerPrefixes[] = {
+	"lexer.", "file.patterns.", "filter.", "*filter.", "language.", "*language.",
+	"source.", "*source.", "shbang.",
+};
+
+bool IsEagerKey(std::string_view key) noexcept {
+	return std::any_of(std::begin(eagerPrefixes), std::end(eagerPrefixes), [key](std::string_view prefix) noexcept {
+		return StartsWith(key, prefix);
+	});
+}
+
+std::atomic<unsigned long long> versionLast = 0;
+
+unsigned long long NewVersion() noexcept {
+	return ++versionLast;
+}
+
+enum class Lookup { get, wild, expand };
+constexpr const char *lookupNames[] = { "Get", "GetWild", "Expand" };
+
+struct LookupCount {
+	size_t calls = 0;
+	size_t depth = 0;
+	double seconds = 0.0;
+};
+
+// Property sets are only used on the main thread, since lookups fill their caches
+// without locking, so the counts are not locked either.
+bool statisticsEnabled = false;
+std::map<std::string, LookupCount, std::less<>> statistics[std::size(lookupNames)];
+
+// Counts one lookup when statistics are on, timing it from construction to destruction.
+class LookupCounter {
+	Lookup lookup;
+	std::string_view key;
+	bool counting;
+	std::chrono::steady_clock::time_point start;
+public:
+	size_t depth = 0;
+	LookupCounter(Lookup lookup_, std::string_view key_) noexcept :
+		lookup(lookup_), key(key_), counting(statisticsEnabled) {
+		if (counting) {
+			start = std::chrono::steady_clock::now();
+		}
+	}
+	// Deleted so LookupCounter objects can not be copied.
+	LookupCounter(const LookupCounter &) = delete;
+	LookupCounter(LookupCounter &&) = delete;
+	LookupCounter &operator=(const LookupCounter &) = delete;
+	LookupCounter &operator=(LookupCounter &&) = delete;
+	~LookupCounter() {
+		if (!counting) {
+			return;
+		}
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		try {
+			std::map<std::string, LookupCount, std::less<>> &counts = statistics[static_cast<size_t>(lookup)];
+			auto it = counts.find(key);
+			if (it == counts.end()) {
+				it = counts.emplace(key, LookupCount()).first;
+			}
+			it->second.calls++;
+			it->second.depth += depth;
+			it->second.seconds += duration.count();
+		} catch (...) {
+			// Counts are not important enough to fail a lookup
+		}
+	}
+	bool Counting() const noexcept {
+		return counting;
+	}
+};
+
+}
+
 bool PropSetFile::caseSensitiveFilenames = false;
 
-PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), superPS(nullptr) {
+PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), version(NewVersion()), superPS(nullptr) {
+}
+
+PropSetFile::PropSetFile(const PropSetFile &other) :
+	lowerKeys(other.lowerKeys), props(other.props), version(NewVersion()),
+	lazy(other.lazy ? std::make_unique<PropSetLazy>(*other.lazy) : nullptr), superPS(other.superPS) {
+}
+
+PropSetFile::PropSetFile(PropSetFile &&other) noexcept :
+	lowerKeys(other.lowerKeys), props(std::move(other.props)), version(NewVersion()),
+	lazy(std::move(other.lazy)), superPS(other.superPS) {
+	other.props.clear();
+	other.version = NewVersion();
+	other.lookups.reset();
+}
+
+PropSetFile &PropSetFile::operator=(const PropSetFile &other) {
+	if (this != &other) {
+		lowerKeys = other.lowerKeys;
+		props = other.props;
+		version = NewVersion();
+		lookups.reset();
+		lazy = other.lazy ? std::make_unique<PropSetLazy>(*other.lazy) : nullptr;
+		superPS = other.superPS;
+	}
+	return *this;
+}
+
+PropSetFile &PropSetFile::operator=(PropSetFile &&other) noexcept {
+	if (this != &other) {
+		lowerKeys = other.lowerKeys;
+		props = std::move(other.props);
+		version = NewVersion();
+		lookups.reset();
+		lazy = std::move(other.lazy);
+		superPS = other.superPS;
+		other.props.clear();
+		other.version = NewVersion();
+		other.lookups.reset();
+	}
+	return *this;
+}
+
+PropSetFile::~PropSetFile() = default;
+
+void PropSetFile::SetRecord(PropSetReadRecord *record_) noexcept {
+	record = record_;
+	// Earlier results would hide lookups from the record
+	lookups.reset();
+}
+
+void PropSetFile::Changed(std::string_view key) {
+	const unsigned long long versionPrevious = version;
+	version = NewVersion();
+	if (lookups && !lookups->chain.empty() && (lookups->chain.front().first == this) &&
+		(lookups->chain.front().second == versionPrevious)) {
+		// Only key can have changed so keep the results for other keys
+		lookups->chain.front().second = version;
+		const auto it = lookups->results.find(key);
+		if (it != lookups->results.end()) {
+			lookups->results.erase(it);
+		}
+		const auto itDependents = lookups->dependents.find(key);
+		if (itDependents != lookups->dependents.end()) {
+			for (const std::string &expansion : itDependents->second) {
+				lookups->expansions.erase(expansion);
+			}
+			lookups->dependents.erase(itDependents);
+		}
+		for (auto itWild = lookups->wilds.begin(); itWild != lookups->wilds.end();) {
+			const std::vector<std::string> &variables = itWild->second.variables;
+			if (StartsWith(key, itWild->first) ||
+				(std::find(variables.begin(), variables.end(), key) != variables.end())) {
+				itWild = lookups->wilds.erase(itWild);
+			} else {
+				++itWild;
+			}
+		}
+	}
+}
+
+PropSetLookups &PropSetFile::Lookups() const {
+	if (!lookups) {
+		lookups = std::make_unique<PropSetLookups>();
+	}
+	// Discard all the results if any set in the chain has changed or been replaced
+	auto itChain = lookups->chain.cbegin();
+	const PropSetFile *psf = this;
+	for (; psf && (itChain != lookups->chain.cend()); psf = psf->superPS, ++itChain) {
+		if ((itChain->first != psf) || (itChain->second != psf->version)) {
+			break;
+		}
+	}
+	if (psf || (itChain != lookups->chain.cend())) {
+		lookups->Clear();
+		lookups->chain.clear();
+		for (psf = this; psf; psf = psf->superPS) {
+			lookups->chain.emplace_back(psf, psf->version);
+		}
+	}
+	return *lookups;
+}
+
+bool PropSetFile::Find(std::string_view key, std::string_view &value, size_t *depth) const {
+	PropSetLookups &current = Lookups();
+	const auto it = current.results.find(key);
+	if (it != current.results.end()) {
+		value = it->second.value;
+		if (depth) {
+			*depth = it->second.depth;
+		}
+		if (record && (props.find(key) == props.end())) {
+			record->inherited.emplace(key, value);
+		}
+		return it->second.found;
+	}
+	PropSetLookups::Result result;
+	const PropSetFile *psf = this;
+	for (; psf; psf = psf->superPS) {
+		result.depth++;
+		const mapss::const_iterator keyPos = psf->props.find(key);
+		if (keyPos != psf->props.end()) {
+			result.value = keyPos->second;
+			result.found = true;
+			break;
+		}
+		// Failed here, so try in base property set
+	}
+	current.results.emplace(key, result);
+	value = result.value;
+	if (depth) {
+		*depth = result.depth;
+	}
+	if (record && (psf != this)) {
+		record->inherited.emplace(key, value);
+	}
+	return result.found;
 }
 
 void PropSetFile::Set(std::string_view key, std::string_view val) {
 	if (key.empty())	// Empty keys are not supported
 		return;
+	if (lazy) {
+		if (lazy->scanning) {
+			if (!IsEagerKey(key)) {
+				lazy->files.back().keys.emplace(key);
+				return;
+			}
+			if (StartsWith(key, "lexer.$(") || StartsWith(key, "lexer.*")) {
+				lazy->files.back().lexers.emplace_back(val);
+			}
+		} else {
+			lazy->Use(val);
+		}
+		const size_t ordinal = lazy->reading ? lazy->reading : lazy->ordinal;
+		const auto it = lazy->ordinals.find(key);
+		if (it == lazy->ordinals.end()) {
+			lazy->ordinals.emplace(key, ordinal);
+		} else if (it->second > ordinal) {
+			// Set by a line read after the file being read in full
+			return;
+		} else {
+			it->second = ordinal;
+		}
+	}
 	props[std::string(key)] = std::string(val);
+	Changed(key);
 }
 
 void PropSetFile::SetPath(std::string_view key, const FilePath &path) {
@@ -102,39 +467,29 @@ void PropSetFile::Unset(std::string_view key) {
 	if (key.empty())	// Empty keys are not supported
 		return;
 	const mapss::iterator keyPos = props.find(key);
-	if (keyPos != props.end())
+	if (keyPos != props.end()) {
 		props.erase(keyPos);
+		Changed(key);
+	}
 }
 
 void PropSetFile::Clear() noexcept {
 	props.clear();
+	version = NewVersion();
+	lookups.reset();
+	lazy.reset();
 }
 
 bool PropSetFile::Exists(std::string_view key) const {
-	const mapss::const_iterator keyPos = props.find(key);
-	if (keyPos != props.end()) {
-		return true;
-	} else {
-		if (superPS) {
-			// Failed here, so try in base property set
-			return superPS->Exists(key);
-		} else {
-			return false;
-		}
-	}
+	std::string_view value;
+	return Find(key, value);
 }
 
 std::string_view PropSetFile::Get(std::string_view key) const {
-	const PropSetFile *psf = this;
-	while (psf) {
-		const mapss::const_iterator keyPos = psf->props.find(key);
-		if (keyPos != psf->props.end()) {
-			return keyPos->second;
-		}
-		// Failed here, so try in base property set
-		psf = psf->superPS;
-	}
-	return "";
+	LookupCounter counter(Lookup::get, key);
+	std::string_view value;
+	Find(key, value, &counter.depth);
+	return value;
 }
 
 std::string PropSetFile::GetString(std::string_view key) const {
@@ -197,6 +552,9 @@ std::string PropSetFile::Evaluate(std::string_view key) const {
 				return equal ? "1" : "0";
 			}
 		} else if (StartsWith(key, "star ")) {
+			if (record) {
+				record->complete = false;
+			}
 			const std::string sKeybase(key.substr(5));
 			// Create set of variables with values
 			mapss values;
@@ -252,7 +610,41 @@ struct VarChain {
 	const VarChain *link=nullptr;
 };
 
-static int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int maxExpands, const VarChain &blankVars = VarChain()) {
+/**
+ * The variables an expansion referenced, directly or through other variables, so it can
+ * be reused until one of them changes. Expansions of some forms like "star " depend on
+ * more than named variables so are not kept.
+ */
+struct ExpansionUse {
+	std::vector<std::string> variables;
+	bool cacheable = true;
+	void Add(std::string_view variable) {
+		if (std::find(variables.begin(), variables.end(), variable) == variables.end()) {
+			variables.emplace_back(variable);
+		}
+	}
+	void Add(const std::vector<std::string> &others) {
+		for (const std::string &variable : others) {
+			Add(variable);
+		}
+	}
+	void Add(const ExpansionUse &other) {
+		Add(other.variables);
+		cacheable = cacheable && other.cacheable;
+	}
+};
+
+namespace {
+
+bool AnyBlanked(const std::vector<std::string> &variables, const VarChain &blankVars) {
+	return std::any_of(variables.begin(), variables.end(), [&blankVars](const std::string &variable) {
+		return blankVars.contains(variable);
+	});
+}
+
+}
+
+int PropSetFile::ExpandAllInPlace(std::string &withVars, int maxExpands, const VarChain &blankVars, ExpansionUse &use) const {
 	size_t varStart = withVars.find("$(");
 	while ((varStart != std::string::npos) && (maxExpands > 0)) {
 		const size_t varEnd = withVars.find(')', varStart+2);
@@ -269,14 +661,28 @@ static int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int
 		}
 
 		std::string var(withVars, varStart + 2, varEnd - (varStart + 2));
-		std::string val = props.Evaluate(var);
+		std::string val;
+		use.Add(var);
 
 		if (blankVars.contains(var)) {
-			val.clear(); // treat blankVar as an empty string (e.g. to block self-reference)
-		}
-
-		if (--maxExpands >= 0) {
-			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var, &blankVars));
+			// treat blankVar as an empty string (e.g. to block self-reference)
+			--maxExpands;
+		} else if (var.find(' ') == std::string::npos) {
+			if (--maxExpands >= 0) {
+				maxExpands = ExpandVariable(var, val, maxExpands, blankVars, use);
+			} else {
+				val = Get(var);
+			}
+		} else {
+			if (StartsWith(var, "escape ")) {
+				use.Add(var.substr(7));
+			} else if (!StartsWith(var, "= ")) {
+				use.cacheable = false;
+			}
+			val = Evaluate(var);
+			if (--maxExpands >= 0) {
+				maxExpands = ExpandAllInPlace(val, maxExpands, VarChain(var, &blankVars), use);
+			}
 		}
 
 		withVars.erase(varStart, varEnd-varStart+1);
@@ -288,15 +694,57 @@ static int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int
 	return maxExpands;
 }
 
+// Expand the value of var, reusing an earlier expansion when it did not reference any
+// of blankVars and used fewer than maxExpands expansions so would be the same here.
+
+int PropSetFile::ExpandVariable(std::string_view var, std::string &val, int maxExpands, const VarChain &blankVars, ExpansionUse &use) const {
+	PropSetLookups &current = Lookups();
+	const auto it = current.expansions.find(var);
+	if (it != current.expansions.end()) {
+		const PropSetLookups::Expansion &expansion = it->second;
+		if ((maxExpands - expansion.expansions >= 1) && !AnyBlanked(expansion.variables, blankVars)) {
+			val = expansion.value;
+			use.Add(expansion.variables);
+			return maxExpands - expansion.expansions;
+		}
+	}
+
+	val = Get(var);
+	ExpansionUse useVar;
+	useVar.Add(var);
+	const int remaining = ExpandAllInPlace(val, maxExpands, VarChain(var, &blankVars), useVar);
+	// Only keep complete expansions that would be the same in any other context
+	if (useVar.cacheable && (remaining >= 1) && !AnyBlanked(useVar.variables, blankVars)) {
+		for (const std::string &variable : useVar.variables) {
+			current.dependents[variable].emplace(var);
+		}
+		current.expansions.insert_or_assign(std::string(var),
+			PropSetLookups::Expansion{val, useVar.variables, maxExpands - remaining});
+	}
+	use.Add(useVar);
+	return remaining;
+}
+
 std::string PropSetFile::GetExpandedString(std::string_view key) const {
-	std::string val(Get(key));
-	ExpandAllInPlace(*this, val, 200, VarChain(key));
+	LookupCounter counter(Lookup::expand, key);
+	if (counter.Counting()) {
+		std::string_view value;
+		Find(key, value, &counter.depth);
+	}
+	std::string val;
+	ExpansionUse use;
+	ExpandVariable(key, val, 200, VarChain(), use);
 	return val;
 }
 
 std::string PropSetFile::Expand(std::string_view withVars, int maxExpands) const {
+	LookupCounter counter(Lookup::expand, withVars);
+	if (counter.Counting()) {
+		counter.depth = Lookups().chain.size();
+	}
 	std::string val(withVars);
-	ExpandAllInPlace(*this, val, maxExpands);
+	ExpansionUse use;
+	ExpandAllInPlace(val, maxExpands, VarChain(), use);
 	return val;
 }
 
@@ -359,7 +807,10 @@ void PropSetFile::Import(const FilePath &filename, const FilePath &directoryForI
 			 FilePathSet *imports, size_t depth) {
 	if (depth > 20)	// Possibly recursive import so give up to avoid crash
 		return;
-	if (Read(filename, directoryForImports, filter, imports, depth)) {
+	const bool read = filter.lazy ?
+		ReadDeferred(filename, directoryForImports, filter, depth) :
+		Read(filename, directoryForImports, filter, imports, depth);
+	if (read) {
 		if (imports && (std::find(imports->begin(), imports->end(), filename) == imports->end())) {
 			imports->push_back(filename);
 		}
@@ -406,6 +857,9 @@ PropSetFile::ReadLineState PropSetFile::ReadLine(const std::string &lineBuffer,
 		if (directoryForImports.IsSet()) {
 			std::string importName = lineBuffer.substr(strlen("import") + 1);
 			if (importName == "*") {
+				if (record) {
+					record->directories.push_back(directoryForImports);
+				}
 				// Import all .properties files in this directory except for system properties
 				FilePathSet directories;
 				FilePathSet files;
@@ -449,6 +903,10 @@ void PropSetFile::ReadFromMemory(std::string_view data, const FilePath &director
 
 bool PropSetFile::Read(const FilePath &filename, const FilePath &directoryForImports,
 		       const ImportFilter &filter, FilePathSet *imports, size_t depth) {
+	const PhaseTimer timer("Read", PhaseProfile::Startup().Recording() ? filename.AsUTF8() : std::string());
+	if (record) {
+		record->files.push_back(filename);
+	}
 	const std::string propsData = filename.Read();
 	if (!propsData.empty()) {
 		std::string_view data(propsData);
@@ -462,6 +920,91 @@ bool PropSetFile::Read(const FilePath &filename, const FilePath &directoryForImp
 	return false;
 }
 
+bool PropSetFile::ReadDeferred(const FilePath &filename, const FilePath &directoryForImports,
+			       const ImportFilter &filter, size_t depth) {
+	if (record) {
+		// Files read later are not recorded
+		record->complete = false;
+	}
+	if (!lazy) {
+		lazy = std::make_unique<PropSetLazy>();
+	}
+	PropSetLazy::File file{ filename, directoryForImports, filter, depth, ++lazy->ordinal, {}, {} };
+	// Files imported by the file are read in full along with it
+	file.filter.lazy = false;
+	lazy->files.push_back(file);
+	lazy->scanning = true;
+	const bool read = Read(filename, directoryForImports, file.filter, nullptr, depth);
+	lazy->scanning = false;
+	// Lines after this import come after the file
+	++lazy->ordinal;
+	if (!read) {
+		lazy->files.pop_back();
+	} else if (lazy->files.back().lexers.empty() || lazy->Uses(lazy->files.back())) {
+		// Nothing would cause the file to be read later or its keys are already used so read it now
+		ReadLazyFile(lazy->files.size() - 1);
+		ReadReferenced();
+	}
+	return read;
+}
+
+void PropSetFile::ReadLazyFile(size_t index) {
+	const PropSetLazy::File file = lazy->files[index];
+	lazy->files.erase(lazy->files.begin() + index);
+	lazy->reading = file.ordinal;
+	Read(file.filename, file.directoryForImports, file.filter, nullptr, file.depth);
+	lazy->reading = 0;
+}
+
+void PropSetFile::ReadReferenced() {
+	// Values read may use variables set by lazily imported files, such as html.properties
+	// using keywordclass.python, so read those files which may use further variables.
+	while (true) {
+		std::vector<std::string> variables;
+		for (PropSetFile *psf = this; psf; psf = psf->superPS) {
+			if (psf->lazy) {
+				std::move(psf->lazy->pending.begin(), psf->lazy->pending.end(), std::back_inserter(variables));
+				psf->lazy->pending.clear();
+			}
+		}
+		if (variables.empty()) {
+			return;
+		}
+		for (PropSetFile *psf = this; psf; psf = psf->superPS) {
+			if (!psf->lazy) {
+				continue;
+			}
+			for (size_t i = 0; i < psf->lazy->files.size();) {
+				const std::set<std::string, std::less<>> &keys = psf->lazy->files[i].keys;
+				if (std::any_of(variables.begin(), variables.end(), [&keys](const std::string &var) {
+					return keys.contains(var);
+				})) {
+					psf->ReadLazyFile(i);
+				} else {
+					i++;
+				}
+			}
+		}
+	}
+}
+
+void PropSetFile::ReadLanguage(std::string_view lexer) {
+	for (PropSetFile *psf = this; psf; psf = psf->superPS) {
+		if (!psf->lazy) {
+			continue;
+		}
+		for (size_t i = 0; i < psf->lazy->files.size();) {
+			const std::vector<std::string> &lexers = psf->lazy->files[i].lexers;
+			if (std::find(lexers.begin(), lexers.end(), lexer) != lexers.end()) {
+				psf->ReadLazyFile(i);
+			} else {
+				i++;
+			}
+		}
+	}
+	ReadReferenced();
+}
+
 namespace {
 
 bool StringEqual(std::string_view a, std::string_view b, bool caseSensitive) noexcept {
@@ -509,58 +1052,106 @@ bool MatchWild(std::string_view pattern, std::string_view text, bool caseSensiti
 	return false;
 }
 
-bool MatchWildSet(std::string_view patternSet, std::string_view text, bool caseSensitive) {
+std::string Folded(std::string_view text, bool caseSensitive) {
+	std::string folded(text);
+	if (!caseSensitive) {
+		std::transform(folded.begin(), folded.end(), folded.begin(), MakeUpperCase);
+	}
+	return folded;
+}
+
+}
+
+void PropSetLookups::WildIndex::Add(std::string_view patternSet, size_t value) {
+	// Patterns are separated by ';'
 	while (!patternSet.empty()) {
 		const size_t sepPos = patternSet.find_first_of(';');
 		const std::string_view pattern = patternSet.substr(0, sepPos);
-		if (MatchWild(pattern, text, caseSensitive)) {
-			return true;
+		const size_t wildPos = pattern.find_first_of("*?");
+		if (pattern == "*") {
+			always = std::min(always, value);
+		} else if (wildPos == std::string_view::npos) {
+			names.emplace(Folded(pattern, caseSensitive), value);
+		} else if (wildPos == 0 && pattern[0] == '*' && (pattern.length() > 1) && (pattern[1] == '.') &&
+			(pattern.find_first_of("*?", 1) == std::string_view::npos)) {
+			extensions.emplace(Folded(pattern.substr(1), caseSensitive), value);
+		} else {
+			globs.emplace_back(pattern, value);
 		}
-		// Move to next
 		patternSet = (sepPos == std::string_view::npos) ? "" : patternSet.substr(sepPos + 1);
 	}
-	return false;
 }
 
+size_t PropSetLookups::WildIndex::Match(std::string_view filename) const {
+	size_t best = always;
+	const std::string name = Folded(filename, caseSensitive);
+	const auto itName = names.find(name);
+	if (itName != names.end()) {
+		best = std::min(best, itName->second);
+	}
+	if (!extensions.empty()) {
+		for (size_t dot = name.find('.'); dot != std::string::npos; dot = name.find('.', dot + 1)) {
+			const auto itExtension = extensions.find(std::string_view(name).substr(dot));
+			if (itExtension != extensions.end()) {
+				best = std::min(best, itExtension->second);
+			}
+		}
+	}
+	for (const auto &[pattern, value] : globs) {
+		if (value >= best) {
+			break;
+		}
+		if (MatchWild(pattern, filename, caseSensitive)) {
+			return value;
+		}
+	}
+	return best;
 }
 
-std::string_view PropSetFile::GetWildUsingStart(const PropSetFile &psStart, std::string_view keybase, std::string_view filename) const {
-	const PropSetFile *psf = this;
-	while (psf) {
-		mapss::const_iterator it = psf->props.lower_bound(keybase);
-		while ((it != psf->props.end()) && StartsWith(it->first, keybase)) {
-			if (it->first == keybase) {
-				return it->second;
-			}
-			const std::string_view first = it->first;
-			const std::string_view orgkeyfile = first.substr(keybase.length());
-			std::string key;	// keyFile may point into key so key lifetime must cover keyFile
-			std::string_view keyFile = orgkeyfile;
-
-			if (StartsWith(orgkeyfile, "$(")) {
-				// $(X) is a variable so extract X and find its value
-				const size_t endVar = orgkeyfile.find_first_of(')');
+std::string_view PropSetFile::GetWild(std::string_view keybase, std::string_view filename) const {
+	LookupCounter counter(Lookup::wild, keybase);
+	PropSetLookups &current = Lookups();
+	counter.depth = current.chain.size();
+	auto it = current.wilds.find(keybase);
+	if ((it != current.wilds.end()) && (it->second.caseSensitive == caseSensitiveFilenames)) {
+		const size_t value = it->second.Match(filename);
+		return (value < it->second.values.size()) ? it->second.values[value] : "";
+	}
+
+	PropSetLookups::WildIndex index(caseSensitiveFilenames);
+	ExpansionUse use;
+	for (const PropSetFile *psf = this; psf; psf = psf->superPS) {
+		mapss::const_iterator itKey = psf->props.lower_bound(keybase);
+		while ((itKey != psf->props.end()) && StartsWith(itKey->first, keybase)) {
+			const size_t value = index.values.size();
+			index.values.push_back(itKey->second);
+			const std::string_view orgkeyfile = std::string_view(itKey->first).substr(keybase.length());
+			if (orgkeyfile.empty()) {
+				index.always = std::min(index.always, value);
+			} else {
+				const size_t endVar = StartsWith(orgkeyfile, "$(") ? orgkeyfile.find_first_of(')') : std::string_view::npos;
 				if (endVar != std::string_view::npos) {
+					// $(X) is a variable so extract X and find its value
 					const std::string_view var = orgkeyfile.substr(2, endVar-2);
-					key = psStart.GetExpandedString(var);
-					keyFile = key;
+					std::string keyFile;
+					ExpandVariable(var, keyFile, 200, VarChain(), use);
+					index.Add(keyFile, value);
+				} else {
+					index.Add(orgkeyfile, value);
 				}
 			}
-
-			if (MatchWildSet(keyFile, filename, caseSensitiveFilenames)) {
-				return it->second;
-			}
-
-			++it;
+			++itKey;
 		}
-		// Failed here, so try in base property set
-		psf = psf->superPS;
+		// Then try in base property set
 	}
-	return "";
-}
+	index.variables = std::move(use.variables);
 
-std::string_view PropSetFile::GetWild(std::string_view keybase, std::string_view filename) const {
-	return GetWildUsingStart(*this, keybase, filename);
+	const size_t value = index.Match(filename);
+	const std::string_view result = (value < index.values.size()) ? index.values[value] : "";
+	if (use.cacheable) {
+		current.wilds.insert_or_assign(std::string(keybase), std::move(index));
+	}
+	return result;
 }
 
 // GetNewExpandString does not use Expand as it has to use GetWild with the filename for each
@@ -617,6 +1208,28 @@ bool PropSetFile::GetNext(const char *&key, const char *&val) const {
 	return false;
 }
 
+void PropSetFile::SetStatistics(bool enable) {
+	if (enable && !statisticsEnabled) {
+		for (std::map<std::string, LookupCount, std::less<>> &counts : statistics) {
+			counts.clear();
+		}
+	}
+	statisticsEnabled = enable;
+}
+
+std::vector<PropSetStatistic> PropSetFile::Statistics() {
+	std::vector<PropSetStatistic> result;
+	for (size_t lookup = 0; lookup < std::size(lookupNames); lookup++) {
+		for (const auto &[key, count] : statistics[lookup]) {
+			result.push_back({ lookupNames[lookup], key, count.calls, count.depth, count.seconds });
+		}
+	}
+	std::stable_sort(result.begin(), result.end(), [](const PropSetStatistic &a, const PropSetStatistic &b) noexcept {
+		return a.seconds > b.seconds;
+	});
+	return result;
+}
+
 bool IsPropertiesFile(const FilePath &filename) {
 	const FilePath ext = filename.Extension();
 	return EqualCaseInsensitive(ext.AsUTF8(), extensionProperties + 1);
@@ -17,18 +17,75 @@ class ImportFilter {
 public:
 	std::set<std::string> excludes;
 	std::set<std::string> includes;
+	// Imported files are only read in full once one of their lexers is used
+	bool lazy = false;
 	void SetFilter(const std::string &sExcludes, const std::string &sIncludes);
 	bool IsValid(const std::string &name) const;
 };
 
+/**
+ * What reading property files depended on apart from the contents of the files so the
+ * result can be reused while none of it changes.
+ */
+struct PropSetReadRecord {
+	// Every file read or tried, including those that were missing
+	FilePathSet files;
+	// Directories listed by "import *"
+	FilePathSet directories;
+	// Values found in base sets
+	std::map<std::string, std::string, std::less<>> inherited;
+	// Cleared when reading depended on something not recorded
+	bool complete = true;
+};
+
+/**
+ * Lookups of one key through one operation counted while statistics are enabled.
+ */
+struct PropSetStatistic {
+	std::string operation;
+	std::string key;
+	size_t calls = 0;
+	// Total number of property sets searched
+	size_t depth = 0;
+	double seconds = 0.0;
+};
+
+struct PropSetLookups;
+struct PropSetLazy;
+struct VarChain;
+struct ExpansionUse;
+
 class PropSetFile {
 	bool lowerKeys;
-	std::string_view GetWildUsingStart(const PropSetFile &psStart, std::string_view keybase, std::string_view filename) const;
 	static bool caseSensitiveFilenames;
 	mapss props;
+	// Given a new value from a counter shared by all sets whenever props changes, including
+	// by copying or moving, so that a set's address and version identify its contents.
+	unsigned long long version;
+	// Results of Get through this set and its base sets, created when first needed.
+	mutable std::unique_ptr<PropSetLookups> lookups;
+	PropSetReadRecord *record = nullptr;
+	// Files imported lazily that may still need to be read
+	std::unique_ptr<PropSetLazy> lazy;
+	void Changed(std::string_view key);
+	void ReadLazyFile(size_t index);
+	void ReadReferenced();
+	PropSetLookups &Lookups() const;
+	bool Find(std::string_view key, std::string_view &value, size_t *depth=nullptr) const;
+	int ExpandAllInPlace(std::string &withVars, int maxExpands, const VarChain &blankVars, ExpansionUse &use) const;
+	int ExpandVariable(std::string_view var, std::string &val, int maxExpands, const VarChain &blankVars, ExpansionUse &use) const;
 public:
 	PropSetFile *superPS;
 	explicit PropSetFile(bool lowerKeys_=false);
+	// The lookups refer into the maps of the original so are not copied.
+	PropSetFile(const PropSetFile &other);
+	PropSetFile(PropSetFile &&other) noexcept;
+	PropSetFile &operator=(const PropSetFile &other);
+	PropSetFile &operator=(PropSetFile &&other) noexcept;
+	~PropSetFile();
+
+	/// While set, reading and lookups note what they depend on in record_.
+	void SetRecord(PropSetReadRecord *record_) noexcept;
 
 	void Set(std::string_view key, std::string_view val);
 	void SetPath(std::string_view key, const FilePath &path);
@@ -55,6 +112,10 @@ public:
 		    FilePathSet *imports, size_t depth);
 	bool Read(const FilePath &filename, const FilePath &directoryForImports, const ImportFilter &filter,
 		  FilePathSet *imports, size_t depth);
+	bool ReadDeferred(const FilePath &filename, const FilePath &directoryForImports, const ImportFilter &filter,
+			  size_t depth);
+	/// Read any lazily imported files, in this set and its base sets, that use lexer.
+	void ReadLanguage(std::string_view lexer);
 	std::string_view GetWild(std::string_view keybase, std::string_view filename) const;
 	std::string GetNewExpandString(std::string_view keybase, std::string_view filename = "") const;
 	bool GetFirst(const char *&key, const char *&val) const;
@@ -62,6 +123,11 @@ public:
 	static void SetCaseSensitiveFilenames(bool caseSensitiveFilenames_) noexcept {
 		caseSensitiveFilenames = caseSensitiveFilenames_;
 	}
+	/// Count the calls, sets searched and time taken by Get, GetWild and Expand for each key
+	/// in all sets. Turning statistics on discards earlier counts.
+	static void SetStatistics(bool enable);
+	/// The counts so far with the most time first.
+	static std::vector<PropSetStatistic> Statistics();
 };
 
 constexpr const char *extensionProperties = ".properties";
@@ -0,0 +1,250 @@
+// SciTE - Scintilla based Text Editor
+/** @file PropSetSnapshot.cxx
+ ** Save property sets after reading so later runs can load them without parsing.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <chrono>
+
+#include "GUI.h"
+
+#include "FilePath.h"
+#include "PropSetFile.h"
+#include "PropSetSnapshot.h"
+
+namespace {
+
+// Changed when the layout of the snapshot file changes.
+constexpr uint32_t snapshotVersion = 1;
+constexpr std::string_view snapshotMagic = "SciTEPrp";
+
+// Missing files have a time and length of -1.
+void FileState(const FilePath &path, long long &modified, long long &length) noexcept {
+	time_t modifiedTime = 0;
+	long long lengthFile = 0;
+	if (path.GetModifiedTimeAndLength(modifiedTime, lengthFile)) {
+		modified = modifiedTime;
+		length = lengthFile;
+	} else {
+		modified = -1;
+		length = -1;
+	}
+}
+
+FilePath PathFromUTF8(std::string_view path) {
+	return FilePath(GUI::StringFromUTF8(std::string(path)));
+}
+
+// Directories are compared by the properties files they contain as their times change
+// whenever any file is written, possibly even the snapshot.
+std::string PropertiesFilesIn(const FilePath &directory) {
+	FilePathSet directories;
+	FilePathSet files;
+	directory.List(directories, files);
+	std::string names;
+	for (const FilePath &file : files) {
+		if (IsPropertiesFile(file)) {
+			names += file.Name().AsUTF8();
+			names += '\n';
+		}
+	}
+	return names;
+}
+
+}
+
+PropSetSnapshot::PropSetSnapshot(const FilePath &file_) : file(file_) {
+}
+
+bool PropSetSnapshot::Load(std::string_view configuration, const std::vector<PropSetFile *> &sets, FilePathSet &imports) const {
+	FileHolder fp(file.Open(fileRead));
+	if (!fp) {
+		return false;
+	}
+	const MappedFile mapped(fp.get(), 0);
+	std::string contents;
+	if (!mapped.Mapped()) {
+		contents = file.Read();
+	}
+	BinaryReader reader(mapped.Mapped() ? mapped.Contents() : std::string_view(contents));
+
+	std::string_view magic;
+	uint32_t version = 0;
+	std::string_view configurationSaved;
+	if (!reader.Bytes(snapshotMagic.length(), magic) || (magic != snapshotMagic) ||
+		!reader.U32(version) || (version != snapshotVersion) ||
+		!reader.String(configurationSaved) || (configurationSaved != configuration)) {
+		return false;
+	}
+
+	uint32_t countFiles = 0;
+	if (!reader.U32(countFiles)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < countFiles; i++) {
+		std::string_view path;
+		long long modifiedSaved = 0;
+		long long lengthSaved = 0;
+		if (!reader.String(path) || !reader.I64(modifiedSaved) || !reader.I64(lengthSaved)) {
+			return false;
+		}
+		long long modified = 0;
+		long long length = 0;
+		FileState(PathFromUTF8(path), modified, length);
+		if ((modified != modifiedSaved) || (length != lengthSaved)) {
+			return false;
+		}
+	}
+
+	uint32_t countDirectories = 0;
+	if (!reader.U32(countDirectories)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < countDirectories; i++) {
+		std::string_view path;
+		std::string_view names;
+		if (!reader.String(path) || !reader.String(names) ||
+			(PropertiesFilesIn(PathFromUTF8(path)) != names)) {
+			return false;
+		}
+	}
+
+	uint32_t countImports = 0;
+	if (!reader.U32(countImports)) {
+		return false;
+	}
+	FilePathSet importsSaved;
+	for (uint32_t i = 0; i < countImports; i++) {
+		std::string_view path;
+		if (!reader.String(path)) {
+			return false;
+		}
+		importsSaved.push_back(PathFromUTF8(path));
+	}
+
+	uint32_t countSets = 0;
+	if (!reader.U32(countSets) || (countSets != sets.size())) {
+		return false;
+	}
+	for (PropSetFile *set : sets) {
+		set->Clear();
+		uint32_t countInherited = 0;
+		if (!reader.U32(countInherited)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < countInherited; i++) {
+			std::string_view key;
+			std::string_view value;
+			if (!reader.String(key) || !reader.String(value) || (set->Get(key) != value)) {
+				return false;
+			}
+		}
+		uint32_t countProperties = 0;
+		if (!reader.U32(countProperties)) {
+			return false;
+		}
+		for (uint32_t i = 0; i < countProperties; i++) {
+			std::string_view key;
+			std::string_view value;
+			if (!reader.String(key) || !reader.String(value)) {
+				return false;
+			}
+			set->Set(key, value);
+		}
+	}
+	if (!reader.AtEnd()) {
+		return false;
+	}
+	imports = std::move(importsSaved);
+	return true;
+}
+
+bool PropSetSnapshot::Save(std::string_view configuration, const std::vector<const PropSetFile *> &sets,
+			   const std::vector<PropSetReadRecord> &records, const FilePathSet &imports) const {
+	if (sets.size() != records.size()) {
+		return false;
+	}
+	const time_t now = time(nullptr);
+
+	std::string data(snapshotMagic);
+	AppendU32(data, snapshotVersion);
+	AppendString(data, configuration);
+
+	size_t countFiles = 0;
+	size_t countDirectories = 0;
+	for (const PropSetReadRecord &record : records) {
+		if (!record.complete) {
+			return false;
+		}
+		countFiles += record.files.size();
+		countDirectories += record.directories.size();
+	}
+	AppendU32(data, static_cast<uint32_t>(countFiles));
+	for (const PropSetReadRecord &record : records) {
+		for (const FilePath &path : record.files) {
+			long long modified = 0;
+			long long length = 0;
+			FileState(path, modified, length);
+			if (Unsettled(modified, now)) {
+				return false;
+			}
+			AppendString(data, path.AsUTF8());
+			AppendI64(data, modified);
+			AppendI64(data, length);
+		}
+	}
+	AppendU32(data, static_cast<uint32_t>(countDirectories));
+	for (const PropSetReadRecord &record : records) {
+		for (const FilePath &path : record.directories) {
+			AppendString(data, path.AsUTF8());
+			AppendString(data, PropertiesFilesIn(path));
+		}
+	}
+
+	AppendU32(data, static_cast<uint32_t>(imports.size()));
+	for (const FilePath &path : imports) {
+		AppendString(data, path.AsUTF8());
+	}
+
+	AppendU32(data, static_cast<uint32_t>(sets.size()));
+	for (size_t set = 0; set < sets.size(); set++) {
+		AppendU32(data, static_cast<uint32_t>(records[set].inherited.size()));
+		for (const auto &[key, value] : records[set].inherited) {
+			AppendString(data, key);
+			AppendString(data, value);
+		}
+		const size_t countPosition = data.length();
+		AppendU32(data, 0);
+		uint32_t countProperties = 0;
+		const char *key = nullptr;
+		const char *value = nullptr;
+		bool more = sets[set]->GetFirst(key, value);
+		while (more) {
+			AppendString(data, key);
+			AppendString(data, value);
+			countProperties++;
+			more = sets[set]->GetNext(key, value);
+		}
+		memcpy(data.data() + countPosition, &countProperties, sizeof(countProperties));
+	}
+
+	// Load in another instance may have the file mapped
+	return WriteReplacing(file, data);
+}
+
+void PropSetSnapshot::Remove() const noexcept {
+	file.Remove();
+}
@@ -0,0 +1,33 @@
+// SciTE - Scintilla based Text Editor
+/** @file PropSetSnapshot.h
+ ** Save property sets after reading so later runs can load them without parsing.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef PROPSETSNAPSHOT_H
+#define PROPSETSNAPSHOT_H
+
+/**
+ * A file holding the contents of property sets read from properties files along with the
+ * imported files and what reading them depended on.
+ * Loading succeeds only when the configuration string matches, every file recorded has
+ * the same modification time and length, every directory imported with "import *" has
+ * the same properties files and each base set still provides the values that were
+ * inherited while reading.
+ */
+class PropSetSnapshot {
+	FilePath file;
+public:
+	explicit PropSetSnapshot(const FilePath &file_);
+	/// Clear and fill sets in order along with imports. The base sets of each set must be
+	/// complete before loading it. When false is returned the sets should be read normally.
+	bool Load(std::string_view configuration, const std::vector<PropSetFile *> &sets, FilePathSet &imports) const;
+	/// Each set has the record made while reading it. Nothing is saved when a record is
+	/// incomplete or a file is so recent that it may change without its time changing.
+	bool Save(std::string_view configuration, const std::vector<const PropSetFile *> &sets,
+		  const std::vector<PropSetReadRecord> &records, const FilePathSet &imports) const;
+	void Remove() const noexcept;
+};
+
+#endif
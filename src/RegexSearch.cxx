@@ -0,0 +1,708 @@
+// SciTE - Scintilla based Text Editor
+/** @file RegexSearch.cxx
+ ** Find lines matching a regular expression with a lazily built automaton.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <bitset>
+#include <map>
+#include <algorithm>
+#include <memory>
+
+#include "SubstringSearch.h"
+#include "RegexSearch.h"
+
+namespace {
+
+using Assertion = RegexProgram::Assertion;
+using ByteSet = std::bitset<256>;
+
+constexpr bool IsASCIIWordCharacter(int ch) noexcept {
+	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || (ch == '_');
+}
+
+ByteSet WordCharacters(std::string_view wordCharacters) noexcept {
+	ByteSet set;
+	if (wordCharacters.empty()) {
+		for (int i = 0; i < 256; i++) {
+			set[i] = IsASCIIWordCharacter(i);
+		}
+	} else {
+		for (const char ch : wordCharacters) {
+			set.set(static_cast<unsigned char>(ch));
+		}
+	}
+	return set;
+}
+
+constexpr bool IsLineEnd(int ch) noexcept {
+	return ch == '\r' || ch == '\n';
+}
+
+constexpr int HexValue(char ch) noexcept {
+	if (ch >= '0' && ch <= '9') {
+		return ch - '0';
+	} else if (ch >= 'A' && ch <= 'F') {
+		return ch - 'A' + 10;
+	} else if (ch >= 'a' && ch <= 'f') {
+		return ch - 'a' + 10;
+	}
+	return -1;
+}
+
+// Parsed form of a regular expression before it is turned into instructions.
+struct Node {
+	enum class Kind { empty, bytes, assertion, concatenation, alternation, repeat };
+	Kind kind = Kind::empty;
+	ByteSet set;
+	Assertion assertion = Assertion::lineStart;
+	// Repeats are ?, * or + so may be optional and may be unbounded.
+	bool optional = false;
+	bool unbounded = false;
+	std::vector<std::unique_ptr<Node>> children;
+	explicit Node(Kind kind_) noexcept : kind(kind_) {
+	}
+};
+
+using NodePtr = std::unique_ptr<Node>;
+
+NodePtr MakeAssertion(Assertion assertion) {
+	NodePtr node = std::make_unique<Node>(Node::Kind::assertion);
+	node->assertion = assertion;
+	return node;
+}
+
+class Parser {
+	std::string_view pattern;
+	size_t position = 0;
+	bool matchCase;
+	bool posix;
+	const ByteSet &wordCharacters;
+	int depth = 0;
+	static constexpr int maximumDepth = 100;
+
+	bool AtEnd() const noexcept {
+		return position >= pattern.length();
+	}
+	bool IsOpen() const noexcept;
+	bool IsClose() const noexcept;
+	bool IsAlternation() const noexcept;
+	bool AtSequenceEnd() const noexcept {
+		return AtEnd() || IsClose() || IsAlternation();
+	}
+	void Fold(ByteSet &set) const noexcept;
+	bool EscapeClass(char ch, ByteSet &set) const;
+	int EscapeCharacter();
+	NodePtr ParseSet();
+	NodePtr ParseAtom(bool sequenceStart);
+	NodePtr ParseSequence();
+	NodePtr ParseAlternation();
+public:
+	std::string error;
+	Parser(std::string_view pattern_, bool matchCase_, bool posix_, const ByteSet &wordCharacters_) noexcept :
+		pattern(pattern_), matchCase(matchCase_), posix(posix_), wordCharacters(wordCharacters_) {
+	}
+	NodePtr Parse();
+};
+
+bool Parser::IsOpen() const noexcept {
+	if (posix) {
+		return pattern[position] == '(';
+	}
+	return (pattern[position] == '\\') && (position + 1 < pattern.length()) && (pattern[position + 1] == '(');
+}
+
+bool Parser::IsClose() const noexcept {
+	if (posix) {
+		return pattern[position] == ')';
+	}
+	return (pattern[position] == '\\') && (position + 1 < pattern.length()) && (pattern[position + 1] == ')');
+}
+
+bool Parser::IsAlternation() const noexcept {
+	if (posix) {
+		return pattern[position] == '|';
+	}
+	return (pattern[position] == '\\') && (position + 1 < pattern.length()) && (pattern[position + 1] == '|');
+}
+
+void Parser::Fold(ByteSet &set) const noexcept {
+	if (!matchCase) {
+		for (int ch = 'A'; ch <= 'Z'; ch++) {
+			const int lower = ch - 'A' + 'a';
+			if (set[ch] || set[lower]) {
+				set.set(ch);
+				set.set(lower);
+			}
+		}
+	}
+}
+
+// Add the bytes of a class like \d to set, returning false if ch is not a class.
+bool Parser::EscapeClass(char ch, ByteSet &set) const {
+	ByteSet members;
+	switch (ch) {
+	case 'd':
+	case 'D':
+		for (int i = '0'; i <= '9'; i++) {
+			members.set(i);
+		}
+		break;
+	case 's':
+	case 'S':
+		for (const int i : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+			members.set(i);
+		}
+		break;
+	case 'w':
+	case 'W':
+		members = wordCharacters;
+		break;
+	default:
+		return false;
+	}
+	if (ch == 'D' || ch == 'S' || ch == 'W') {
+		members.flip();
+	}
+	set |= members;
+	return true;
+}
+
+// Called after a '\' that is not a class, group, alternation or assertion.
+int Parser::EscapeCharacter() {
+	const char ch = pattern[position++];
+	switch (ch) {
+	case 'a':
+		return '\a';
+	case 'b':
+		return '\b';
+	case 'f':
+		return '\f';
+	case 'n':
+		return '\n';
+	case 'r':
+		return '\r';
+	case 't':
+		return '\t';
+	case 'v':
+		return '\v';
+	case 'x': {
+			// Up to 2 hexadecimal digits otherwise a literal 'x'
+			int value = 0;
+			int digits = 0;
+			while ((digits < 2) && !AtEnd() && (HexValue(pattern[position]) >= 0)) {
+				value = value * 16 + HexValue(pattern[position]);
+				position++;
+				digits++;
+			}
+			return digits ? value : 'x';
+		}
+	default:
+		return static_cast<unsigned char>(ch);
+	}
+}
+
+NodePtr Parser::ParseSet() {
+	// position is just after '['
+	NodePtr node = std::make_unique<Node>(Node::Kind::bytes);
+	bool negate = false;
+	if (!AtEnd() && pattern[position] == '^') {
+		negate = true;
+		position++;
+	}
+	bool first = true;
+	int previous = -1;
+	while (!AtEnd() && (first || (pattern[position] != ']'))) {
+		first = false;
+		int ch = static_cast<unsigned char>(pattern[position++]);
+		if (ch == '\\' && !AtEnd()) {
+			if (EscapeClass(pattern[position], node->set)) {
+				position++;
+				previous = -1;
+				continue;
+			}
+			ch = EscapeCharacter();
+		} else if ((ch == '-') && (previous >= 0) && !AtEnd() && (pattern[position] != ']')) {
+			int last = static_cast<unsigned char>(pattern[position++]);
+			if (last == '\\' && !AtEnd()) {
+				last = EscapeCharacter();
+			}
+			if (last < previous) {
+				error = "Bad range in []";
+				return {};
+			}
+			for (int i = previous; i <= last; i++) {
+				node->set.set(i);
+			}
+			previous = -1;
+			continue;
+		}
+		node->set.set(ch);
+		previous = ch;
+	}
+	if (AtEnd()) {
+		error = "Missing ]";
+		return {};
+	}
+	position++;	// Skip ']'
+	Fold(node->set);
+	if (negate) {
+		node->set.flip();
+	}
+	return node;
+}
+
+NodePtr Parser::ParseAtom(bool sequenceStart) {
+	if (IsOpen()) {
+		position += posix ? 1 : 2;
+		if (++depth > maximumDepth) {
+			error = "Too many groups";
+			return {};
+		}
+		NodePtr inner = ParseAlternation();
+		depth--;
+		if (!inner) {
+			return {};
+		}
+		if (AtEnd() || !IsClose()) {
+			error = "Unmatched (";
+			return {};
+		}
+		position += posix ? 1 : 2;
+		return inner;
+	}
+	const char ch = pattern[position++];
+	if ((ch == '^') && sequenceStart) {
+		return MakeAssertion(Assertion::lineStart);
+	}
+	if ((ch == '$') && AtSequenceEnd()) {
+		return MakeAssertion(Assertion::lineEnd);
+	}
+	NodePtr node = std::make_unique<Node>(Node::Kind::bytes);
+	if (ch == '.') {
+		node->set.set();
+		node->set.reset('\r');
+		node->set.reset('\n');
+		return node;
+	}
+	if (ch == '[') {
+		return ParseSet();
+	}
+	if ((ch == '\\') && !AtEnd()) {
+		const char escaped = pattern[position];
+		if (escaped == '<') {
+			position++;
+			return MakeAssertion(Assertion::wordStart);
+		}
+		if (escaped == '>') {
+			position++;
+			return MakeAssertion(Assertion::wordEnd);
+		}
+		if (escaped >= '1' && escaped <= '9') {
+			error = "Back references are not supported";
+			return {};
+		}
+		if (EscapeClass(escaped, node->set)) {
+			position++;
+			return node;
+		}
+		node->set.set(EscapeCharacter());
+	} else {
+		node->set.set(static_cast<unsigned char>(ch));
+	}
+	Fold(node->set);
+	return node;
+}
+
+NodePtr Parser::ParseSequence() {
+	NodePtr sequence = std::make_unique<Node>(Node::Kind::concatenation);
+	while (!AtSequenceEnd()) {
+		const char ch = pattern[position];
+		const bool sequenceStart = sequence->children.empty();
+		if (!sequenceStart && (ch == '*' || ch == '+' || ch == '?')) {
+			position++;
+			NodePtr &operand = sequence->children.back();
+			if (operand->kind == Node::Kind::assertion) {
+				error = "Illegal closure";
+				return {};
+			}
+			NodePtr repeat = std::make_unique<Node>(Node::Kind::repeat);
+			repeat->optional = ch != '+';
+			repeat->unbounded = ch != '?';
+			repeat->children.push_back(std::move(operand));
+			operand = std::move(repeat);
+			continue;
+		}
+		NodePtr atom = ParseAtom(sequenceStart);
+		if (!atom) {
+			return {};
+		}
+		sequence->children.push_back(std::move(atom));
+	}
+	return sequence;
+}
+
+NodePtr Parser::ParseAlternation() {
+	NodePtr first = ParseSequence();
+	if (!first || AtEnd() || !IsAlternation()) {
+		return first;
+	}
+	NodePtr alternation = std::make_unique<Node>(Node::Kind::alternation);
+	alternation->children.push_back(std::move(first));
+	while (!AtEnd() && IsAlternation()) {
+		position += posix ? 1 : 2;
+		NodePtr option = ParseSequence();
+		if (!option) {
+			return {};
+		}
+		alternation->children.push_back(std::move(option));
+	}
+	return alternation;
+}
+
+NodePtr Parser::Parse() {
+	NodePtr root = ParseAlternation();
+	if (root && !AtEnd()) {
+		error = "Unmatched )";
+		return {};
+	}
+	return root;
+}
+
+// Byte matched by a set if it can only match one byte, ignoring case if !matchCase.
+int LiteralOf(const ByteSet &set, bool matchCase) noexcept {
+	const size_t count = set.count();
+	if (count == 0 || count > 2) {
+		return -1;
+	}
+	for (int ch = 0; ch < 256; ch++) {
+		if (set[ch]) {
+			if (IsLineEnd(ch)) {
+				return -1;
+			}
+			if (count == 1) {
+				return ch;
+			}
+			// Lowest of a pair must be the upper case form
+			if (!matchCase && (ch >= 'A' && ch <= 'Z') && set[ch - 'A' + 'a']) {
+				return ch - 'A' + 'a';
+			}
+			return -1;
+		}
+	}
+	return -1;
+}
+
+// The longest run of single bytes in the top level sequence is present in every match.
+std::string RequiredLiteral(const Node &root, bool matchCase) {
+	std::string longest;
+	std::string current;
+	auto addNode = [&](const Node &node) {
+		const int ch = (node.kind == Node::Kind::bytes) ? LiteralOf(node.set, matchCase) : -1;
+		if (ch >= 0) {
+			current.push_back(static_cast<char>(ch));
+		} else if (node.kind != Node::Kind::assertion) {
+			current.clear();
+		}
+		if (current.length() > longest.length()) {
+			longest = current;
+		}
+	};
+	if (root.kind == Node::Kind::concatenation) {
+		for (const NodePtr &child : root.children) {
+			addNode(*child);
+		}
+	} else {
+		addNode(root);
+	}
+	return longest;
+}
+
+class Emitter {
+	RegexProgram &program;
+	int Add(const RegexProgram::Instruction &instruction) {
+		program.instructions.push_back(instruction);
+		return static_cast<int>(program.instructions.size() - 1);
+	}
+	int Split(int next, int alternative) {
+		RegexProgram::Instruction instruction;
+		instruction.op = RegexProgram::Op::split;
+		instruction.next = next;
+		instruction.alternative = alternative;
+		return Add(instruction);
+	}
+public:
+	explicit Emitter(RegexProgram &program_) noexcept : program(program_) {
+	}
+	// Instructions are produced from the end backwards with next being the continuation.
+	int Emit(const Node &node, int next) {
+		switch (node.kind) {
+		case Node::Kind::empty:
+			return next;
+		case Node::Kind::bytes: {
+				RegexProgram::Instruction instruction;
+				instruction.op = RegexProgram::Op::bytes;
+				instruction.next = next;
+				instruction.set = static_cast<int>(program.sets.size());
+				program.sets.push_back(node.set);
+				return Add(instruction);
+			}
+		case Node::Kind::assertion: {
+				RegexProgram::Instruction instruction;
+				instruction.op = RegexProgram::Op::assertion;
+				instruction.assertion = node.assertion;
+				instruction.next = next;
+				return Add(instruction);
+			}
+		case Node::Kind::concatenation:
+			for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+				next = Emit(**it, next);
+			}
+			return next;
+		case Node::Kind::alternation: {
+				int entry = Emit(*node.children.back(), next);
+				for (auto it = node.children.rbegin() + 1; it != node.children.rend(); ++it) {
+					entry = Split(Emit(**it, next), entry);
+				}
+				return entry;
+			}
+		case Node::Kind::repeat: {
+				const Node &operand = *node.children.front();
+				if (!node.unbounded) {
+					return Split(Emit(operand, next), next);
+				}
+				// Loop back to a split that either repeats the operand or continues.
+				const int loop = Split(-1, next);
+				const int body = Emit(operand, loop);
+				program.instructions[loop].next = body;
+				return node.optional ? loop : body;
+			}
+		}
+		return next;
+	}
+};
+
+}
+
+RegexProgram::RegexProgram(std::string_view pattern, bool matchCase_, bool wholeWord, bool posix,
+			   std::string_view wordCharacters_) :
+	wordCharacters(WordCharacters(wordCharacters_)), matchCase(matchCase_) {
+	Parser parser(pattern, matchCase, posix, wordCharacters);
+	NodePtr root = parser.Parse();
+	if (!root) {
+		error = parser.error;
+		return;
+	}
+	literal = RequiredLiteral(*root, matchCase);
+	if (wholeWord) {
+		NodePtr surround = std::make_unique<Node>(Node::Kind::concatenation);
+		surround->children.push_back(MakeAssertion(Assertion::notWordBefore));
+		surround->children.push_back(std::move(root));
+		surround->children.push_back(MakeAssertion(Assertion::notWordAfter));
+		root = std::move(surround);
+	}
+	Emitter emitter(*this);
+	const int matchInstruction = static_cast<int>(instructions.size());
+	instructions.push_back(Instruction());
+	entry = emitter.Emit(*root, matchInstruction);
+}
+
+RegexSearch::RegexSearch(const RegexProgram &program_) :
+	program(program_), marks(program.instructions.size()) {
+	if (!program.literal.empty()) {
+		prefilter = std::make_unique<SubstringSearch>(program.literal, program.matchCase);
+	}
+	Reset();
+}
+
+void RegexSearch::Reset() {
+	states.clear();
+	stateIndex.clear();
+	transitions.clear();
+	// The states at the start of a line and after a '\r' are always 0 and 1.
+	State start;
+	start.kernel.push_back(program.entry);
+	start.lineStart = true;
+	AddState(start);
+	start.afterCR = true;
+	AddState(start);
+}
+
+int RegexSearch::AddState(const State &state) {
+	std::vector<int> key = state.kernel;
+	key.push_back(state.lineStart + state.afterCR * 2 + state.prevWord * 4);
+	const auto [it, inserted] = stateIndex.try_emplace(std::move(key), static_cast<int>(states.size()));
+	if (inserted) {
+		states.push_back(state);
+		transitions.resize(transitions.size() + symbols, unknown);
+	}
+	return it->second;
+}
+
+// Find the instructions reachable from the state's kernel without consuming a byte.
+void RegexSearch::Close(const State &state, bool lineEnd, bool nextWord) {
+	generation++;
+	if (generation == 0) {
+		std::fill(marks.begin(), marks.end(), 0);
+		generation = 1;
+	}
+	closure.clear();
+	stack = state.kernel;
+	while (!stack.empty()) {
+		const int pc = stack.back();
+		stack.pop_back();
+		if (marks[pc] == generation) {
+			continue;
+		}
+		marks[pc] = generation;
+		const RegexProgram::Instruction &instruction = program.instructions[pc];
+		switch (instruction.op) {
+		case RegexProgram::Op::bytes:
+		case RegexProgram::Op::match:
+			closure.push_back(pc);
+			break;
+		case RegexProgram::Op::split:
+			stack.push_back(instruction.alternative);
+			stack.push_back(instruction.next);
+			break;
+		case RegexProgram::Op::assertion: {
+				bool satisfied = false;
+				switch (instruction.assertion) {
+				case Assertion::lineStart:
+					satisfied = state.lineStart;
+					break;
+				case Assertion::lineEnd:
+					satisfied = lineEnd;
+					break;
+				case Assertion::wordStart:
+					satisfied = !state.prevWord && nextWord;
+					break;
+				case Assertion::wordEnd:
+					satisfied = state.prevWord && !nextWord;
+					break;
+				case Assertion::notWordBefore:
+					satisfied = !state.prevWord;
+					break;
+				case Assertion::notWordAfter:
+					satisfied = !nextWord;
+					break;
+				}
+				if (satisfied) {
+					stack.push_back(instruction.next);
+				}
+			}
+			break;
+		}
+	}
+}
+
+int RegexSearch::Transition(int current, int symbol) {
+	// Copy as adding a state may reset the cache
+	const State state = states[current];
+	int result = 0;
+	if ((symbol == '\n') && state.afterCR) {
+		// Second half of "\r\n" so no new line
+		result = 0;
+	} else {
+		const bool lineEnd = IsLineEnd(symbol) || (symbol == symbolEnd);
+		const bool nextWord = !lineEnd && program.wordCharacters[symbol];
+		Close(state, lineEnd, nextWord);
+		const bool isMatch = std::any_of(closure.begin(), closure.end(), [this](int pc) noexcept {
+			return program.instructions[pc].op == RegexProgram::Op::match;
+		});
+		if (isMatch) {
+			result = matched;
+		} else if (lineEnd) {
+			result = (symbol == '\r') ? 1 : 0;
+		} else {
+			State next;
+			next.prevWord = nextWord;
+			for (const int pc : closure) {
+				const RegexProgram::Instruction &instruction = program.instructions[pc];
+				if (program.sets[instruction.set][symbol]) {
+					next.kernel.push_back(instruction.next);
+				}
+			}
+			// A match may start at any position
+			next.kernel.push_back(program.entry);
+			std::sort(next.kernel.begin(), next.kernel.end());
+			next.kernel.erase(std::unique(next.kernel.begin(), next.kernel.end()), next.kernel.end());
+			if (states.size() >= maximumStates) {
+				Reset();
+				current = -1;
+			}
+			result = AddState(next);
+		}
+	}
+	if (current >= 0) {
+		transitions[current * symbols + symbol] = result;
+	}
+	return result;
+}
+
+size_t RegexSearch::Scan(std::string_view text, size_t start, bool oneLine, size_t &nextLine) {
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(text.data());
+	int current = 0;
+	for (size_t i = start; i < text.length(); i++) {
+		const unsigned char ch = bytes[i];
+		int next = transitions[current * symbols + ch];
+		if (next < 0) {
+			if (next == unknown) {
+				next = Transition(current, ch);
+			}
+			if (next == matched) {
+				return i;
+			}
+		}
+		if (oneLine && IsLineEnd(ch)) {
+			nextLine = i + 1;
+			if ((ch == '\r') && (nextLine < text.length()) && (bytes[nextLine] == '\n')) {
+				nextLine++;
+			}
+			return std::string_view::npos;
+		}
+		current = next;
+	}
+	nextLine = text.length();
+	if (!states[current].lineStart) {
+		// Text ends without a line end so check for a match at the end of the last line
+		int next = transitions[current * symbols + symbolEnd];
+		if (next == unknown) {
+			next = Transition(current, symbolEnd);
+		}
+		if (next == matched) {
+			return text.length() - 1;
+		}
+	}
+	return std::string_view::npos;
+}
+
+size_t RegexSearch::Find(std::string_view text, size_t start) {
+	size_t nextLine = text.length();
+	if (!prefilter) {
+		return Scan(text, start, false, nextLine);
+	}
+	size_t lineStart = start;
+	while (lineStart < text.length()) {
+		const size_t hit = prefilter->Find(text, lineStart);
+		if (hit == std::string_view::npos) {
+			return std::string_view::npos;
+		}
+		size_t lineHit = hit;
+		while ((lineHit > lineStart) && !IsLineEnd(text[lineHit - 1])) {
+			lineHit--;
+		}
+		const size_t position = Scan(text, lineHit, true, nextLine);
+		if (position != std::string_view::npos) {
+			return position;
+		}
+		lineStart = nextLine;
+	}
+	return std::string_view::npos;
+}
@@ -0,0 +1,94 @@
+// SciTE - Scintilla based Text Editor
+/** @file RegexSearch.h
+ ** Find lines matching a regular expression with a lazily built automaton.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef REGEXSEARCH_H
+#define REGEXSEARCH_H
+
+/**
+ * A regular expression compiled into a program for a nondeterministic automaton.
+ * The syntax is that of Scintilla's basic regular expressions: . [] [^] * + ? ^ $ \< \>
+ * \d \D \s \S \w \W \xHH and groups with \( \) or, in POSIX mode, ( ).
+ * Alternation with \| or, in POSIX mode, | is also allowed.
+ * Back references can not be implemented by an automaton so are reported as errors.
+ * Only ASCII letters are treated as differing in case. Word characters, used by \w \W \< \>
+ * and whole word matching, may be set to match a document and default to ASCII letters,
+ * digits and '_'.
+ * Once constructed, a RegexProgram is not modified so may be shared between threads.
+ */
+class RegexProgram {
+public:
+	enum class Op { bytes, split, assertion, match };
+	enum class Assertion { lineStart, lineEnd, wordStart, wordEnd, notWordBefore, notWordAfter };
+	struct Instruction {
+		Op op = Op::match;
+		Assertion assertion = Assertion::lineStart;
+		int next = -1;
+		int alternative = -1;
+		int set = -1;
+	};
+	std::vector<Instruction> instructions;
+	std::vector<std::bitset<256>> sets;
+	std::bitset<256> wordCharacters;
+	int entry = 0;
+	bool matchCase;
+	/// Text that must be present in any match, used to skip lines quickly.
+	std::string literal;
+	/// Description of why the pattern could not be compiled.
+	std::string error;
+
+	/// wordCharacters_ lists the bytes that are word characters or is empty for the default.
+	RegexProgram(std::string_view pattern, bool matchCase_, bool wholeWord, bool posix,
+		     std::string_view wordCharacters_={});
+	bool IsValid() const noexcept {
+		return error.empty();
+	}
+};
+
+/**
+ * Finds lines containing a match for a RegexProgram by running a deterministic automaton
+ * whose states are built as they are first reached. When the program has a literal, each
+ * line is only examined after the literal is found in it.
+ * Holds a cache of states so should only be used by one thread at a time.
+ */
+class RegexSearch {
+	struct State {
+		std::vector<int> kernel;
+		bool lineStart = false;
+		bool afterCR = false;
+		bool prevWord = false;
+	};
+	const RegexProgram &program;
+	std::unique_ptr<SubstringSearch> prefilter;
+	std::vector<State> states;
+	std::map<std::vector<int>, int> stateIndex;
+	// (states.size() * symbols) transitions to the next state or unknown or matched.
+	std::vector<int> transitions;
+	std::vector<int> closure;
+	std::vector<int> stack;
+	std::vector<unsigned int> marks;
+	unsigned int generation = 0;
+	void Reset();
+	int AddState(const State &state);
+	void Close(const State &state, bool lineEnd, bool nextWord);
+	int Transition(int current, int symbol);
+	size_t Scan(std::string_view text, size_t start, bool oneLine, size_t &nextLine);
+public:
+	/// Symbols are bytes and the end of the text.
+	static constexpr int symbols = 257;
+	static constexpr int symbolEnd = 256;
+	static constexpr int unknown = -1;
+	static constexpr int matched = -2;
+	// Limits memory use with patterns that produce many states.
+	static constexpr size_t maximumStates = 2000;
+
+	explicit RegexSearch(const RegexProgram &program_);
+	/// Return a position in the first line at or after start that contains a match or
+	/// std::string_view::npos. start must be at the start of a line.
+	size_t Find(std::string_view text, size_t start=0);
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include <string>
 #include <string_view>
 #include <vector>
+#include <array>
 #include <map>
 #include <set>
 #include <optional>
@@ -29,6 +30,7 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <future>
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -47,6 +49,7 @@
 #include "StringList.h"
 #include "StringHelpers.h"
 #include "FilePath.h"
+#include "PhaseProfile.h"
 #include "StyleDefinition.h"
 #include "PropSetFile.h"
 #include "StyleWriter.h"
@@ -59,6 +62,8 @@
 #include "Utf8_16.h"
 #include "FileWorker.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
+#include "WordIndex.h"
 #include "EditorConfig.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
@@ -201,7 +206,7 @@ UndoBlock::~UndoBlock() noexcept {
 	}
 }
 
-SciTEBase::SciTEBase(Extension *ext) : apis(true), pwFocussed(&wEditor), extender(ext) {
+SciTEBase::SciTEBase(Extension *ext) : apis(std::make_shared<StringList>(true)), pwFocussed(&wEditor), extender(ext) {
 	needIdle = false;
 	codePage = 0;
 	characterSet = SA::CharacterSet::Ansi;
@@ -264,6 +269,11 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), pwFocussed(&wEditor), extende
 	indentationWSVisible = true;
 	indentExamine = SA::IndentView::LookBoth;
 	autoCompleteIgnoreCase = false;
+	autoCompleteFuzzy = false;
+	autoCompleteWordIndex = false;
+	autoCompleteWordBuffers = false;
+	autoCompleteWordDirectory = false;
+	fuzzyListShown = FuzzyList::none;
 	imeAutoComplete = false;
 	callTipUseEscapes = false;
 	callTipIgnoreCase = false;
@@ -846,22 +856,36 @@ void SciTEBase::HighlightCurrentWord(bool highlight) {
 		return;
 	}
 	GUI::ScintillaWindow &wCurrent = wOutput.HasFocus() ? wOutput : wEditor;
+	const SA::FindOption searchFlags = SA::FindOption::MatchCase | SA::FindOption::WholeWord;
+	// Get start & end selection.
+	SA::Span sel = wCurrent.SelectionSpan();
+	const bool noUserSelection = sel.start == sel.end;
+	std::string wordToFind;
+	int selectedStyle = -1;
+	if (highlight && !FilterShowing()) {
+		const std::string sWordToFind = RangeExtendAndGrab(wCurrent, sel,
+					  &SciTEBase::islexerwordcharforsel);
+		// No highlight when no selection or multi-lines selection.
+		if (sWordToFind.length() > 0 && (sWordToFind.find_first_of("\n\r ") == std::string::npos)) {
+			// Manage word with DBCS.
+			wordToFind = EncodeString(sWordToFind);
+			// Get style of the current word to highlight only word with same style.
+			if (currentWordHighlight.isOnlyWithSameStyle)
+				selectedStyle = wCurrent.UnsignedStyleAt(sel.start);
+		}
+	}
+	if (!wordToFind.empty() && matchMarker.Matching(&wCurrent, wordToFind, searchFlags,
+		selectedStyle, indicatorHighlightCurrentWord)) {
+		// Already highlighted and kept up to date through edits
+		return;
+	}
 	// Remove old indicators if any exist.
+	matchMarker.Stop();
 	wCurrent.SetIndicatorCurrent(indicatorHighlightCurrentWord);
 	const SA::Position lenDoc = wCurrent.Length();
 	wCurrent.IndicatorClearRange(0, lenDoc);
-	if (!highlight)
+	if (wordToFind.empty())
 		return;
-	if (FilterShowing()) {
-		return;
-	}
-	// Get start & end selection.
-	SA::Span sel = wCurrent.SelectionSpan();
-	const bool noUserSelection = sel.start == sel.end;
-	std::string sWordToFind = RangeExtendAndGrab(wCurrent, sel,
-				  &SciTEBase::islexerwordcharforsel);
-	if (sWordToFind.length() == 0 || (sWordToFind.find_first_of("\n\r ") != std::string::npos))
-		return; // No highlight when no selection or multi-lines selection.
 	if (noUserSelection && currentWordHighlight.statesOfDelay == CurrentWordHighlight::StatesOfDelay::noDelay) {
 		// Manage delay before highlight when no user selection but there is word at the caret.
 		currentWordHighlight.statesOfDelay = CurrentWordHighlight::StatesOfDelay::delay;
@@ -869,15 +893,7 @@ void SciTEBase::HighlightCurrentWord(bool highlight) {
 		currentWordHighlight.elapsedTimes.Duration(true);
 		return;
 	}
-	// Get style of the current word to highlight only word with same style.
-	int selectedStyle = wCurrent.UnsignedStyleAt(sel.start);
-	if (!currentWordHighlight.isOnlyWithSameStyle)
-		selectedStyle = -1;
 
-	// Manage word with DBCS.
-	const std::string wordToFind = EncodeString(sWordToFind);
-
-	const SA::FindOption searchFlags = SA::FindOption::MatchCase | SA::FindOption::WholeWord;
 	matchMarker.StartMatch(&wCurrent, wordToFind,
 			       searchFlags, selectedStyle,
 			       indicatorHighlightCurrentWord, -1);
@@ -1094,6 +1110,78 @@ void SciTEBase::MarkAll(MarkPurpose purpose) {
 	SetIdler(true);
 }
 
+void SciTEBase::CountMatches() {
+	if (!findCount) {
+		return;
+	}
+	const SA::FindOption flags = SearchFlags(regExp);
+	const std::string findTarget = UnSlashAsNeeded(EncodeString(findWhat), unSlash, regExp);
+	if (findTarget.empty()) {
+		if (countMarker.Active()) {
+			countMarker.Stop();
+			ShowMatchCount();
+		}
+		return;
+	}
+	if (countMarker.Matching(&wEditor, findTarget, flags, -1, -1)) {
+		return;
+	}
+	countMarker.StartMatch(&wEditor, findTarget, flags, -1, -1, -1);
+	if (countMarker.Complete()) {
+		ShowMatchCount();
+	} else {
+		SetIdler(true);
+	}
+}
+
+void SciTEBase::ShowMatchCount() {
+	props.Set("FindMatchCount", countMarker.Active() ? std::to_string(countMarker.Count()) : std::string());
+	UpdateStatusBar(false);
+}
+
+std::vector<SA::Line> SciTEBase::FindMatchLines() {
+	if (countMarker.Active() && countMarker.Complete()) {
+		return countMarker.Lines();
+	}
+	return {};
+}
+
+std::vector<ExtensionAPI::PropertyStatistic> SciTEBase::PropertyStatistics() {
+	std::vector<PropertyStatistic> result;
+	for (const PropSetStatistic &statistic : PropSetFile::Statistics()) {
+		result.push_back({statistic.operation, statistic.key, statistic.calls, statistic.depth, statistic.seconds});
+	}
+	return result;
+}
+
+/**
+ * Show the property lookups counted since props.stats was set in the output pane,
+ * taking the most time first. When count is not empty, show at most that many.
+ */
+void SciTEBase::ShowPropertyStatistics(std::string_view count) {
+	if (!props.GetInt("props.stats")) {
+		OutputAppendString("Property lookups are only counted when props.stats is set.\n");
+		return;
+	}
+	const std::vector<PropSetStatistic> statistics = PropSetFile::Statistics();
+	const int requested = IntegerFromString(std::string(count), 0);
+	const size_t limit = count.empty() ? statistics.size() :
+		std::min<size_t>(statistics.size(), std::max(requested, 0));
+	std::string report = "Property lookups: calls, average sets searched, total ms, operation key\n";
+	for (size_t i = 0; i < limit; i++) {
+		const PropSetStatistic &statistic = statistics[i];
+		char line[100];
+		snprintf(line, sizeof(line), "%10zu %6.1f %10.3f  ", statistic.calls,
+			 static_cast<double>(statistic.depth) / static_cast<double>(statistic.calls), statistic.seconds * 1000.0);
+		report += line;
+		report += statistic.operation;
+		report += " ";
+		report += statistic.key;
+		report += "\n";
+	}
+	OutputAppendString(report);
+}
+
 void SciTEBase::FilterAll(bool showMatches) {
 
 	HighlightCurrentWord(false);
@@ -1177,6 +1265,7 @@ SA::Position SciTEBase::FindInTarget(const std::string &findWhatText, SA::Span r
 void SciTEBase::SetFindText(std::string_view sFind) {
 	findWhat = sFind;
 	props.Set("find.what", findWhat);
+	CountMatches();
 }
 
 void SciTEBase::SetFind(std::string_view sFind) {
@@ -1303,6 +1392,39 @@ void SciTEBase::ReplaceOnce(bool showWarnings) {
 	FindNext(false, showWarnings && !haveWarned);
 }
 
+// Replace fixed text by finding every match before changing the document so the
+// document is not searched again after each change.
+// Each match is replaced separately, from the last so earlier positions stay valid, as
+// replacing the whole span they cover would move its markers and expand its folds on undo.
+intptr_t SciTEBase::ReplaceAllFixed(const std::string &findTarget, const std::string &replaceTarget,
+	SA::Span &rangeSearch, SA::Position &lastMatch) {
+	std::vector<SA::Span> matches;
+	SA::Position position = rangeSearch.start;
+	while (position < rangeSearch.end) {
+		const SA::Position posFind = FindInTarget(findTarget, SA::Span(position, rangeSearch.end), false);
+		if (posFind < 0) {
+			break;
+		}
+		matches.emplace_back(posFind, wEditor.TargetEnd());
+		position = std::max(wEditor.TargetEnd(), posFind + 1);
+	}
+	if (matches.empty()) {
+		return 0;
+	}
+
+	const SA::Position lengthReplace = replaceTarget.length();
+	SA::Position change = 0;
+	UndoBlock ub(wEditor);
+	for (auto it = matches.rbegin(); it != matches.rend(); ++it) {
+		wEditor.SetTarget(*it);
+		wEditor.ReplaceTarget(replaceTarget);
+		change += lengthReplace - it->Length();
+	}
+	rangeSearch.end += change;
+	lastMatch = matches.back().end + change;
+	return matches.size();
+}
+
 intptr_t SciTEBase::DoReplaceAll(bool inSelection) {
 	const std::string findTarget = UnSlashAsNeeded(EncodeString(findWhat), unSlash, regExp);
 	if (findTarget.length() == 0) {
@@ -1340,6 +1462,20 @@ intptr_t SciTEBase::DoReplaceAll(bool inSelection) {
 
 	const std::string replaceTarget = UnSlashAsNeeded(EncodeString(replaceWhat), unSlash, regExp);
 	wEditor.SetSearchFlags(SearchFlags(regExp));
+	if (!regExp && !(inSelection && countSelections > 1)) {
+		// Regular expression replacements depend on each search and multiple selections
+		// need each match checked so they use the loop below.
+		SA::Position lastMatch = 0;
+		const intptr_t replacements = ReplaceAllFixed(findTarget, replaceTarget, rangeSearch, lastMatch);
+		if (replacements > 0) {
+			if (inSelection) {
+				SetSelection(rangeSearch.start, rangeSearch.end);
+			} else {
+				SetSelection(lastMatch, lastMatch);
+			}
+		}
+		return replacements;
+	}
 	SA::Position posFind = FindInTarget(findTarget, rangeSearch, false);
 	if ((posFind >= 0) && (posFind <= rangeSearch.end)) {
 		SA::Position lastMatch = posFind;
@@ -1423,25 +1559,93 @@ intptr_t SciTEBase::ReplaceAll(bool inSelection) {
 }
 
 intptr_t SciTEBase::ReplaceInBuffers() {
+	const std::string findTarget = UnSlashAsNeeded(EncodeString(findWhat), unSlash, regExp);
+	if (findTarget.empty()) {
+		FindMessageBox(
+			"Find string must not be empty for 'Replace in Buffers' command.");
+		return -1;
+	}
+	const std::string replaceTarget = UnSlashAsNeeded(EncodeString(replaceWhat), unSlash, regExp);
 	const BufferIndex currentBuffer = buffers.Current();
-	intptr_t replacements = 0;
-	for (int i = 0; i < buffers.length; i++) {
-		SetDocumentAt(i);
-		replacements += DoReplaceAll(false);
-		if (i == 0 && replacements < 0) {
-			FindMessageBox(
-				"Find string must not be empty for 'Replace in Buffers' command.");
-			break;
+	intptr_t replacements = DoReplaceAll(false);
+	// Other buffers are replaced in the background when they do not need to be styled
+	// and the text is the same in every encoding.
+	const bool background = wReplacer.CanCall() && !findInStyle &&
+		std::all_of(findTarget.begin(), findTarget.end(), IsASCII) &&
+		std::all_of(replaceTarget.begin(), replaceTarget.end(), IsASCII);
+	if (background) {
+		std::vector<SA::IDocumentEditable *> documents;
+		for (BufferIndex i = 0; i < buffers.length; i++) {
+			const Buffer &buffer = buffers.buffers[i];
+			if ((i != currentBuffer) && buffer.doc && !buffer.pFileWorker && !buffer.isReadOnly) {
+				documents.push_back(buffer.doc.get());
+				// Changes through wReplacer are not notified while the document is not current
+				TextChanged(buffer.doc.get());
+			}
+		}
+		replacementsBeforeBackground = replacements;
+		bufferReplacer.Start(&wReplacer, documents, findTarget, replaceTarget, SearchFlags(regExp), regExp);
+		ContinueReplaceInBuffers(0.1);
+		if (!bufferReplacer.Complete()) {
+			SetIdler(true);
+			UpdateProgress(nullptr);
+			CheckMenus();
+		}
+		return replacementsBeforeBackground + bufferReplacer.Replacements();
+	}
+	for (BufferIndex i = 0; i < buffers.length; i++) {
+		if (i != currentBuffer) {
+			SetDocumentAt(i);
+			replacements += DoReplaceAll(false);
 		}
 	}
 	SetDocumentAt(currentBuffer);
+	ReplacedInBuffers(replacements);
+	return replacements;
+}
+
+void SciTEBase::ContinueReplaceInBuffers(double duration) {
+	GUI::ElapsedTime elapsed;
+	while (!bufferReplacer.Complete()) {
+		const SA::IDocumentEditable *pDoc = bufferReplacer.Continue(duration - elapsed.Duration());
+		if (pDoc && wReplacer.Modify()) {
+			for (BufferIndex i = 0; i < buffers.length; i++) {
+				Buffer &buffer = buffers.buffers[i];
+				if ((buffer.doc.get() == pDoc) && buffer.wordIndex) {
+					// Edits through wReplacer are not seen so index again when current
+					buffer.wordIndex->Stop();
+				}
+				if ((buffer.doc.get() == pDoc) && !buffer.isDirty) {
+					buffer.isDirty = true;
+					buffer.DocumentModified();
+					SetBuffersMenu();
+				}
+			}
+		}
+		if (elapsed.Duration() >= duration) {
+			break;
+		}
+	}
+	if (bufferReplacer.Complete()) {
+		StopReplaceInBuffers();
+	}
+}
+
+void SciTEBase::StopReplaceInBuffers() {
+	const intptr_t replacements = replacementsBeforeBackground + bufferReplacer.Replacements();
+	bufferReplacer.Stop();
+	ReplacedInBuffers(replacements);
+	UpdateProgress(nullptr);
+	CheckMenus();
+}
+
+void SciTEBase::ReplacedInBuffers(intptr_t replacements) {
 	props.Set("Replacements", std::to_string(replacements));
 	UpdateStatusBar(false);
 	if (replacements == 0) {
 		FindMessageBox(
 			"No replacements because string '^0' was not present.", &findWhat);
 	}
-	return replacements;
 }
 
 void SciTEBase::UIClosed() {
@@ -1644,7 +1848,7 @@ std::string SciTEBase::GetNearestWords(const char *wordStart, size_t searchLen,
 				       const char *separators, bool ignoreCase /*=false*/, bool exactLen /*=false*/) {
 	std::string words;
 	while (words.empty() && *separators) {
-		words = apis.GetNearestWords(wordStart, searchLen, ignoreCase, *separators, exactLen);
+		words = apis->GetNearestWords(wordStart, searchLen, ignoreCase, *separators, exactLen);
 		separators++;
 	}
 	return words;
@@ -1654,7 +1858,7 @@ void SciTEBase::FillFunctionDefinition(SA::Position pos /*= -1*/) {
 	if (pos > 0) {
 		lastPosCallTip = pos;
 	}
-	if (apis) {
+	if (*apis) {
 		std::string words = GetNearestWords(currentCallTipWord.c_str(), currentCallTipWord.length(),
 						    calltipParametersStart.c_str(), callTipIgnoreCase, true);
 		if (words.empty())
@@ -1663,7 +1867,7 @@ void SciTEBase::FillFunctionDefinition(SA::Position pos /*= -1*/) {
 		maxCallTips = std::count(words.begin(), words.end(), ' ') + 1;
 
 		// Should get current api definition
-		std::string word = apis.GetNearestWord(currentCallTipWord.c_str(), currentCallTipWord.length(),
+		std::string word = apis->GetNearestWord(currentCallTipWord.c_str(), currentCallTipWord.length(),
 						       callTipIgnoreCase, calltipWordCharacters, currentCallTip);
 		if (word.length()) {
 			functionDefinition = word;
@@ -1818,6 +2022,25 @@ std::string SciTEBase::EliminateDuplicateWords(const std::string &words) {
 	return wordsOut;
 }
 
+namespace {
+
+// Fuzzy lists are ranked so only show the best matches.
+constexpr size_t autoCompleteFuzzyMaximum = 100;
+
+}
+
+void SciTEBase::ShowAutoComplete(SA::Position lenEntered, const std::string &list, char separator, FuzzyList fuzzy) {
+	// Fuzzy lists are in order of score and may not start with the text entered so
+	// Scintilla should not sort them or search them for that text.
+	const bool ranked = fuzzy != FuzzyList::none;
+	wEditor.AutoCSetOrder(ranked ? SA::Ordering::Custom : SA::Ordering::PreSorted);
+	wEditor.AutoCSetOptions(ranked ? SA::AutoCompleteOption::SelectFirstItem : SA::AutoCompleteOption::Normal);
+	wEditor.AutoCSetSeparator(separator);
+	wEditor.AutoCSetMaxHeight(autoCompleteVisibleItemCount);
+	wEditor.AutoCShow(lenEntered, list.c_str());
+	fuzzyListShown = wEditor.AutoCActive() ? fuzzy : FuzzyList::none;
+}
+
 bool SciTEBase::StartAutoComplete() {
 	const std::string line = GetCurrentLine();
 	const SA::Position current = GetCaretInLine();
@@ -1831,19 +2054,42 @@ bool SciTEBase::StartAutoComplete() {
 	}
 
 	const std::string root = line.substr(startword, current - startword);
-	if (apis) {
-		const std::string words = GetNearestWords(root.c_str(), root.length(),
-						    calltipParametersStart.c_str(), autoCompleteIgnoreCase);
+	if (*apis) {
+		const std::string words = autoCompleteFuzzy ?
+			apis->GetFuzzyWords(root.c_str(), root.length(), calltipParametersStart.empty() ? '\0' : calltipParametersStart[0],
+					    autoCompleteFuzzyMaximum) :
+			GetNearestWords(root.c_str(), root.length(), calltipParametersStart.c_str(), autoCompleteIgnoreCase);
 		if (!words.empty()) {
-			std::string wordsUnique = EliminateDuplicateWords(words);
-			wEditor.AutoCSetSeparator(' ');
-			wEditor.AutoCSetMaxHeight(autoCompleteVisibleItemCount);
-			wEditor.AutoCShow(root.length(), wordsUnique.c_str());
+			const std::string wordsUnique = EliminateDuplicateWords(words);
+			ShowAutoComplete(root.length(), wordsUnique, ' ', autoCompleteFuzzy ? FuzzyList::api : FuzzyList::none);
+		} else if (autoCompleteFuzzy) {
+			wEditor.AutoCCancel();
 		}
 	}
 	return true;
 }
 
+void SciTEBase::IndexDirectoryWords() {
+	if (!autoCompleteWordDirectory || filePath.IsUntitled()) {
+		directoryWords.reset();
+		return;
+	}
+	const FilePath directory = filePath.Directory();
+	const FilePath extension = filePath.Extension();
+	if (directoryWords && directoryWords->Reading(directory, extension, wordCharacters)) {
+		return;
+	}
+	if (!directoryWords) {
+		directoryWords = std::make_shared<DirectoryWords>();
+	}
+	// Open files are indexed from their documents which may differ from the files
+	FilePathSet filesOpen;
+	for (BufferIndex i = 0; i < buffers.length; i++) {
+		filesOpen.push_back(buffers.buffers[i].file);
+	}
+	directoryWords->Start(directory, extension, wordCharacters, filesOpen);
+}
+
 bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 	const std::string line = GetCurrentLine();
 	const SA::Position current = GetCaretInLine();
@@ -1862,6 +2108,8 @@ bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 	const std::string root = line.substr(startword, current - startword);
 	const SA::Position rootLength = root.length();
 	const SA::Position doclen = LengthDocument();
+	// Fuzzy matches may start with any character so every word is a candidate
+	const std::string searchFor = autoCompleteFuzzy ? std::string() : root;
 	const SA::FindOption flags =
 		SA::FindOption::WordStart | (autoCompleteIgnoreCase ? SA::FindOption::None : SA::FindOption::MatchCase);
 	const SA::Position posCurrentWord = wEditor.CurrentPos() - rootLength;
@@ -1869,27 +2117,88 @@ bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 	// wordList contains a list of words to display in an autocompletion list.
 	AutoCompleteWordList wordList;
 
-	wEditor.SetTarget(SA::Span(0, doclen));
-	wEditor.SetSearchFlags(flags);
-	SA::Position posFind = wEditor.SearchInTarget(root);
 	TextReader acc(wEditor);
-	while (posFind >= 0 && posFind < doclen) {	// search all the document
-		SA::Position wordEnd = posFind + rootLength;
-		if (posFind != posCurrentWord) {
-			while (Contains(wordCharacters, acc.SafeGetCharAt(wordEnd)))
-				wordEnd++;
-			const SA::Position wordLength = wordEnd - posFind;
-			if (wordLength > rootLength) {
-				const std::string word = wEditor.StringOfRange(SA::Span(posFind, wordEnd));
-				if (wordList.Add(word)) {
-					if (onlyOneWord && wordList.Count() > 1) {
+	const std::shared_ptr<WordIndex> &wordIndex = CurrentBuffer()->wordIndex;
+	if (autoCompleteWordIndex && wordIndex && wordIndex->Indexing(&wEditor, wordCharacters) && wordIndex->Complete()) {
+		// The word at the caret is only a candidate when it also occurs elsewhere
+		SA::Position currentWordEnd = posCurrentWord + rootLength;
+		while (Contains(wordCharacters, acc.SafeGetCharAt(currentWordEnd)))
+			currentWordEnd++;
+		const std::string currentWord = wEditor.StringOfRange(SA::Span(posCurrentWord, currentWordEnd));
+		for (const WordIndex::WordCount &wordCount : wordIndex->WordsStarting(searchFor, autoCompleteIgnoreCase || autoCompleteFuzzy)) {
+			if ((wordCount.word.length() > static_cast<size_t>(rootLength)) &&
+				((wordCount.count > 1) || (wordCount.word != currentWord)) &&
+				(!autoCompleteFuzzy || FuzzyMatches(root, wordCount.word))) {
+				if (wordList.Add(std::string(wordCount.word))) {
+					// Fuzzy candidates are only counted once ranked
+					if (onlyOneWord && !autoCompleteFuzzy && wordList.Count() > 1) {
 						return true;
 					}
 				}
 			}
 		}
-		wEditor.SetTarget(SA::Span(wordEnd, doclen));
-		posFind = wEditor.SearchInTarget(root);
+	} else if (autoCompleteFuzzy) {
+		SA::Position position = 0;
+		while (position < doclen) {
+			while ((position < doclen) && !Contains(wordCharacters, acc.SafeGetCharAt(position)))
+				position++;
+			const SA::Position wordStart = position;
+			while ((position < doclen) && Contains(wordCharacters, acc.SafeGetCharAt(position)))
+				position++;
+			if ((wordStart != posCurrentWord) && (position - wordStart > rootLength)) {
+				const std::string word = wEditor.StringOfRange(SA::Span(wordStart, position));
+				if (FuzzyMatches(root, word)) {
+					wordList.Add(word);
+				}
+			}
+		}
+	} else {
+		wEditor.SetTarget(SA::Span(0, doclen));
+		wEditor.SetSearchFlags(flags);
+		SA::Position posFind = wEditor.SearchInTarget(searchFor);
+		while (posFind >= 0 && posFind < doclen) {	// search all the document
+			SA::Position wordEnd = posFind + searchFor.length();
+			if (posFind != posCurrentWord) {
+				while (Contains(wordCharacters, acc.SafeGetCharAt(wordEnd)))
+					wordEnd++;
+				const SA::Position wordLength = wordEnd - posFind;
+				if (wordLength > rootLength) {
+					const std::string word = wEditor.StringOfRange(SA::Span(posFind, wordEnd));
+					if (wordList.Add(word)) {
+						if (onlyOneWord && wordList.Count() > 1) {
+							return true;
+						}
+					}
+				}
+			}
+			wEditor.SetTarget(SA::Span(wordEnd, doclen));
+			posFind = wEditor.SearchInTarget(searchFor);
+		}
+	}
+	// Merge words from the indexes of other documents and files which do not contain the caret
+	std::vector<const WordIndex *> wordIndexesOther;
+	if (autoCompleteWordIndex && autoCompleteWordBuffers) {
+		for (BufferIndex i = 0; i < buffers.length; i++) {
+			const Buffer &buffer = buffers.buffers[i];
+			if ((i != buffers.Current()) && buffer.wordIndex && buffer.wordIndex->Indexed(buffer.doc.get())) {
+				wordIndexesOther.push_back(buffer.wordIndex.get());
+			}
+		}
+	}
+	const WordIndex *wordIndexDirectory = directoryWords ? directoryWords->Index() : nullptr;
+	if (wordIndexDirectory) {
+		wordIndexesOther.push_back(wordIndexDirectory);
+	}
+	for (const WordIndex *wordIndexOther : wordIndexesOther) {
+		for (const WordIndex::WordCount &wordCount : wordIndexOther->WordsStarting(searchFor, autoCompleteIgnoreCase || autoCompleteFuzzy)) {
+			if ((wordCount.word.length() > static_cast<size_t>(rootLength)) &&
+				(!autoCompleteFuzzy || FuzzyMatches(root, wordCount.word))) {
+				wordList.Add(std::string(wordCount.word));
+			}
+		}
+		if (onlyOneWord && !autoCompleteFuzzy && wordList.Count() > 1) {
+			return true;
+		}
 	}
 	if ((wordList.Count() != 0) && (!onlyOneWord || (wordList.MinWordLength() > static_cast<size_t>(rootLength)))) {
 		// Protect spaces by temporarily transforming to \001
@@ -1897,14 +2206,18 @@ bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 		std::replace(wordsNear.begin(), wordsNear.end(), ' ', '\001');
 		StringList wl(true);
 		wl.Set(wordsNear.c_str());
-		std::string acText = wl.GetNearestWords("", 0, autoCompleteIgnoreCase);
+		std::string acText = autoCompleteFuzzy ?
+			wl.GetFuzzyWords(root.c_str(), root.length(), '\0', autoCompleteFuzzyMaximum) :
+			wl.GetNearestWords("", 0, autoCompleteIgnoreCase);
 		// Use \n as word separator
 		std::replace(acText.begin(), acText.end(), ' ', '\n');
 		// Return spaces from \001
 		std::replace(acText.begin(), acText.end(), '\001', ' ');
-		wEditor.AutoCSetSeparator('\n');
-		wEditor.AutoCSetMaxHeight(autoCompleteVisibleItemCount);
-		wEditor.AutoCShow(rootLength, acText.c_str());
+		if (acText.empty() || (onlyOneWord && autoCompleteFuzzy && (acText.find('\n') != std::string::npos))) {
+			wEditor.AutoCCancel();
+		} else {
+			ShowAutoComplete(rootLength, acText, '\n', autoCompleteFuzzy ? FuzzyList::word : FuzzyList::none);
+		}
 	} else {
 		wEditor.AutoCCancel();
 	}
@@ -2779,6 +3092,10 @@ void SciTEBase::CharAdded(int utf32) {
 				if (Contains(autoCompleteStartCharacters, ch)) {
 					StartAutoComplete();
 				}
+			} else if (fuzzyListShown == FuzzyList::api) {
+				StartAutoComplete();
+			} else if (fuzzyListShown == FuzzyList::word) {
+				StartAutoCompleteWord(autoCCausedByOnlyOne);
 			} else if (autoCCausedByOnlyOne) {
 				StartAutoCompleteWord(true);
 			}
@@ -3630,6 +3947,9 @@ void SciTEBase::MenuCommand(int cmdID, int source) {
 		break;
 
 	case IDM_STOPEXECUTE:
+		if (!bufferReplacer.Complete()) {
+			StopReplaceInBuffers();
+		}
 		StopExecute();
 		break;
 
@@ -3961,6 +4281,10 @@ void SciTEBase::UpdateUI(const SCNotification *notification) {
 	if (CurrentBuffer()->findMarks == Buffer::FindMarks::modified) {
 		RemoveFindMarks();
 	}
+	if (notification->nmhdr.idFrom == IDM_SRCWIN) {
+		// Restarts counting after switching document or an edit that could not be followed
+		CountMatches();
+	}
 	const SA::Update updated = static_cast<SA::Update>(notification->updated);
 	if (FlagIsSet(updated, SA::Update::Selection) || FlagIsSet(updated, SA::Update::Content)) {
 		if ((notification->nmhdr.idFrom == IDM_SRCWIN) == (pwFocussed == &wEditor)) {
@@ -4000,25 +4324,64 @@ void SciTEBase::CheckCanUndoRedo() {
 	SetCanUndoRedo(canUndoNow, canRedoNow);
 }
 
+void SciTEBase::TextChanged(const SA::IDocumentEditable *documentChanged) noexcept {
+	matchMarker.TextChanged(documentChanged);
+	findMarker.TextChanged(documentChanged);
+	countMarker.TextChanged(documentChanged);
+}
+
 void SciTEBase::Modified(const SCNotification *notification) {
 	const SA::ModificationFlags modificationType =
 		static_cast<SA::ModificationFlags>(notification->modificationType);
 	const bool textWasModified = FlagIsSet(modificationType, SA::ModificationFlags::InsertText) ||
 		FlagIsSet(modificationType, SA::ModificationFlags::DeleteText);
-	if ((notification->nmhdr.idFrom == IDM_SRCWIN) && textWasModified)
+	if ((notification->nmhdr.idFrom == IDM_SRCWIN) && textWasModified) {
 		CurrentBuffer()->DocumentModified();
+		// Words are maintained for every step including the last step of undo or redo
+		const std::shared_ptr<WordIndex> &wordIndex = CurrentBuffer()->wordIndex;
+		if (autoCompleteWordIndex && wordIndex) {
+			const bool inserted = FlagIsSet(modificationType, SA::ModificationFlags::InsertText);
+			wordIndex->Modified(&wEditor, notification->position,
+				inserted ? notification->length : 0, inserted ? 0 : notification->length, notification->text);
+			if (!wordIndex->Complete()) {
+				SetIdler(true);
+			}
+		}
+	}
+	if (textWasModified) {
+		// Copies of the text kept for searching are now out of date
+		GUI::ScintillaWindow &wChanged = (notification->nmhdr.idFrom == IDM_SRCWIN) ? wEditor : wOutput;
+		TextChanged(wChanged.DocPointer());
+	}
 	if (FlagIsSet(modificationType, SA::ModificationFlags::LastStepInUndoRedo)) {
 		// When the user hits undo or redo, several normal insert/delete
 		// notifications may fire, but we will end up here in the end
 		CheckCanUndoRedo();
 	} else if (textWasModified) {
-		if ((notification->nmhdr.idFrom == IDM_SRCWIN) == (pwFocussed == &wEditor)) {
+		const SA::Position lengthInserted = FlagIsSet(modificationType, SA::ModificationFlags::InsertText) ?
+			notification->length : 0;
+		const SA::Position lengthDeleted = FlagIsSet(modificationType, SA::ModificationFlags::DeleteText) ?
+			notification->length : 0;
+		GUI::ScintillaWindow &wModified = (notification->nmhdr.idFrom == IDM_SRCWIN) ? wEditor : wOutput;
+		// Matches are maintained by searching the changed lines again when idle
+		if (matchMarker.Modified(&wModified, notification->position, lengthInserted, lengthDeleted)) {
+			SetIdler(true);
+		} else if ((notification->nmhdr.idFrom == IDM_SRCWIN) == (pwFocussed == &wEditor)) {
 			currentWordHighlight.textHasChanged = true;
 		}
 		// This will be called a lot, and usually means "typing".
 		SetCanUndoRedo(true, false);
+		if ((notification->nmhdr.idFrom == IDM_SRCWIN) &&
+			countMarker.Modified(&wEditor, notification->position, lengthInserted, lengthDeleted)) {
+			SetIdler(true);
+		}
 		if (CurrentBuffer()->findMarks == Buffer::FindMarks::marked) {
-			CurrentBuffer()->findMarks = Buffer::FindMarks::modified;
+			if ((notification->nmhdr.idFrom == IDM_SRCWIN) &&
+				findMarker.Modified(&wEditor, notification->position, lengthInserted, lengthDeleted)) {
+				SetIdler(true);
+			} else {
+				CurrentBuffer()->findMarks = Buffer::FindMarks::modified;
+			}
 		}
 	}
 
@@ -4033,10 +4396,38 @@ void SciTEBase::Modified(const SCNotification *notification) {
 	}
 }
 
+/**
+ * Finish the startup profile at the first paint. When the startup.profile property is set,
+ * such as by the -startup.profile command line switch, show the profile in the output pane.
+ * When startup.profile.file is set write it to that file as tab separated values.
+ */
+void SciTEBase::ReportStartupProfile() {
+	PhaseProfile &profile = PhaseProfile::Startup();
+	profile.Mark("FirstPaint");
+	const std::string fileName = props.GetExpandedString("startup.profile.file");
+	if (!props.GetInt("startup.profile") && fileName.empty()) {
+		profile.Stop(false);
+		return;
+	}
+	profile.Stop(true);
+	OutputAppendString(profile.Report());
+	if (!fileName.empty()) {
+		const FilePath path = FilePath(GUI::StringFromUTF8(fileName)).AbsolutePath();
+		FileHolder fp(path.Open(fileWrite));
+		const std::string table = profile.Tabulated();
+		if (!fp || (fwrite(table.data(), 1, table.length(), fp.get()) != table.length())) {
+			OutputAppendString("Could not write startup profile to " + path.AsUTF8() + "\n");
+		}
+	}
+}
+
 void SciTEBase::Notify(SCNotification *notification) {
 	bool handled = false;
 	switch (static_cast<SA::Notification>(notification->nmhdr.code)) {
 	case SA::Notification::Painted:
+		if ((notification->nmhdr.idFrom == IDM_SRCWIN) && PhaseProfile::Startup().Recording()) {
+			ReportStartupProfile();
+		}
 		if ((notification->nmhdr.idFrom == IDM_SRCWIN) == (pwFocussed == &wEditor)) {
 			// Only highlight focused pane.
 			// Manage delay before highlight when no user selection but there is word at the caret.
@@ -4226,8 +4617,8 @@ void SciTEBase::CheckMenus() {
 	CheckMenusClipboard();
 	CheckCanUndoRedo();
 	EnableAMenuItem(IDM_DUPLICATE, !CurrentBuffer()->isReadOnly);
-	EnableAMenuItem(IDM_SHOWCALLTIP, apis != 0);
-	EnableAMenuItem(IDM_COMPLETE, apis != 0);
+	EnableAMenuItem(IDM_SHOWCALLTIP, apis->Length() != 0);
+	EnableAMenuItem(IDM_COMPLETE, apis->Length() != 0);
 	CheckAMenuItem(IDM_SPLITVERTICAL, splitVertical);
 	EnableAMenuItem(IDM_OPENFILESHERE, props.GetInt("check.if.already.open") != 0);
 	CheckAMenuItem(IDM_OPENFILESHERE, openFilesHere);
@@ -4258,7 +4649,7 @@ void SciTEBase::CheckMenus() {
 	EnableAMenuItem(IDM_OPENDIRECTORYPROPERTIES, props.GetInt("properties.directory.enable") != 0);
 	for (int toolItem = 0; toolItem < toolMax; toolItem++)
 		EnableAMenuItem(IDM_TOOLS + toolItem, ToolIsImmediate(toolItem) || !jobQueue.IsExecuting());
-	EnableAMenuItem(IDM_STOPEXECUTE, jobQueue.IsExecuting());
+	EnableAMenuItem(IDM_STOPEXECUTE, jobQueue.IsExecuting() || !bufferReplacer.Complete());
 	if (buffers.size() > 0) {
 		TabSelect(buffers.Current());
 		for (int bufferItem = 0; bufferItem < buffers.lengthVisible; bufferItem++) {
@@ -4382,6 +4773,51 @@ void SciTEBase::OnIdle() {
 		matchMarker.Continue();
 		return;
 	}
+	if (!countMarker.Complete()) {
+		countMarker.Continue();
+		if (countMarker.Complete()) {
+			ShowMatchCount();
+		}
+		return;
+	}
+	if (!bufferReplacer.Complete()) {
+		ContinueReplaceInBuffers(0.05);
+		UpdateProgress(nullptr);
+		return;
+	}
+	if (autoCompleteWordIndex && (CurrentBuffer()->lifeState != Buffer::LifeState::reading)) {
+		std::shared_ptr<WordIndex> &wordIndex = CurrentBuffer()->wordIndex;
+		if (!wordIndex) {
+			wordIndex = std::make_shared<WordIndex>();
+		}
+		if (!wordIndex->Indexing(&wEditor, wordCharacters)) {
+			wordIndex->Start(&wEditor, wordCharacters);
+		}
+		if (!wordIndex->Complete()) {
+			wordIndex->Continue(&wEditor, 0.05);
+			return;
+		}
+	}
+	if (autoCompleteWordIndex && autoCompleteWordBuffers && wReplacer.CanCall()) {
+		// Other documents are indexed through wReplacer which is unused once replacing is complete
+		for (BufferIndex i = 0; i < buffers.length; i++) {
+			Buffer &buffer = buffers.buffers[i];
+			if ((i != buffers.Current()) && buffer.doc && (buffer.lifeState != Buffer::LifeState::reading)) {
+				if (!buffer.wordIndex) {
+					buffer.wordIndex = std::make_shared<WordIndex>();
+				}
+				if (!buffer.wordIndex->Indexed(buffer.doc.get())) {
+					wReplacer.SetDocPointer(buffer.doc.get());
+					if (!buffer.wordIndex->Indexing(&wReplacer, wordCharacters)) {
+						buffer.wordIndex->Start(&wReplacer, wordCharacters);
+					}
+					buffer.wordIndex->Continue(&wReplacer, 0.05);
+					wReplacer.SetDocPointer(nullptr);
+					return;
+				}
+			}
+		}
+	}
 	SetIdler(false);
 }
 
@@ -4490,6 +4926,8 @@ void SciTEBase::PerformOne(std::string_view action) {
 			wOutput.ReplaceSel(arg);
 		} else if (cmd == "property") {
 			PropertyFromDirector(arg);
+		} else if (cmd == "propertystatistics") {
+			ShowPropertyStatistics(argument);
 		} else if (cmd == "reloadproperties") {
 			ReloadProperties();
 		} else if (cmd == "quit") {
@@ -4788,6 +5226,7 @@ void SciTEBase::ExecuteMacroCommand(const char *command) {
  */
 
 bool SciTEBase::ProcessCommandLine(const std::vector<GUI::gui_string> &args, int phase) {
+	const PhaseTimer timer("ProcessCommandLine", (phase == 0) ? "switches" : "files");
 	bool performPrint = false;
 	bool evaluate = phase == 0;
 	for (size_t i = 0; i < args.size(); i++) {
@@ -4805,7 +5244,8 @@ bool SciTEBase::ProcessCommandLine(const std::vector<GUI::gui_string> &args, int
 			} else if (arg == GUI_TEXT("p") || arg == GUI_TEXT("P")) {
 				performPrint = true;
 			} else if (arg == GUI_TEXT("grep") && (args.size() - i >= 5) && (args[i+1].size() >= 4)) {
-				// in form -grep [w~][c~][d~][b~] "<file-patterns>" "<excluded-patterns>" "<search-string>"
+				// in form -grep [w~][c~][d~][b~][r~][p~][i~][g~][s~][:size:depth] "<file-patterns>" "<excluded-patterns>" "<search-string>" ["<replacement>"]
+				// where the flags after [b~] and the limits are optional and the replacement is present with [s]
 				GrepFlags gf = GrepFlags::stdOut;
 				if (args[i+1][0] == 'w')
 					gf = gf | GrepFlags::wholeWord;
@@ -4815,10 +5255,32 @@ bool SciTEBase::ProcessCommandLine(const std::vector<GUI::gui_string> &args, int
 					gf = gf | GrepFlags::dot;
 				if (args[i+1][3] == 'b')
 					gf = gf | GrepFlags::binary;
+				if (args[i+1].size() >= 6) {
+					if (args[i+1][4] == 'r')
+						gf = gf | GrepFlags::regularExpression;
+					if (args[i+1][5] == 'p')
+						gf = gf | GrepFlags::posix;
+				}
+				if ((args[i+1].size() >= 7) && (args[i+1][6] == 'i'))
+					gf = gf | GrepFlags::index;
+				if ((args[i+1].size() >= 8) && (args[i+1][7] == 'g'))
+					gf = gf | GrepFlags::ignoreFiles;
+				size_t endFlags = 8;
+				if ((args[i+1].size() >= 9) && ((args[i+1][8] == 's') || (args[i+1][8] == '~'))) {
+					if ((args[i+1][8] == 's') && (args.size() - i >= 6))
+						gf = gf | GrepFlags::replace;
+					endFlags = 9;
+				}
+				const std::string flagsText = GUI::UTF8FromString(args[i+1]);
+				const GrepLimits limits = GrepLimitsFromText(flagsText.substr(std::min<size_t>(flagsText.size(), endFlags)));
 				std::string sSearch = GUI::UTF8FromString(args[i+4]);
 				std::string unquoted = UnSlashString(sSearch);
+				std::string replacement;
+				if (FlagIsSet(gf, GrepFlags::replace)) {
+					replacement = UnSlashString(GUI::UTF8FromString(args[i+5]));
+				}
 				SA::Position originalEnd = 0;
-				InternalGrep(gf, FilePath::GetWorkingDirectory(), args[i+2], args[i+3], unquoted, originalEnd);
+				InternalGrep(gf, limits, FilePath::GetWorkingDirectory(), args[i+2], args[i+3], unquoted, replacement, originalEnd);
 				exit(0);
 			} else {
 				if (AfterName(arg) == ':') {
@@ -4961,4 +5423,6 @@ void SciTEBase::SetFindInFilesOptions() {
 	props.Set("find.wholeword", props.GetNewExpandString(wholeWordName));
 	const std::string matchCaseName = std::string("find.option.matchcase.") + StdStringFromInteger(matchCase);
 	props.Set("find.matchcase", props.GetNewExpandString(matchCaseName));
+	const std::string regExpName = std::string("find.option.regexp.") + StdStringFromInteger(regExp);
+	props.Set("find.regexp", props.GetNewExpandString(regExpName));
 }
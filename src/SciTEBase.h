@@ -77,6 +77,8 @@ public:
 };
 
 struct FileWorker;
+class WordIndex;
+class DirectoryWords;
 
 // Scintilla documents can only be released by calling a method on a Scintilla
 // instance so store a Scintilla instance in the release functor
@@ -104,6 +106,8 @@ public:
 	std::vector<SA::Line> foldState;
 	std::vector<SA::Line> bookmarks;
 	std::unique_ptr<FileWorker> pFileWorker;
+	// Created when the document is first indexed.
+	std::shared_ptr<WordIndex> wordIndex;
 	PropSetFile props;
 	enum class FutureDo { none=0, finishSave=1 } futureDo;
 	Buffer();
@@ -290,9 +294,22 @@ enum class GrepFlags {
 	stdOut = 4,
 	dot = 8,
 	binary = 16,
-	scroll = 32
+	scroll = 32,
+	regularExpression = 64,
+	posix = 128,
+	index = 256,
+	ignoreFiles = 512,
+	replace = 1024
 };
 
+/// Limits for Find in Files passed after the GrepFlags characters as ":maxFileSize:maxDepth".
+struct GrepLimits {
+	long long maxFileSize = 0;
+	int maxDepth = -1;
+};
+
+GrepLimits GrepLimitsFromText(std::string_view text);
+
 constexpr GrepFlags operator|(GrepFlags a, GrepFlags b) noexcept {
 	return static_cast<GrepFlags>(static_cast<int>(a) | static_cast<int>(b));
 }
@@ -353,8 +370,11 @@ protected:
 	int lexLanguage;
 	std::vector<std::string> monospacedList;
 	std::string subStyleBases;
-	StringList apis;
+	std::shared_ptr<StringList> apis;
 	std::string apisFileNames;
+	// Lists of recently used API files, most recent first, so they are not read again
+	// when moving between languages. Identified by the name, time and length of each file.
+	std::vector<std::pair<std::string, std::shared_ptr<StringList>>> apisRecent;
 	std::string functionDefinition;
 
 	int diagnosticStyleStart;
@@ -381,6 +401,7 @@ protected:
 	GUI::Window wContent;    ///< Contains wEditor and wOutput
 	GUI::ScintillaWindow wEditor;
 	GUI::ScintillaWindow wOutput;
+	GUI::ScintillaWindow wReplacer;	///< Not shown, replaces in buffers that are not current
 	GUI::ScintillaWindow *pwFocussed;
 	GUI::Window wIncrement;
 	GUI::Window wToolBar;
@@ -442,6 +463,14 @@ protected:
 	int indentationWSVisible;
 	SA::IndentView indentExamine;
 	bool autoCompleteIgnoreCase;
+	bool autoCompleteFuzzy;
+	bool autoCompleteWordIndex;
+	bool autoCompleteWordBuffers;
+	bool autoCompleteWordDirectory;
+	// Words of the other files in the directory of the current file.
+	std::shared_ptr<DirectoryWords> directoryWords;
+	// The fuzzy list shown, if any, so it can be ranked again as characters are typed
+	enum class FuzzyList { none, api, word } fuzzyListShown;
 	bool imeAutoComplete;
 	bool callTipUseEscapes;
 	bool callTipIgnoreCase;
@@ -575,6 +604,7 @@ protected:
 	void CreateBuffers();
 	void InitialiseBuffers();
 	FilePath UserFilePath(const GUI::gui_char *name);
+	FilePath UserIndexFilePath(const GUI::gui_char *prefix, std::string_view identity);
 	void LoadSessionFile(const GUI::gui_char *sessionName);
 	void RestoreRecentMenu();
 	void RestoreFromSession(const Session &session);
@@ -725,9 +755,14 @@ protected:
 	virtual void FindInFiles() = 0;
 	virtual void Replace() = 0;
 	void ReplaceOnce(bool showWarnings=true) override;
+	intptr_t ReplaceAllFixed(const std::string &findTarget, const std::string &replaceTarget,
+		SA::Span &rangeSearch, SA::Position &lastMatch);
 	intptr_t DoReplaceAll(bool inSelection); // returns number of replacements or negative value if error
 	intptr_t ReplaceAll(bool inSelection) override;
 	intptr_t ReplaceInBuffers();
+	void ContinueReplaceInBuffers(double duration);
+	void StopReplaceInBuffers();
+	void ReplacedInBuffers(intptr_t replacements);
 	void SetFindInFilesOptions();
 	void UIClosed() override;
 	void UIHasFocus() override;
@@ -755,7 +790,9 @@ protected:
 	virtual void FillFunctionDefinition(SA::Position pos = -1);
 	void ContinueCallTip();
 	std::string EliminateDuplicateWords(const std::string &words);
+	void ShowAutoComplete(SA::Position lenEntered, const std::string &list, char separator, FuzzyList fuzzy);
 	virtual bool StartAutoComplete();
+	void IndexDirectoryWords();
 	virtual bool StartAutoCompleteWord(bool onlyOneWord);
 	virtual bool StartExpandAbbreviation();
 	bool PerformInsertAbbreviation();
@@ -808,7 +845,10 @@ protected:
 	void UpdateUI(const SCNotification *notification);
 	void SetCanUndoRedo(bool canUndo_, bool canRedo_);
 	void CheckCanUndoRedo();
+	/// Copies of the text of documentChanged kept by markers are out of date.
+	void TextChanged(const SA::IDocumentEditable *documentChanged) noexcept;
 	void Modified(const SCNotification *notification);
+	void ReportStartupProfile();
 	virtual void Notify(SCNotification *notification);
 	virtual void ShowToolBar() = 0;
 	virtual void ShowTabBar() = 0;
@@ -928,11 +968,10 @@ protected:
 	virtual bool IsStdinBlocked() noexcept;
 	void OpenFromStdin(bool UseOutputPane);
 	void OpenFilesFromStdin();
-	virtual bool GrepIntoDirectory(const FilePath &directory);
-	void GrepRecursive(GrepFlags gf, const FilePath &baseDir, const char *searchString,
-		GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes);
-	void InternalGrep(GrepFlags gf, const FilePath &directory, GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
-			  std::string_view search, SA::Position &originalEnd);
+	std::string GrepLimitsText() const;
+	void InternalGrep(GrepFlags gf, const GrepLimits &limits, const FilePath &directory,
+			  GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
+			  std::string_view search, std::string_view replacement, SA::Position &originalEnd);
 	void EnumProperties(const char *propkind);
 	void SendOneProperty(const char *kind, const char *key, const char *val);
 	void PropertyFromDirector(const char *arg);
@@ -951,6 +990,9 @@ protected:
 	void Perform(const char *actionList) override;
 	void DoMenuCommand(int cmdID) override;
 	SA::ScintillaCall &PaneCaller(Pane p) noexcept override;
+	std::vector<SA::Line> FindMatchLines() override;
+	std::vector<PropertyStatistic> PropertyStatistics() override;
+	void ShowPropertyStatistics(std::string_view count);
 
 	// Valid CurrentWord characters
 	bool iswordcharforsel(char ch) noexcept;
@@ -961,6 +1003,13 @@ protected:
 	void HighlightCurrentWord(bool highlight);
 	MatchMarker matchMarker;
 	MatchMarker findMarker;
+	// Counts matches of the find text without marking them.
+	MatchMarker countMarker;
+	bool findCount = false;
+	void CountMatches();
+	void ShowMatchCount();
+	BufferReplacer bufferReplacer;
+	intptr_t replacementsBeforeBackground = 0;
 public:
 
 	enum { maxParam = 4 };
@@ -25,6 +25,7 @@
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <thread>
 
 #include "ILoader.h"
 
@@ -39,6 +40,7 @@
 #include "StringList.h"
 #include "StringHelpers.h"
 #include "FilePath.h"
+#include "PhaseProfile.h"
 #include "StyleDefinition.h"
 #include "PropSetFile.h"
 #include "StyleWriter.h"
@@ -50,6 +52,7 @@
 #include "Utf8_16.h"
 #include "FileWorker.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
 
@@ -86,6 +89,7 @@ void Buffer::Init() {
 	foldState.clear();
 	bookmarks.clear();
 	pFileWorker.reset();
+	wordIndex.reset();
 	futureDo = FutureDo::none;
 	doc.reset();
 }
@@ -596,6 +600,20 @@ FilePath SciTEBase::UserFilePath(const GUI::gui_char *name) {
 	return FilePath(GetSciteUserHome(), nameWithVisibility.c_str());
 }
 
+FilePath SciTEBase::UserIndexFilePath(const GUI::gui_char *prefix, std::string_view identity) {
+	// Named by a hash of identity so each identity has its own index
+	uint32_t hash = 2166136261U;
+	for (const unsigned char ch : identity) {
+		hash = (hash ^ ch) * 16777619U;
+	}
+	char hashText[16];
+	snprintf(hashText, sizeof(hashText), "%08x", hash);
+	GUI::gui_string indexName = prefix;
+	indexName += GUI::StringFromUTF8(hashText);
+	indexName += GUI_TEXT(".index");
+	return UserFilePath(indexName.c_str());
+}
+
 static std::string IndexPropKey(const char *bufPrefix, BufferIndex bufIndex, const char *bufAppendix) {
 	std::string pKey = bufPrefix;
 	pKey += '.';
@@ -608,6 +626,7 @@ static std::string IndexPropKey(const char *bufPrefix, BufferIndex bufIndex, con
 }
 
 void SciTEBase::LoadSessionFile(const GUI::gui_char *sessionName) {
+	const PhaseTimer timer("LoadSessionFile");
 	FilePath sessionPathName;
 	if (sessionName[0] == '\0') {
 		sessionPathName = UserFilePath(defaultSessionFileName);
@@ -680,6 +699,7 @@ void SciTEBase::RestoreFromSession(const Session &session) {
 }
 
 void SciTEBase::RestoreSession() {
+	const PhaseTimer timer("RestoreSession");
 	if (props.GetInt("save.find") != 0) {
 		for (int i = 0;; i++) {
 			const std::string propKey = IndexPropKey("search", i, "findwhat");
@@ -51,7 +51,9 @@
 #include "Worker.h"
 #include "Utf8_16.h"
 #include "FileWorker.h"
+#include "Grep.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
 
@@ -368,6 +370,10 @@ void SciTEBase::TextRead(FileWorker *pFileWorker) {
 			pFileLoader->pLoader->ConvertToDocument());
 		pFileLoader->pLoader = nullptr;
 		SwitchDocumentAt(iBuffer, pdocLoading);
+		if (autoCompleteWordBuffers) {
+			// Index the words of the document for other buffers
+			SetIdler(true);
+		}
 		if (iBuffer == buffers.Current()) {
 			CompleteOpen(OpenCompletion::completeCurrent);
 			if (extender)
@@ -510,7 +516,8 @@ void SciTEBase::TextWritten(FileWorker *pFileWorker) {
 void SciTEBase::UpdateProgress(Worker *) {
 	BackgroundActivities bgActivities = buffers.CountBackgroundActivities();
 	const int countBoth = bgActivities.loaders + bgActivities.storers;
-	if (countBoth == 0) {
+	const bool replacing = !bufferReplacer.Complete();
+	if ((countBoth == 0) && !replacing) {
 		// Should hide UI
 		ShowBackgroundProgress(GUI_TEXT(""), 0, 0);
 	} else {
@@ -526,6 +533,14 @@ void SciTEBase::UpdateProgress(Worker *) {
 				prog += LocaliseMessage("Saving ^0 files ", GUI::StringFromInteger(bgActivities.storers).c_str());
 			}
 		}
+		if (replacing) {
+			prog += LocaliseMessage("Replacing in ^0 buffers ",
+						GUI::StringFromInteger(static_cast<int>(bufferReplacer.Total() - bufferReplacer.Progress())).c_str());
+			if (countBoth == 0) {
+				bgActivities.totalWork = bufferReplacer.Total();
+				bgActivities.totalProgress = bufferReplacer.Progress();
+			}
+		}
 		ShowBackgroundProgress(prog, bgActivities.totalWork, bgActivities.totalProgress);
 	}
 }
@@ -1442,182 +1457,41 @@ void SciTEBase::OpenFilesFromStdin() {
 		Open(FilePath());
 }
 
-class BufferedFile {
-	FileHolder fp;
-	bool readAll;
-	bool exhausted;
-	enum {bufLen = 64 * 1024};
-	char buffer[bufLen];
-	size_t pos;
-	size_t valid;
-	void EnsureData() noexcept {
-		if (pos >= valid) {
-			if (readAll || !fp) {
-				exhausted = true;
-			} else {
-				valid = fread(buffer, 1, bufLen, fp.get());
-				if (valid < bufLen) {
-					readAll = true;
-				}
-				pos = 0;
-			}
-		}
-	}
-public:
-	explicit BufferedFile(const FilePath &fPath) : fp(fPath.Open(fileRead)) {
-		readAll = false;
-		exhausted = !fp;
-		buffer[0] = 0;
-		pos = 0;
-		valid = 0;
-	}
-	bool Exhausted() const noexcept {
-		return exhausted;
-	}
-	char NextByte() noexcept {
-		EnsureData();
-		if (pos >= valid) {
-			return 0;
-		}
-		return buffer[pos++];
-	}
-	bool BufferContainsNull() noexcept {
-		EnsureData();
-		for (size_t i = 0; i < valid; i++) {
-			if (buffer[i] == '\0')
-				return true;
-		}
-		return false;
-	}
-};
-
-class FileReader {
-	std::unique_ptr<BufferedFile> bf;
-	int lineNum;
-	bool lastWasCR;
-	std::string lineToCompare;
-	std::string lineToShow;
-	bool caseSensitive;
-public:
-	FileReader(const FilePath &fPath, bool caseSensitive_) : bf(std::make_unique<BufferedFile>(fPath)) {
-		lineNum = 0;
-		lastWasCR = false;
-		caseSensitive = caseSensitive_;
-	}
-	// Deleted so FileReader objects can not be copied.
-	FileReader(const FileReader &) = delete;
-	const char *Next() {
-		if (bf->Exhausted()) {
-			return nullptr;
-		}
-		lineToShow.clear();
-		while (!bf->Exhausted()) {
-			const char ch = bf->NextByte();
-			if (lastWasCR && ch == '\n' && lineToShow.empty()) {
-				lastWasCR = false;
-			} else if (ch == '\r' || ch == '\n') {
-				lastWasCR = ch == '\r';
-				break;
-			} else {
-				lineToShow.push_back(ch);
-			}
-		}
-		lineNum++;
-		lineToCompare = lineToShow;
-		if (!caseSensitive) {
-			LowerCaseAZ(lineToCompare);
+GrepLimits GrepLimitsFromText(std::string_view text) {
+	GrepLimits limits;
+	if (StartsWith(text, ":")) {
+		text.remove_prefix(1);
+		const size_t separator = text.find(':');
+		limits.maxFileSize = LongLongFromString(std::string(text.substr(0, separator)), 0);
+		if (separator != std::string_view::npos) {
+			limits.maxDepth = IntegerFromString(std::string(text.substr(separator + 1)), -1);
 		}
-		return lineToCompare.c_str();
-	}
-	int LineNumber() const noexcept {
-		return lineNum;
-	}
-	const char *Original() const noexcept {
-		return lineToShow.c_str();
-	}
-	bool BufferContainsNull() noexcept {
-		return bf->BufferContainsNull();
 	}
-};
-
-constexpr bool IsWordCharacter(int ch) noexcept {
-	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')  || (ch >= '0' && ch <= '9')  || (ch == '_');
-}
-
-bool SciTEBase::GrepIntoDirectory(const FilePath &directory) {
-	const GUI::gui_char *sDirectory = directory.AsInternal();
-	return sDirectory[0] != '.';
+	return limits;
 }
 
-void SciTEBase::GrepRecursive(GrepFlags gf, const FilePath &baseDir, const char *searchString,
-	GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes) {
-	constexpr int checkAfterLines = 10'000;
-	FilePathSet directories;
-	FilePathSet files;
-	baseDir.List(directories, files);
-	const size_t searchLength = strlen(searchString);
-	std::string os;
-	for (const FilePath &fPath : files) {
-		if (jobQueue.Cancelled())
-			return;
-		if ((fileTypes.empty() || fPath.Matches(fileTypes)) &&
-			((excludedTypes.empty() || !fPath.Matches(excludedTypes)))) {
-			//OutputAppendStringSynchronised(fPath.AsUTF8());
-			//OutputAppendStringSynchronised("\n");
-			FileReader fr(fPath, FlagIsSet(gf, GrepFlags::matchCase));
-			if (FlagIsSet(gf, GrepFlags::binary) || !fr.BufferContainsNull()) {
-				while (const char *line = fr.Next()) {
-					if (((fr.LineNumber() % checkAfterLines) == 0) && jobQueue.Cancelled())
-						return;
-					const char *match = strstr(line, searchString);
-					if (match) {
-						if (FlagIsSet(gf, GrepFlags::wholeWord)) {
-							const char *lineEnd = line + strlen(line);
-							while (match) {
-								if (((match == line) || !IsWordCharacter(match[-1])) &&
-										((match + searchLength == (lineEnd)) || !IsWordCharacter(match[searchLength]))) {
-									break;
-								}
-								match = strstr(match + 1, searchString);
-							}
-						}
-						if (match) {
-							os.append(fPath.AsUTF8());
-							os.append(":");
-							std::string lNumber = StdStringFromInteger(fr.LineNumber());
-							os.append(lNumber);
-							os.append(":");
-							os.append(fr.Original());
-							os.append("\n");
-						}
-					}
-				}
-			}
-		}
-	}
-	if (os.length()) {
-		if (FlagIsSet(gf, GrepFlags::stdOut)) {
-			fwrite(os.c_str(), os.length(), 1, stdout);
-		} else {
-			OutputAppendStringSynchronised(os);
-		}
-	}
-	for (const FilePath &fPath : directories) {
-		if (FlagIsSet(gf, GrepFlags::dot) || GrepIntoDirectory(fPath.Name())) {
-			if ((excludedTypes.empty() || !fPath.Matches(excludedTypes))) {
-				GrepRecursive(gf, fPath, searchString, fileTypes, excludedTypes);
-			}
-		}
+// Empty when there are no limits so the flags stay short.
+std::string SciTEBase::GrepLimitsText() const {
+	const long long maxFileSize = props.GetLongLong("find.in.files.max.size");
+	const int maxDepth = props.GetInt("find.in.files.max.depth", -1);
+	if ((maxFileSize <= 0) && (maxDepth < 0)) {
+		return {};
 	}
+	return ":" + std::to_string(maxFileSize) + ":" + std::to_string(maxDepth);
 }
 
-void SciTEBase::InternalGrep(GrepFlags gf, const FilePath &directory, GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
-	std::string_view search, SA::Position &originalEnd) {
+void SciTEBase::InternalGrep(GrepFlags gf, const GrepLimits &limits, const FilePath &directory,
+	GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
+	std::string_view search, std::string_view replacement, SA::Position &originalEnd) {
 	GUI::ElapsedTime commandTime;
 	if (!FlagIsSet(gf, GrepFlags::stdOut)) {
 		std::string os;
-		os.append(">Internal search for \"");
+		os.append(FlagIsSet(gf, GrepFlags::replace) ? ">Internal replace of \"" : ">Internal search for \"");
 		os.append(search);
+		if (FlagIsSet(gf, GrepFlags::replace)) {
+			os.append("\" with \"");
+			os.append(replacement);
+		}
 		os.append("\" in \"");
 		os.append(GUI::UTF8FromString(fileTypes));
 		os.append("\"\n");
@@ -1625,11 +1499,42 @@ void SciTEBase::InternalGrep(GrepFlags gf, const FilePath &directory, GUI::gui_s
 		ShowOutputOnMainThread();
 		originalEnd += os.length();
 	}
-	std::string searchString(search);
-	if (!FlagIsSet(gf, GrepFlags::matchCase)) {
-		LowerCaseAZ(searchString);
-	}
-	GrepRecursive(gf, directory, searchString.c_str(), fileTypes, excludedTypes);
+	GrepOptions options;
+	options.wholeWord = FlagIsSet(gf, GrepFlags::wholeWord);
+	options.matchCase = FlagIsSet(gf, GrepFlags::matchCase);
+	options.dot = FlagIsSet(gf, GrepFlags::dot);
+	options.binary = FlagIsSet(gf, GrepFlags::binary);
+	options.regularExpression = FlagIsSet(gf, GrepFlags::regularExpression);
+	options.posix = FlagIsSet(gf, GrepFlags::posix);
+	options.ignoreFiles = FlagIsSet(gf, GrepFlags::ignoreFiles);
+	options.maxFileSize = limits.maxFileSize;
+	options.maxDepth = limits.maxDepth;
+	options.replace = FlagIsSet(gf, GrepFlags::replace);
+	options.replacement = replacement;
+	if (FlagIsSet(gf, GrepFlags::index)) {
+		// One index for each searched directory
+		options.indexFile = UserIndexFilePath(GUI_TEXT("SciTEFind"), directory.AbsolutePath().AsUTF8());
+	}
+	// Local class so it can use the protected output method
+	class GrepOutputPane : public GrepOutput {
+		SciTEBase *pSciTE;
+		bool toStdOut;
+	public:
+		GrepOutputPane(SciTEBase *pSciTE_, bool toStdOut_) noexcept : pSciTE(pSciTE_), toStdOut(toStdOut_) {
+		}
+		void Output(std::string_view text) override {
+			if (toStdOut) {
+				fwrite(text.data(), text.length(), 1, stdout);
+			} else {
+				pSciTE->OutputAppendStringSynchronised(text);
+			}
+		}
+		bool Cancelled() noexcept override {
+			return pSciTE->jobQueue.Cancelled();
+		}
+	};
+	GrepOutputPane output(this, FlagIsSet(gf, GrepFlags::stdOut));
+	Grep(options, directory, fileTypes, excludedTypes, search, output);
 	if (!FlagIsSet(gf, GrepFlags::stdOut)) {
 		std::string sExitMessage(">");
 		if (jobQueue.TimeCommands()) {
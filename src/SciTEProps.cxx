@@ -26,6 +26,7 @@
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <thread>
 
 #include <fcntl.h>
 
@@ -56,8 +57,10 @@ const GUI::gui_char menuAccessIndicator[] = GUI_TEXT("&");
 #include "StringList.h"
 #include "StringHelpers.h"
 #include "FilePath.h"
+#include "PhaseProfile.h"
 #include "StyleDefinition.h"
 #include "PropSetFile.h"
+#include "PropSetSnapshot.h"
 #include "StyleWriter.h"
 #include "Extender.h"
 #include "SciTE.h"
@@ -65,6 +68,7 @@ const GUI::gui_char menuAccessIndicator[] = GUI_TEXT("&");
 #include "Cookie.h"
 #include "Worker.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
 #include "EditorConfig.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
@@ -115,6 +119,7 @@ void SciTEBase::ReadEmbeddedProperties() {
 
 const GUI::gui_char propLocalFileName[] = GUI_TEXT("SciTE.properties");
 const GUI::gui_char propDirectoryFileName[] = GUI_TEXT("SciTEDirectory.properties");
+const GUI::gui_char propSnapshotFileName[] = GUI_TEXT("SciTEProperties.snapshot");
 
 void SciTEBase::ReadEnvironment() {
 #if defined(__unix__) || defined(__APPLE__)
@@ -133,6 +138,7 @@ void SciTEBase::ReadEnvironment() {
 Read global and user properties files.
 */
 void SciTEBase::ReadGlobalPropFile() {
+	const PhaseTimer timer("ReadGlobalPropFile");
 	// Appearance and Contrast may be read in embedded or global properties
 	// so set them in deepest property set propsPlatform.
 	propsPlatform.Set("Appearance", StdStringFromInteger(appearance.dark));
@@ -141,6 +147,12 @@ void SciTEBase::ReadGlobalPropFile() {
 	std::string excludes;
 	std::string includes;
 
+	const FilePath propfileBase = GetDefaultPropertiesFileName();
+	const FilePath propfileUser = GetUserPropertiesFileName();
+	const PropSetSnapshot snapshot(UserFilePath(propSnapshotFileName));
+	const std::string configuration = propfileBase.AsUTF8() + "\n" + propfileUser.AsUTF8();
+	std::vector<PropSetReadRecord> records;
+
 	// Want to apply imports.exclude and imports.include but these may well be in
 	// user properties.
 
@@ -148,25 +160,49 @@ void SciTEBase::ReadGlobalPropFile() {
 
 		std::string excludesRead = props.GetString("imports.exclude");
 		std::string includesRead = props.GetString("imports.include");
-		if ((attempt > 0) && ((excludesRead == excludes) && (includesRead == includes)))
+		const bool lazyRead = props.GetInt("imports.lazy");
+		if ((attempt > 0) && ((excludesRead == excludes) && (includesRead == includes) && (lazyRead == filter.lazy)))
 			break;
 
 		excludes = excludesRead;
 		includes = includesRead;
 
 		filter.SetFilter(excludes, includes);
+		filter.lazy = lazyRead;
 
 		importFiles.clear();
 
 		ReadEmbeddedProperties();
 
+		// Snapshots are only saved when read with the filter they contain
+		if ((attempt == 0) && snapshot.Load(configuration, { &propsBase, &propsUser }, importFiles)) {
+			excludes = props.GetString("imports.exclude");
+			includes = props.GetString("imports.include");
+			filter.SetFilter(excludes, includes);
+			filter.lazy = props.GetInt("imports.lazy");
+			records.clear();
+			break;
+		}
+		importFiles.clear();
+		records.assign(2, PropSetReadRecord());
+
 		propsBase.Clear();
-		FilePath propfileBase = GetDefaultPropertiesFileName();
+		propsBase.SetRecord(&records[0]);
 		propsBase.Read(propfileBase, propfileBase.Directory(), filter, &importFiles, 0);
+		propsBase.SetRecord(nullptr);
 
 		propsUser.Clear();
-		FilePath propfileUser = GetUserPropertiesFileName();
+		propsUser.SetRecord(&records[1]);
 		propsUser.Read(propfileUser, propfileUser.Directory(), filter, &importFiles, 0);
+		propsUser.SetRecord(nullptr);
+	}
+
+	if (!propsUser.GetInt("properties.snapshot", 1)) {
+		snapshot.Remove();
+	} else if (!records.empty() &&
+		(props.GetString("imports.exclude") == excludes) && (props.GetString("imports.include") == includes) &&
+		(props.GetInt("imports.lazy") == filter.lazy)) {
+		snapshot.Save(configuration, { &propsBase, &propsUser }, records, importFiles);
 	}
 
 	if (!localiser.read) {
@@ -434,22 +470,68 @@ void SciTEBase::DefineMarker(SA::MarkerOutline marker, SA::MarkerSymbol markerTy
 	wEditor.MarkerSetStrokeWidth(markerNumber, markerAppearance.strokeWidth);
 }
 
+namespace {
+
+// API lists kept in memory after moving to another language
+constexpr size_t apisRecentLimit = 4;
+
+}
+
 void SciTEBase::ReadAPI(const std::string &fileNameForExtension) {
+	const PhaseTimer timer("ReadAPI");
+	apis = std::make_shared<StringList>(true);
 	std::string sApiFileNames = props.GetNewExpandString("api.",
 				    fileNameForExtension);
 	if (sApiFileNames.length() > 0) {
 		std::vector<std::string> vApiFileNames = StringSplit(sApiFileNames, ';');
-		std::vector<char> data;
 
-		// Load files into data
+		std::string key;
+		const time_t now = time(nullptr);
+		bool unsettled = false;
 		for (const std::string &vApiFileName : vApiFileNames) {
-			std::string contents = FilePath(GUI::StringFromUTF8(vApiFileName)).Read();
-			data.insert(data.end(), contents.begin(), contents.end());
+			time_t modified = -1;
+			long long length = -1;
+			FilePath(GUI::StringFromUTF8(vApiFileName)).GetModifiedTimeAndLength(modified, length);
+			key += vApiFileName + "\n" + std::to_string(modified) + " " + std::to_string(length) + "\n";
+			unsettled = unsettled || Unsettled(modified, now);
+		}
+
+		auto recent = std::find_if(apisRecent.begin(), apisRecent.end(), [&key](const auto &entry) {
+			return entry.first == key;
+		});
+		if (recent != apisRecent.end()) {
+			apis = recent->second;
+			std::rotate(apisRecent.begin(), recent, recent + 1);
+			return;
+		}
+
+		const FilePath indexFile = UserIndexFilePath(GUI_TEXT("SciTEApi"), sApiFileNames);
+		const bool useIndex = props.GetInt("apis.index", 1);
+		if (!useIndex) {
+			indexFile.Remove();
 		}
+		if (!useIndex || !apis->Load(indexFile, key)) {
+			std::string data;
 
-		// Initialise apis
-		if (data.size() > 0) {
-			apis.Set(data);
+			// Load files into data
+			for (const std::string &vApiFileName : vApiFileNames) {
+				data += FilePath(GUI::StringFromUTF8(vApiFileName)).Read();
+			}
+
+			// Initialise apis, sorting them while the rest of startup continues
+			if (data.size() > 0) {
+				apis->Set(std::move(data));
+				if (useIndex && !unsettled) {
+					apis->IndexInBackground(indexFile, key);
+				} else {
+					apis->IndexInBackground();
+				}
+			}
+		}
+
+		apisRecent.insert(apisRecent.begin(), { key, apis });
+		if (apisRecent.size() > apisRecentLimit) {
+			apisRecent.pop_back();
 		}
 	}
 }
@@ -796,18 +878,24 @@ void SciTEBase::SetRepresentations() {
 }
 
 void SciTEBase::ReadProperties() {
+	const PhaseTimer timer("ReadProperties");
 	if (extender)
 		extender->Clear();
 
-	const std::string lexillaPath = props.GetExpandedString("lexilla.path");
-	Lexilla::Load(lexillaPath.empty() ? "." : lexillaPath);
+	PropSetFile::SetStatistics(props.GetInt("props.stats"));
 
-	std::vector<std::string> libraryProperties = Lexilla::LibraryProperties();
-	for (const std::string &property : libraryProperties) {
-		std::string key("lexilla.context.");
-		key += property;
-		std::string value = props.GetExpandedString(key);
-		Lexilla::SetProperty(property.c_str(), value.c_str());
+	{
+		const std::string lexillaPath = props.GetExpandedString("lexilla.path");
+		const PhaseTimer timerLexilla("Lexilla::Load", lexillaPath);
+		Lexilla::Load(lexillaPath.empty() ? "." : lexillaPath);
+
+		std::vector<std::string> libraryProperties = Lexilla::LibraryProperties();
+		for (const std::string &property : libraryProperties) {
+			std::string key("lexilla.context.");
+			key += property;
+			std::string value = props.GetExpandedString(key);
+			Lexilla::SetProperty(property.c_str(), value.c_str());
+		}
 	}
 
 	const std::string fileNameForExtension = ExtensionFileName();
@@ -819,6 +907,9 @@ void SciTEBase::ReadProperties() {
 	if (static_cast<int>(wEditor.DocumentOptions()) & static_cast<int>(SA::DocumentOption::StylesNone)) {
 		language = "null";
 	}
+	// Files imported lazily define the languages of both panes
+	props.ReadLanguage(language);
+	props.ReadLanguage("errorlist");
 	const std::string languageCurrent = wEditor.LexerLanguage();
 	if (language != languageCurrent) {
 		if (StartsWith(language, "script_")) {
@@ -891,7 +982,6 @@ void SciTEBase::ReadProperties() {
 	}
 
 	if (apisFileNames != props.GetNewExpandString("api.", fileNameForExtension)) {
-		apis.Clear();
 		ReadAPI(fileNameForExtension);
 		apisFileNames = props.GetNewExpandString("api.", fileNameForExtension);
 	}
@@ -995,6 +1085,12 @@ void SciTEBase::ReadProperties() {
 
 	closeFind = static_cast<CloseFind>(props.GetInt("find.close.on.find", 1));
 
+	findCount = props.GetInt("find.count") != 0;
+	if (!findCount && countMarker.Active()) {
+		countMarker.Stop();
+		ShowMatchCount();
+	}
+
 	const std::string controlCharSymbol = props.GetString("control.char.symbol");
 	if (controlCharSymbol.length()) {
 		wEditor.SetControlCharSymbol(static_cast<unsigned char>(controlCharSymbol[0]));
@@ -1155,6 +1251,7 @@ void SciTEBase::ReadProperties() {
 
 	sval = FindLanguageProperty("autocomplete.*.ignorecase");
 	autoCompleteIgnoreCase = sval == "1";
+	autoCompleteFuzzy = FindLanguageProperty("autocomplete.*.fuzzy") == "1";
 	wEditor.AutoCSetIgnoreCase(autoCompleteIgnoreCase);
 	wOutput.AutoCSetIgnoreCase(true);
 	autoCompleteVisibleItemCount = props.GetInt("autocomplete.visible.item.count", 9);
@@ -1363,6 +1460,19 @@ void SciTEBase::ReadProperties() {
 		// insert and delete events.
 	}
 
+	// Words are indexed in the idle loop then maintained from insert and delete events.
+	autoCompleteWordIndex = props.GetInt("autocompleteword.index", 1) && (0 == props.GetInt("undo.redo.lazy"));
+	autoCompleteWordBuffers = props.GetInt("autocompleteword.buffers");
+	autoCompleteWordDirectory = props.GetInt("autocompleteword.directory");
+	IndexDirectoryWords();
+	if (autoCompleteWordIndex) {
+		SetIdler(true);
+	} else {
+		for (Buffer &buffer : buffers.buffers) {
+			buffer.wordIndex.reset();
+		}
+	}
+
 	// Create a margin column for the folding symbols
 	wEditor.SetMarginTypeN(2, SA::MarginType::Symbol);
 
@@ -1512,6 +1622,7 @@ void SciTEBase::ReadProperties() {
 	wEditor.SetCaretSticky(static_cast<SA::CaretSticky>(props.GetInt("caret.sticky", 0)));
 
 	// Clear all previous indicators.
+	matchMarker.Stop();
 	wEditor.SetIndicatorCurrent(indicatorHighlightCurrentWord);
 	wEditor.IndicatorClearRange(0, wEditor.Length());
 	wOutput.SetIndicatorCurrent(indicatorHighlightCurrentWord);
@@ -1882,6 +1993,7 @@ void SciTEBase::ReadLocalization() {
 }
 
 void SciTEBase::ReadPropertiesInitial() {
+	const PhaseTimer timer("ReadPropertiesInitial");
 	SetPropertiesInitial();
 	const int sizeHorizontal = props.GetInt("output.horizontal.size", 0);
 	const int sizeVertical = props.GetInt("output.vertical.size", 0);
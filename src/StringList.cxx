@@ -7,21 +7,29 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstdint>
 #include <cassert>
 #include <cstring>
+#include <cstdio>
 
+#include <system_error>
+#include <limits>
 #include <tuple>
 #include <string>
 #include <string_view>
 #include <vector>
+#include <span>
 #include <map>
 #include <set>
 #include <algorithm>
+#include <memory>
 #include <chrono>
+#include <future>
 
 #include "GUI.h"
 #include "StringList.h"
 #include "StringHelpers.h"
+#include "FilePath.h"
 
 static int CompareNCaseInsensitive(const char *a, const char *b, size_t len) noexcept {
 	while (*a && *b && len) {
@@ -42,134 +50,552 @@ static int CompareNCaseInsensitive(const char *a, const char *b, size_t len) noe
 		return *a - *b;
 }
 
+namespace {
+
+/**
+ * Find the length of a 'word' which is actually an identifier in a string
+ * which looks like "identifier(..." or "identifier" and where
+ * there may be extra spaces after the identifier that should not be
+ * counted in the length.
+ */
+size_t LengthWord(const char *word, char otherSeparator) noexcept {
+	const char *endWord = nullptr;
+	// Find an otherSeparator
+	if (otherSeparator)
+		endWord = strchr(word, otherSeparator);
+	// Find a '('. If that fails go to the end of the string.
+	if (!endWord)
+		endWord = strchr(word, '(');
+	if (!endWord)
+		endWord = word + strlen(word);
+	assert(endWord);
+	// Last case always succeeds so endWord != 0
+
+	// Drop any space characters.
+	if (endWord > word) {
+		endWord--;	// Back from the '(', otherSeparator, or '\0'
+		// Move backwards over any spaces
+		while ((endWord > word) && (IsASpace(*endWord))) {
+			endWord--;
+		}
+	}
+	return endWord - word + 1;
+}
+
+// Each character as a bit, with letters folded, so that words lacking a character of a
+// fuzzy pattern are rejected without matching.
+constexpr uint32_t CharacterBit(unsigned char ch) noexcept {
+	if (ch >= 'a' && ch <= 'z')
+		return 1U << (ch - 'a');
+	if (ch >= 'A' && ch <= 'Z')
+		return 1U << (ch - 'A');
+	if (ch >= '0' && ch <= '9')
+		return 1U << 26;
+	if (ch == '_')
+		return 1U << 27;
+	if (ch >= 0x80)
+		return 1U << 28;
+	return 1U << 29;
+}
+
+uint32_t CharacterMask(std::string_view text) noexcept {
+	uint32_t mask = 0;
+	for (const char ch : text) {
+		mask |= CharacterBit(ch);
+	}
+	return mask;
+}
+
+}
+
+/**
+ * Offsets of words sorted for binary search with the identifier length of each word in the
+ * same order so matches can be listed without rescanning them.
+ */
+struct SortedWords {
+	// Identifier lengths that do not fit are found again when needed
+	static constexpr uint16_t lengthUnknown = UINT16_MAX;
+	// View the vectors below or part of a mapped index file
+	std::span<const uint32_t> offsets;
+	std::span<const uint16_t> lengths;
+	std::vector<uint32_t> offsetsSorted;
+	std::vector<uint16_t> lengthsSorted;
+
+	bool Empty() const noexcept {
+		return offsets.empty();
+	}
+	void Sort(const char *text, const std::vector<uint32_t> &words, bool ignoreCase);
+	size_t Length(const char *text, size_t position, char otherSeparator) const noexcept {
+		// With no otherSeparator or '(', LengthWord stops at the same place
+		if (((otherSeparator == '\0') || (otherSeparator == '(')) && (lengths[position] != lengthUnknown)) {
+			return lengths[position];
+		}
+		return LengthWord(text + offsets[position], otherSeparator);
+	}
+};
+
+void SortedWords::Sort(const char *text, const std::vector<uint32_t> &words, bool ignoreCase) {
+	offsetsSorted = words;
+	if (ignoreCase) {
+		std::sort(offsetsSorted.begin(), offsetsSorted.end(), [text](uint32_t a, uint32_t b) noexcept {
+			return CompareNoCase(text + a, text + b) < 0;
+		});
+	} else {
+		std::sort(offsetsSorted.begin(), offsetsSorted.end(), [text](uint32_t a, uint32_t b) noexcept {
+			return strcmp(text + a, text + b) < 0;
+		});
+	}
+	lengthsSorted.reserve(offsetsSorted.size());
+	for (const uint32_t offset : offsetsSorted) {
+		const size_t length = LengthWord(text + offset, '\0');
+		lengthsSorted.push_back(static_cast<uint16_t>(std::min<size_t>(length, lengthUnknown)));
+	}
+	offsets = offsetsSorted;
+	lengths = lengthsSorted;
+}
+
+// Both sort orders, possibly being built on another thread
+struct StringListIndex {
+	SortedWords sorted;
+	SortedWords sortedNoCase;
+	// Characters in each word of sorted for fuzzy matching
+	std::vector<uint32_t> masks;
+	std::future<void> building;
+
+	SortedWords &Sorted(bool ignoreCase) noexcept {
+		return ignoreCase ? sortedNoCase : sorted;
+	}
+	void Mask(const char *text) {
+		masks.reserve(sorted.offsets.size());
+		for (const uint32_t offset : sorted.offsets) {
+			masks.push_back(CharacterMask(text + offset));
+		}
+	}
+	void Build(const char *text, const std::vector<uint32_t> &words) {
+		// Sort both ways as either may be needed
+		sorted.Sort(text, words, false);
+		sortedNoCase.Sort(text, words, true);
+		Mask(text);
+	}
+};
+
+namespace {
+
 /**
- * Creates an array that points into each word in the string and puts \0 terminators
+ * Finds the offset of each word in text and puts \0 terminators
  * after each word.
  */
-static std::vector<char *> ArrayFromStringList(char *stringList, bool onlyLineEnds = false) {
-	int prev = '\n';
-	int words = 0;
+std::vector<uint32_t> WordsFromText(std::string &text, bool onlyLineEnds) {
 	// For rapid determination of whether a character is a separator, build
 	// a look up table.
 	bool wordSeparator[256] = {};
 	wordSeparator[static_cast<unsigned int>('\r')] = true;
 	wordSeparator[static_cast<unsigned int>('\n')] = true;
+	wordSeparator[static_cast<unsigned int>('\0')] = true;
 	if (!onlyLineEnds) {
 		wordSeparator[static_cast<unsigned int>(' ')] = true;
 		wordSeparator[static_cast<unsigned int>('\t')] = true;
 	}
-	for (int j = 0; stringList[j]; j++) {
-		const int curr = static_cast<unsigned char>(stringList[j]);
-		if (!wordSeparator[curr] && wordSeparator[prev])
-			words++;
-		prev = curr;
-	}
-	std::vector<char *> keywords;
-	const size_t slen = strlen(stringList);
-	if (words) {
-		prev = '\0';
-		for (size_t k = 0; k < slen; k++) {
-			if (!wordSeparator[static_cast<unsigned char>(stringList[k])]) {
-				if (!prev) {
-					keywords.push_back(&stringList[k]);
-				}
-			} else {
-				stringList[k] = '\0';
-			}
-			prev = stringList[k];
+	// Words past 4 GB can not be represented so are dropped
+	const size_t length = std::min<size_t>(strlen(text.c_str()), UINT32_MAX);
+	std::vector<uint32_t> words;
+	bool prevSeparator = true;
+	for (size_t k = 0; k < length; k++) {
+		const bool separator = wordSeparator[static_cast<unsigned char>(text[k])];
+		if (separator) {
+			text[k] = '\0';
+		} else if (prevSeparator) {
+			words.push_back(static_cast<uint32_t>(k));
 		}
+		prevSeparator = separator;
 	}
-	return keywords;
+	text.resize(length);
+	return words;
+}
+
+}
+
+StringList::StringList(bool onlyLineEnds_) : onlyLineEnds(onlyLineEnds_) {
+}
+
+StringList::~StringList() {
+	WaitForIndex();
 }
 
 void StringList::SetFromListText() {
-	sorted = false;
-	sortedNoCase = false;
-	words = ArrayFromStringList(&listText[0], onlyLineEnds);
-	wordsNoCase = words;
+	words = WordsFromText(listText, onlyLineEnds);
+	count = words.size();
 }
 
-static bool CmpString(const char *a, const char *b) noexcept {
-	return strcmp(a, b) < 0;
+void StringList::WaitForIndex() noexcept {
+	// The background thread refers to listText and words so must finish before they change
+	if (index && index->building.valid()) {
+		index->building.wait();
+	}
 }
 
-static bool CmpStringNoCase(const char *a, const char *b) noexcept {
-	return CompareNoCase(a, b) < 0;
+const char *StringList::Text() const noexcept {
+	return mapped ? mappedText : listText.c_str();
 }
 
-void StringList::SortIfNeeded(bool ignoreCase) {
-	// In both cases, the final empty sentinel element is not sorted.
-	if (ignoreCase) {
-		if (!sortedNoCase) {
-			sortedNoCase = true;
-			std::sort(wordsNoCase.begin(), wordsNoCase.end(), CmpStringNoCase);
-		}
-	} else {
-		if (!sorted) {
-			sorted = true;
-			std::sort(words.begin(), words.end(), CmpString);
-		}
+const SortedWords &StringList::Sorted(bool ignoreCase) {
+	if (index && index->building.valid()) {
+		index->building.get();
+	}
+	if (!index) {
+		index = std::make_unique<StringListIndex>();
 	}
+	SortedWords &sorted = index->Sorted(ignoreCase);
+	if (sorted.Empty()) {
+		sorted.Sort(listText.c_str(), words, ignoreCase);
+	}
+	return sorted;
 }
 
 void StringList::Clear() noexcept {
+	WaitForIndex();
+	index.reset();
+	mapped.reset();
+	mappedText = nullptr;
 	words.clear();
-	wordsNoCase.clear();
 	listText.clear();
-	sorted = false;
-	sortedNoCase = false;
+	count = 0;
 }
 
 void StringList::Set(const char *s) {
-	listText.assign(s, s+strlen(s)+1);
+	Clear();
+	listText.assign(s);
 	SetFromListText();
 }
 
-void StringList::Set(const std::vector<char> &data) {
-	listText.assign(data.begin(), data.end());
-	listText.push_back('\0');
+void StringList::Set(std::string &&text) {
+	Clear();
+	listText = std::move(text);
 	SetFromListText();
 }
 
+void StringList::IndexInBackground() {
+	IndexInBackground(FilePath(), std::string_view());
+}
+
+void StringList::IndexInBackground(const FilePath &file, std::string_view key) {
+	WaitForIndex();
+	index = std::make_unique<StringListIndex>();
+	if (words.empty()) {
+		return;
+	}
+	StringListIndex *pIndex = index.get();
+	const char *text = listText.c_str();
+	try {
+		pIndex->building = std::async(std::launch::async, [pIndex, text, this, file, key = std::string(key)]() {
+			pIndex->Build(text, words);
+			if (file.IsSet()) {
+				Save(file, key);
+			}
+		});
+	} catch (std::system_error &) {
+		// No thread available so the index is built when first needed
+	}
+}
+
+namespace {
+
+// Index file layout is a header, the key, then at 4 byte alignment the sorted and
+// case-insensitively sorted offsets, their lengths, then the text.
+// Changed when the layout of the index file changes.
+constexpr uint32_t indexVersion = 1;
+constexpr std::string_view indexMagic = "SciTEApi";
+
+struct IndexHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t onlyLineEnds;
+	uint32_t count;
+	uint32_t textLength;
+	uint32_t keyLength;
+};
+
+constexpr size_t AlignedTo4(size_t position) noexcept {
+	return (position + 3) & ~static_cast<size_t>(3);
+}
+
+template<typename T>
+void AppendSpan(std::string &data, std::span<const T> values) {
+	data.append(reinterpret_cast<const char *>(values.data()), values.size_bytes());
+}
+
+}
+
+bool StringList::Save(const FilePath &file, std::string_view key) const {
+	const SortedWords &sorted = index->sorted;
+	const SortedWords &sortedNoCase = index->sortedNoCase;
+	// Includes the '\0' after the last word
+	const size_t textLength = listText.length() + 1;
+	if ((textLength > UINT32_MAX) || (key.length() > UINT32_MAX)) {
+		return false;
+	}
+	IndexHeader header {};
+	memcpy(header.magic, indexMagic.data(), sizeof(header.magic));
+	header.version = indexVersion;
+	header.onlyLineEnds = onlyLineEnds;
+	header.count = static_cast<uint32_t>(count);
+	header.textLength = static_cast<uint32_t>(textLength);
+	header.keyLength = static_cast<uint32_t>(key.length());
+
+	std::string data(reinterpret_cast<const char *>(&header), sizeof(header));
+	data.append(key);
+	data.resize(AlignedTo4(data.length()));
+	AppendSpan(data, sorted.offsets);
+	AppendSpan(data, sortedNoCase.offsets);
+	AppendSpan(data, sorted.lengths);
+	AppendSpan(data, sortedNoCase.lengths);
+	data.append(listText.c_str(), textLength);
+
+	// The file may be mapped by another list or another instance
+	return WriteReplacing(file, data);
+}
+
+bool StringList::Load(const FilePath &file, std::string_view key) {
+	FileHolder fp(file.Open(fileRead));
+	if (!fp) {
+		return false;
+	}
+	auto mapping = std::make_unique<MappedFile>(fp.get(), sizeof(IndexHeader));
+	if (!mapping->Mapped()) {
+		return false;
+	}
+	const std::string_view contents = mapping->Contents();
+	IndexHeader header {};
+	memcpy(&header, contents.data(), sizeof(header));
+	if ((std::string_view(header.magic, sizeof(header.magic)) != indexMagic) ||
+		(header.version != indexVersion) ||
+		(static_cast<bool>(header.onlyLineEnds) != onlyLineEnds) ||
+		(header.textLength == 0) ||
+		(contents.substr(sizeof(header), header.keyLength) != key)) {
+		return false;
+	}
+	const size_t count_ = header.count;
+	// Each word needs 12 bytes of index so larger counts are damaged and could overflow
+	if (count_ > contents.length() / 12) {
+		return false;
+	}
+	const size_t positionOffsets = AlignedTo4(sizeof(header) + key.length());
+	const size_t positionLengths = positionOffsets + count_ * 2 * sizeof(uint32_t);
+	const size_t positionText = positionLengths + count_ * 2 * sizeof(uint16_t);
+	if (contents.length() != positionText + header.textLength) {
+		return false;
+	}
+	const char *text = contents.data() + positionText;
+	if (text[header.textLength - 1] != '\0') {
+		return false;
+	}
+	const uint32_t *offsets = reinterpret_cast<const uint32_t *>(contents.data() + positionOffsets);
+	const uint16_t *lengths = reinterpret_cast<const uint16_t *>(contents.data() + positionLengths);
+	// Check that a damaged file can not lead to reading outside the text
+	for (size_t i = 0; i < count_ * 2; i++) {
+		if ((offsets[i] >= header.textLength) ||
+			((lengths[i] != SortedWords::lengthUnknown) && (lengths[i] >= header.textLength - offsets[i]))) {
+			return false;
+		}
+	}
+
+	Clear();
+	index = std::make_unique<StringListIndex>();
+	index->sorted.offsets = std::span(offsets, count_);
+	index->sortedNoCase.offsets = std::span(offsets + count_, count_);
+	index->sorted.lengths = std::span(lengths, count_);
+	index->sortedNoCase.lengths = std::span(lengths + count_, count_);
+	mapped = std::move(mapping);
+	mappedText = text;
+	count = count_;
+	return true;
+}
+
 namespace {
 
-// Functors used to find elements given a prefix
+// Functors used to find elements given a prefix. The elements are offsets into text.
 
-struct CompareString {
+class CompareString {
+	const char *text;
+public:
 	size_t searchLen;
-	explicit CompareString(size_t searchLen_) noexcept : searchLen(searchLen_) {}
-	bool operator()(const char *a, const char *b) const noexcept {
-		return strncmp(a, b, searchLen) < 0;
+	CompareString(const char *text_, size_t searchLen_) noexcept : text(text_), searchLen(searchLen_) {}
+	const char *Word(uint32_t offset) const noexcept {
+		return text + offset;
+	}
+	int Compare(uint32_t offset, const char *value) const noexcept {
+		return strncmp(Word(offset), value, searchLen);
 	}
 };
 
-struct CompareStringInsensitive {
+class CompareStringInsensitive {
+	const char *text;
+public:
 	size_t searchLen;
-	explicit CompareStringInsensitive(size_t searchLen_) noexcept : searchLen(searchLen_) {}
-	bool operator()(const char *a, const char *b) const noexcept {
-		return CompareNCaseInsensitive(a, b, searchLen) < 0;
+	CompareStringInsensitive(const char *text_, size_t searchLen_) noexcept : text(text_), searchLen(searchLen_) {}
+	const char *Word(uint32_t offset) const noexcept {
+		return text + offset;
+	}
+	int Compare(uint32_t offset, const char *value) const noexcept {
+		return CompareNCaseInsensitive(Word(offset), value, searchLen);
 	}
 };
 
+// Range of positions in sorted of the words that start with wordStart
 template<typename Compare>
-std::string GetMatch(std::vector<char *>::iterator start, std::vector<char *>::iterator end,
-		     const char *wordStart, const std::string &wordCharacters, ptrdiff_t wordIndex, Compare comp) {
-	std::vector<char *>::iterator elem = std::lower_bound(start, end, wordStart, comp);
-	if (!comp(wordStart, *elem) && !comp(*elem, wordStart)) {
-		// Found a matching element, now move forward wordIndex matching elements
-		for (; elem < end; ++elem) {
-			const char *word = *elem;
-			if (!word[comp.searchLen] || !Contains(wordCharacters, word[comp.searchLen])) {
-				if (wordIndex <= 0) {
-					return std::string(word);
-				}
-				wordIndex--;
+std::pair<size_t, size_t> Matching(const SortedWords &sorted, const char *wordStart, const Compare &comp) {
+	const auto first = std::lower_bound(sorted.offsets.begin(), sorted.offsets.end(), wordStart,
+		[&comp](uint32_t offset, const char *value) noexcept {
+		return comp.Compare(offset, value) < 0;
+	});
+	const auto last = std::upper_bound(first, sorted.offsets.end(), wordStart,
+		[&comp](const char *value, uint32_t offset) noexcept {
+		return comp.Compare(offset, value) > 0;
+	});
+	return { first - sorted.offsets.begin(), last - sorted.offsets.begin() };
+}
+
+template<typename Compare>
+std::string GetMatch(const SortedWords &sorted, const char *wordStart, const std::string &wordCharacters,
+		     ptrdiff_t wordIndex, const Compare &comp) {
+	const auto [start, end] = Matching(sorted, wordStart, comp);
+	// Move forward wordIndex matching elements
+	for (size_t position = start; position < end; position++) {
+		const char *word = comp.Word(sorted.offsets[position]);
+		if (!word[comp.searchLen] || !Contains(wordCharacters, word[comp.searchLen])) {
+			if (wordIndex <= 0) {
+				return std::string(word);
 			}
+			wordIndex--;
 		}
 	}
 	return std::string();
 }
 
+template<typename Compare>
+std::string GetMatches(const SortedWords &sorted, const char *text, const char *wordStart,
+		       char otherSeparator, bool exactLen, const Compare &comp) {
+	std::string wordList;
+	const size_t wordStartLength = LengthWord(wordStart, otherSeparator);
+	const auto [start, end] = Matching(sorted, wordStart, comp);
+	for (size_t position = start; position < end; position++) {
+		// length of the word part (before the '(' brace) of the api array element
+		const size_t wordlen = sorted.Length(text, position, otherSeparator);
+		if (!exactLen || (wordlen == wordStartLength)) {
+			if (wordList.length() > 0)
+				wordList.append(" ", 1);
+			wordList.append(comp.Word(sorted.offsets[position]), wordlen);
+		}
+	}
+	return wordList;
+}
+
+}
+
+namespace {
+
+// Scores for each character of a fuzzy pattern found in a word.
+constexpr int scoreMatch = 16;
+constexpr int bonusStart = 8;
+constexpr int bonusBoundary = 12;
+constexpr int bonusConsecutive = 10;
+constexpr int bonusCase = 1;
+constexpr int penaltyGap = 2;
+constexpr int penaltyGapMaximum = 8;
+constexpr int noMatch = std::numeric_limits<int>::min();
+
+// Start of word, after punctuation such as '_' or '.', a capital after a lower case letter
+// as in camelCase or the start of a number.
+bool IsWordBoundary(std::string_view word, size_t position) noexcept {
+	if (position == 0) {
+		return true;
+	}
+	const char ch = word[position];
+	const char previous = word[position - 1];
+	return !IsAlphaNumeric(previous) ||
+		(IsUpperCase(ch) && IsAlphabetic(previous) && !IsUpperCase(previous)) ||
+		(IsADigit(ch) && !IsADigit(previous));
+}
+
+// Match each character of pattern in order, ignoring case. Either the first position of
+// each character is taken or positions at boundaries or following the previous match are
+// preferred as those match what is usually meant by abbreviations like "gNW" or "get_nw".
+int MatchScore(std::string_view pattern, std::string_view word, bool preferBoundaries) noexcept {
+	int score = 0;
+	size_t position = 0;
+	size_t previous = std::string_view::npos;
+	for (const char ch : pattern) {
+		const char folded = MakeUpperCase(ch);
+		size_t found = std::string_view::npos;
+		size_t first = std::string_view::npos;
+		for (size_t k = position; k < word.length(); k++) {
+			if (MakeUpperCase(word[k]) == folded) {
+				if (!preferBoundaries || (k == previous + 1) || IsWordBoundary(word, k)) {
+					found = k;
+					break;
+				}
+				if (first == std::string_view::npos) {
+					first = k;
+				}
+			}
+		}
+		if (found == std::string_view::npos) {
+			found = first;
+		}
+		if (found == std::string_view::npos) {
+			return noMatch;
+		}
+		score += scoreMatch;
+		if (found == 0) {
+			score += bonusStart;
+		}
+		if (IsWordBoundary(word, found)) {
+			score += bonusBoundary;
+		}
+		if (word[found] == ch) {
+			score += bonusCase;
+		}
+		const size_t gap = (previous == std::string_view::npos) ? found : found - previous - 1;
+		if ((previous != std::string_view::npos) && (gap == 0)) {
+			score += bonusConsecutive;
+		} else {
+			score -= penaltyGap * static_cast<int>(std::min<size_t>(gap, penaltyGapMaximum));
+		}
+		previous = found;
+		position = found + 1;
+	}
+	return score;
+}
+
+int FuzzyScore(std::string_view pattern, std::string_view word) noexcept {
+	const int scoreFirst = MatchScore(pattern, word, false);
+	if (scoreFirst == noMatch) {
+		return noMatch;
+	}
+	return std::max(scoreFirst, MatchScore(pattern, word, true));
+}
+
+struct FuzzyCandidate {
+	int score;
+	size_t position;
+	std::string_view word;
+};
+
+// Higher scores first then shorter words then in sorted order
+bool Better(const FuzzyCandidate &a, const FuzzyCandidate &b) noexcept {
+	if (a.score != b.score) {
+		return a.score > b.score;
+	}
+	if (a.word.length() != b.word.length()) {
+		return a.word.length() < b.word.length();
+	}
+	return a.position < b.position;
+}
+
+}
+
+bool FuzzyMatches(std::string_view pattern, std::string_view word) noexcept {
+	return MatchScore(pattern, word, false) != noMatch;
 }
 
 /**
@@ -179,64 +605,15 @@ std::string GetMatch(std::vector<char *>::iterator start, std::vector<char *>::i
  * Letter case can be ignored or preserved.
  */
 std::string StringList::GetNearestWord(const char *wordStart, size_t searchLen, bool ignoreCase, const std::string &wordCharacters, ptrdiff_t wordIndex) {
-	if (words.empty())
+	if (count == 0)
 		return std::string();
-	SortIfNeeded(ignoreCase);
+	const SortedWords &sorted = Sorted(ignoreCase);
+	const char *text = Text();
 	if (ignoreCase) {
-		return GetMatch(wordsNoCase.begin(), wordsNoCase.end(), wordStart, wordCharacters, wordIndex, CompareStringInsensitive(searchLen));
+		return GetMatch(sorted, wordStart, wordCharacters, wordIndex, CompareStringInsensitive(text, searchLen));
 	} else { // preserve the letter case
-		return GetMatch(words.begin(), words.end(), wordStart, wordCharacters, wordIndex, CompareString(searchLen));
-	}
-}
-
-/**
- * Find the length of a 'word' which is actually an identifier in a string
- * which looks like "identifier(..." or "identifier" and where
- * there may be extra spaces after the identifier that should not be
- * counted in the length.
- */
-static size_t LengthWord(const char *word, char otherSeparator) noexcept {
-	const char *endWord = nullptr;
-	// Find an otherSeparator
-	if (otherSeparator)
-		endWord = strchr(word, otherSeparator);
-	// Find a '('. If that fails go to the end of the string.
-	if (!endWord)
-		endWord = strchr(word, '(');
-	if (!endWord)
-		endWord = word + strlen(word);
-	assert(endWord);
-	// Last case always succeeds so endWord != 0
-
-	// Drop any space characters.
-	if (endWord > word) {
-		endWord--;	// Back from the '(', otherSeparator, or '\0'
-		// Move backwards over any spaces
-		while ((endWord > word) && (IsASpace(*endWord))) {
-			endWord--;
-		}
+		return GetMatch(sorted, wordStart, wordCharacters, wordIndex, CompareString(text, searchLen));
 	}
-	return endWord - word + 1;
-}
-
-template<typename Compare>
-static std::string GetMatches(std::vector<char *>::iterator start, std::vector<char *>::iterator end, const char *wordStart, char otherSeparator, bool exactLen, Compare comp) {
-	std::string wordList;
-	const size_t wordStartLength = LengthWord(wordStart, otherSeparator);
-	std::vector<char *>::iterator elem = std::lower_bound(start, end, wordStart, comp);
-	// Found a matching element, now accumulate all matches
-	for (; elem < end; ++elem) {
-		if (comp(wordStart, *elem) || comp(*elem, wordStart))
-			break;	// Not a match so stop
-		// length of the word part (before the '(' brace) of the api array element
-		const size_t wordlen = LengthWord(*elem, otherSeparator);
-		if (!exactLen || (wordlen == wordStartLength)) {
-			if (wordList.length() > 0)
-				wordList.append(" ", 1);
-			wordList.append(*elem, wordlen);
-		}
-	}
-	return wordList;
 }
 
 /**
@@ -254,17 +631,70 @@ std::string StringList::GetNearestWords(
 	char otherSeparator /*= '\0'*/,
 	bool exactLen /*=false*/) {
 
-	if (words.empty())
+	if (count == 0)
 		return std::string();
-	SortIfNeeded(ignoreCase);
+	const SortedWords &sorted = Sorted(ignoreCase);
+	const char *text = Text();
 	if (ignoreCase) {
-		return GetMatches(wordsNoCase.begin(), wordsNoCase.end(), wordStart, otherSeparator, exactLen, CompareStringInsensitive(searchLen));
+		return GetMatches(sorted, text, wordStart, otherSeparator, exactLen, CompareStringInsensitive(text, searchLen));
 	} else {
 		// Preserve the letter case
-		return GetMatches(words.begin(), words.end(), wordStart, otherSeparator, exactLen, CompareString(searchLen));
+		return GetMatches(sorted, text, wordStart, otherSeparator, exactLen, CompareString(text, searchLen));
 	}
 }
 
+/**
+ * Returns the words (first words of them) containing the characters of pattern in order,
+ * ignoring case, best matches first and separated with spaces.
+ * Only the maximum best matches are returned. These are kept in a heap with the worst
+ * at the front so most words are rejected with a single comparison.
+ */
+std::string StringList::GetFuzzyWords(const char *pattern, size_t patternLen, char otherSeparator, size_t maximum) {
+	if ((count == 0) || (maximum == 0))
+		return std::string();
+	const SortedWords &sorted = Sorted(false);
+	const char *text = Text();
+	if (index->masks.empty()) {
+		index->Mask(text);
+	}
+	const std::string_view patternView(pattern, patternLen);
+	const uint32_t patternMask = CharacterMask(patternView);
+	std::vector<FuzzyCandidate> best;
+	std::string_view previousWord;
+	for (size_t position = 0; position < sorted.offsets.size(); position++) {
+		if ((patternMask & ~index->masks[position]) != 0) {
+			continue;
+		}
+		const std::string_view word(text + sorted.offsets[position], sorted.Length(text, position, otherSeparator));
+		// Overloaded functions have several lines for the same identifier
+		if (word == previousWord) {
+			continue;
+		}
+		previousWord = word;
+		const int score = FuzzyScore(patternView, word);
+		if (score == noMatch) {
+			continue;
+		}
+		const FuzzyCandidate candidate { score, position, word };
+		if (best.size() < maximum) {
+			best.push_back(candidate);
+			std::push_heap(best.begin(), best.end(), Better);
+		} else if (Better(candidate, best.front())) {
+			std::pop_heap(best.begin(), best.end(), Better);
+			best.back() = candidate;
+			std::push_heap(best.begin(), best.end(), Better);
+		}
+	}
+	std::sort_heap(best.begin(), best.end(), Better);
+	std::string wordList;
+	for (const FuzzyCandidate &candidate : best) {
+		if (!wordList.empty())
+			wordList.append(" ", 1);
+		wordList.append(candidate.word);
+	}
+	return wordList;
+}
+
 bool AutoCompleteWordList::Add(const std::string& word) {
 	const auto [_, ok] = words.insert(word);
 	if (ok) {
@@ -8,33 +8,68 @@
 #ifndef STRINGLIST_H
 #define STRINGLIST_H
 
+class FilePath;
+class MappedFile;
+struct SortedWords;
+struct StringListIndex;
+
+/**
+ * A list of words, such as the lines of API files, that can be searched by prefix.
+ * Searching uses the words sorted with and without case along with the length of the
+ * identifier at the start of each word. These are built when first needed or, for large
+ * lists, may be started on a background thread with IndexInBackground.
+ * The text and index can be saved to an index file which is later loaded by mapping it
+ * into memory instead of reading and sorting the text again.
+ * The text is limited to 4 GB.
+ */
 class StringList {
-	// Text pointed into by words and wordsNoCase
+	// Text pointed into by words with a '\0' after each word
 	std::string listText;
-	// Each word contains at least one character.
-	std::vector<char *> words;
-	std::vector<char *> wordsNoCase;
+	// Offset of each word in listText. Each word contains at least one character.
+	std::vector<uint32_t> words;
+	// When loaded from an index file, holds the text and index instead of listText and words
+	std::unique_ptr<MappedFile> mapped;
+	const char *mappedText = nullptr;
+	size_t count = 0;
 	bool onlyLineEnds;	///< Delimited by any white space or only line ends
-	bool sorted;
-	bool sortedNoCase;
+	std::unique_ptr<StringListIndex> index;
 	void SetFromListText();
-	void SortIfNeeded(bool ignoreCase);
+	void WaitForIndex() noexcept;
+	const char *Text() const noexcept;
+	const SortedWords &Sorted(bool ignoreCase);
+	bool Save(const FilePath &file, std::string_view key) const;
 public:
-	explicit StringList(bool onlyLineEnds_ = false) :
-		words(0), wordsNoCase(0), onlyLineEnds(onlyLineEnds_),
-		sorted(false), sortedNoCase(false) {}
-	size_t Length() const noexcept { return words.size(); }
-	operator bool() const noexcept { return !words.empty(); }
-	char *operator[](size_t ind) noexcept { return words[ind]; }
+	explicit StringList(bool onlyLineEnds_ = false);
+	// Deleted so StringList objects can not be copied.
+	StringList(const StringList &) = delete;
+	StringList(StringList &&) = delete;
+	StringList &operator=(const StringList &) = delete;
+	StringList &operator=(StringList &&) = delete;
+	~StringList();
+	size_t Length() const noexcept { return count; }
+	operator bool() const noexcept { return count != 0; }
+	/// Only available for lists filled with Set.
+	char *operator[](size_t ind) noexcept { return listText.data() + words[ind]; }
 	void Clear() noexcept;
 	void Set(const char *s);
-	void Set(const std::vector<char> &data);
+	void Set(std::string &&text);
+	/// Build the index for searching on another thread. Searches wait for it to finish.
+	void IndexInBackground();
+	/// After building the index, save it to file along with key for a later Load.
+	void IndexInBackground(const FilePath &file, std::string_view key);
+	/// Replace the list with an index file saved with the same key.
+	bool Load(const FilePath &file, std::string_view key);
 	std::string GetNearestWord(const char *wordStart, size_t searchLen,
 				   bool ignoreCase, const std::string &wordCharacters, ptrdiff_t wordIndex);
 	std::string GetNearestWords(const char *wordStart, size_t searchLen,
 				    bool ignoreCase, char otherSeparator='\0', bool exactLen=false);
+	std::string GetFuzzyWords(const char *pattern, size_t patternLen, char otherSeparator, size_t maximum);
 };
 
+/// Does word contain the characters of pattern in order, ignoring case, so it would be
+/// listed by GetFuzzyWords.
+bool FuzzyMatches(std::string_view pattern, std::string_view word) noexcept;
+
 class AutoCompleteWordList {
 	std::set<std::string> words;
 	size_t totalLength = 0;
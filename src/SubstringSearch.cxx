@@ -0,0 +1,251 @@
+// SciTE - Scintilla based Text Editor
+/** @file SubstringSearch.cxx
+ ** Fast search for a literal string in a block of bytes.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstring>
+
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SUBSTRING_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#define SUBSTRING_AVX2
+#define TARGET_AVX2
+#elif defined(__GNUC__)
+#include <immintrin.h>
+#define SUBSTRING_AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#include "GUI.h"
+
+#include "StringHelpers.h"
+#include "SubstringSearch.h"
+
+namespace {
+
+using FindFunction = size_t (*)(std::string_view text, size_t start, std::string_view needle, bool fold) noexcept;
+
+// Compare the bytes between the first and last which have already been matched.
+bool MatchInterior(const char *s, std::string_view needle, bool fold) noexcept {
+	const size_t interior = needle.length() - 1;
+	if (!fold) {
+		return memcmp(s + 1, needle.data() + 1, interior) == 0;
+	}
+	for (size_t i = 1; i < interior; i++) {
+		if (MakeLowerCase(s[i]) != needle[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t FindScalar(std::string_view text, size_t start, std::string_view needle, bool fold) noexcept {
+	const size_t lastStart = text.length() - needle.length();
+	const char first = needle.front();
+	const char last = needle.back();
+	const size_t offsetLast = needle.length() - 1;
+	const char *s = text.data();
+	for (size_t i = start; i <= lastStart; i++) {
+		if (!fold) {
+			// memchr is vectorised by the C runtime
+			const void *found = memchr(s + i, first, lastStart - i + 1);
+			if (!found) {
+				break;
+			}
+			i = static_cast<const char *>(found) - s;
+		} else if (MakeLowerCase(s[i]) != first) {
+			continue;
+		}
+		if ((fold ? MakeLowerCase(s[i + offsetLast]) : s[i + offsetLast]) == last) {
+			if (MatchInterior(s + i, needle, fold)) {
+				return i;
+			}
+		}
+	}
+	return std::string_view::npos;
+}
+
+#if defined(SUBSTRING_SSE2)
+
+// Make 'A'..'Z' lower case by moving them to the bottom of the signed range then
+// a single comparison selects them for the addition of 0x20.
+constexpr char shiftUpper = static_cast<char>(0x80 - 'A');
+constexpr char limitUpper = static_cast<char>(0x80 + 26);
+
+__m128i FoldSSE2(__m128i v) noexcept {
+	const __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(shiftUpper));
+	const __m128i isUpper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(limitUpper));
+	return _mm_or_si128(v, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+}
+
+size_t FindSSE2(std::string_view text, size_t start, std::string_view needle, bool fold) noexcept {
+	constexpr size_t blockLength = 16;
+	const size_t lastStart = text.length() - needle.length();
+	const size_t offsetLast = needle.length() - 1;
+	const __m128i first = _mm_set1_epi8(needle.front());
+	const __m128i last = _mm_set1_epi8(needle.back());
+	const char *s = text.data();
+	size_t i = start;
+	for (; i + blockLength <= lastStart + 1; i += blockLength) {
+		__m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+		__m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + offsetLast));
+		if (fold) {
+			blockFirst = FoldSSE2(blockFirst);
+			blockLast = FoldSSE2(blockLast);
+		}
+		const __m128i candidates = _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last));
+		unsigned int mask = _mm_movemask_epi8(candidates);
+		while (mask) {
+			const size_t position = i + std::countr_zero(mask);
+			if (MatchInterior(s + position, needle, fold)) {
+				return position;
+			}
+			mask &= mask - 1;
+		}
+	}
+	return FindScalar(text, i, needle, fold);
+}
+
+#endif
+
+#if defined(SUBSTRING_AVX2)
+
+TARGET_AVX2 __m256i FoldAVX2(__m256i v) noexcept {
+	const __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(shiftUpper));
+	const __m256i isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(limitUpper), shifted);
+	return _mm256_or_si256(v, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+}
+
+TARGET_AVX2 size_t FindAVX2(std::string_view text, size_t start, std::string_view needle, bool fold) noexcept {
+	constexpr size_t blockLength = 32;
+	const size_t lastStart = text.length() - needle.length();
+	const size_t offsetLast = needle.length() - 1;
+	const __m256i first = _mm256_set1_epi8(needle.front());
+	const __m256i last = _mm256_set1_epi8(needle.back());
+	const char *s = text.data();
+	size_t i = start;
+	for (; i + blockLength <= lastStart + 1; i += blockLength) {
+		__m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+		__m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i + offsetLast));
+		if (fold) {
+			blockFirst = FoldAVX2(blockFirst);
+			blockLast = FoldAVX2(blockLast);
+		}
+		const __m256i candidates = _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last));
+		unsigned int mask = _mm256_movemask_epi8(candidates);
+		while (mask) {
+			const size_t position = i + std::countr_zero(mask);
+			if (MatchInterior(s + position, needle, fold)) {
+				return position;
+			}
+			mask &= mask - 1;
+		}
+	}
+	return FindSSE2(text, i, needle, fold);
+}
+
+bool HasAVX2() noexcept {
+#if defined(_MSC_VER)
+	int info[4] {};
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuid(info, 1);
+	constexpr int osxsave = 1 << 27;
+	if (!(info[2] & osxsave)) {
+		return false;
+	}
+	// OS must preserve the YMM registers
+	if ((_xgetbv(0) & 6) != 6) {
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	constexpr int avx2 = 1 << 5;
+	return (info[1] & avx2) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+FindFunction ChooseFind() noexcept {
+#if defined(SUBSTRING_AVX2)
+	if (HasAVX2()) {
+		return FindAVX2;
+	}
+#endif
+#if defined(SUBSTRING_SSE2)
+	return FindSSE2;
+#else
+	return FindScalar;
+#endif
+}
+
+}
+
+SubstringSearch::SubstringSearch(std::string_view needle_, bool matchCase_) :
+	needle(needle_), matchCase(matchCase_) {
+	if (!matchCase) {
+		LowerCaseAZ(needle);
+	}
+}
+
+size_t SubstringSearch::Find(std::string_view text, size_t start) const noexcept {
+	if ((text.length() < needle.length()) || (start > text.length() - needle.length())) {
+		return std::string_view::npos;
+	}
+	if (needle.empty()) {
+		return start;
+	}
+	static const FindFunction findBest = ChooseFind();
+	return findBest(text, start, needle, !matchCase);
+}
+
+size_t CountLineEnds(std::string_view text) noexcept {
+	size_t lineEnds = 0;
+	size_t i = 0;
+	const char *s = text.data();
+#if defined(SUBSTRING_SSE2)
+	constexpr size_t blockLength = 16;
+	const __m128i lf = _mm_set1_epi8('\n');
+	const __m128i cr = _mm_set1_epi8('\r');
+	for (; i + blockLength <= text.length(); i += blockLength) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, cr))) {
+			// Rare: isolated '\r' are line ends so examine each byte
+			for (size_t j = i; j < i + blockLength; j++) {
+				if ((s[j] == '\n') || ((s[j] == '\r') && ((j + 1 >= text.length()) || (s[j + 1] != '\n')))) {
+					lineEnds++;
+				}
+			}
+		} else {
+			lineEnds += std::popcount(static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, lf))));
+		}
+	}
+#endif
+	for (; i < text.length(); i++) {
+		if ((s[i] == '\n') || ((s[i] == '\r') && ((i + 1 >= text.length()) || (s[i + 1] != '\n')))) {
+			lineEnds++;
+		}
+	}
+	return lineEnds;
+}
@@ -0,0 +1,31 @@
+// SciTE - Scintilla based Text Editor
+/** @file SubstringSearch.h
+ ** Fast search for a literal string in a block of bytes.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef SUBSTRINGSEARCH_H
+#define SUBSTRINGSEARCH_H
+
+/**
+ * Finds a literal string, optionally ignoring the case of ASCII letters.
+ * Candidates are found by comparing the first and last bytes of the string against
+ * 16 or 32 positions at once with SSE2 or AVX2 (chosen at run time) then verified.
+ */
+class SubstringSearch {
+	std::string needle;
+	bool matchCase;
+public:
+	SubstringSearch(std::string_view needle_, bool matchCase_);
+	size_t Length() const noexcept {
+		return needle.length();
+	}
+	/// Position of first match starting at or after start or std::string_view::npos.
+	size_t Find(std::string_view text, size_t start=0) const noexcept;
+};
+
+/// Count the line ends in text, treating "\r\n" as a single line end.
+size_t CountLineEnds(std::string_view text) noexcept;
+
+#endif
@@ -0,0 +1,143 @@
+// SciTE - Scintilla based Text Editor
+/** @file ThreadPool.cxx
+ ** Run many small tasks over a fixed set of threads.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "ThreadPool.h"
+
+namespace {
+
+// Allows Submit to find the deque of the calling thread when it is a pool thread.
+thread_local const ThreadPool *poolCurrent = nullptr;
+thread_local size_t indexCurrent = 0;
+
+}
+
+ThreadPool::ThreadPool(size_t threadCount) : queued(0), submitted(0), stopping(false) {
+	if (threadCount == 0) {
+		threadCount = DefaultThreads();
+	}
+	for (size_t i = 0; i < threadCount; i++) {
+		deques.push_back(std::make_unique<TaskDeque>());
+	}
+	for (size_t i = 0; i < threadCount; i++) {
+		threads.emplace_back(&ThreadPool::Run, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	Cancel();
+	{
+		std::lock_guard<std::mutex> guard(mutexWake);
+		stopping = true;
+	}
+	cvWake.notify_all();
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+}
+
+size_t ThreadPool::Size() const noexcept {
+	return threads.size();
+}
+
+size_t ThreadPool::CurrentThread() const noexcept {
+	if (poolCurrent == this) {
+		return indexCurrent;
+	}
+	return threads.size();
+}
+
+void ThreadPool::Submit(Task task) {
+	size_t index = 0;
+	if (poolCurrent == this) {
+		index = indexCurrent;
+	} else {
+		index = submitted++ % deques.size();
+	}
+	{
+		// Counted before the task is visible so taking it can not decrement queued below 0.
+		// Under mutexWake so a thread about to wait can not miss the notification.
+		std::lock_guard<std::mutex> guard(mutexWake);
+		queued++;
+	}
+	try {
+		std::lock_guard<std::mutex> guard(deques[index]->mutex);
+		deques[index]->tasks.push_back(std::move(task));
+	} catch (...) {
+		queued--;
+		throw;
+	}
+	cvWake.notify_one();
+}
+
+void ThreadPool::Cancel() noexcept {
+	for (const std::unique_ptr<TaskDeque> &deque : deques) {
+		std::lock_guard<std::mutex> guard(deque->mutex);
+		// Only the tasks removed here are uncounted as others may be running or being pushed.
+		const size_t removed = deque->tasks.size();
+		deque->tasks.clear();
+		queued -= removed;
+	}
+}
+
+size_t ThreadPool::DefaultThreads() noexcept {
+	const unsigned int hardware = std::thread::hardware_concurrency();
+	return hardware ? hardware : 2;
+}
+
+bool ThreadPool::TakeTask(size_t index, Task &task) {
+	{
+		TaskDeque &own = *deques[index];
+		std::lock_guard<std::mutex> guard(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			queued--;
+			return true;
+		}
+	}
+	for (size_t offset = 1; offset < deques.size(); offset++) {
+		TaskDeque &other = *deques[(index + offset) % deques.size()];
+		std::lock_guard<std::mutex> guard(other.mutex);
+		if (!other.tasks.empty()) {
+			task = std::move(other.tasks.front());
+			other.tasks.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::Run(size_t index) {
+	poolCurrent = this;
+	indexCurrent = index;
+	for (;;) {
+		Task task;
+		if (TakeTask(index, task)) {
+			task();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(mutexWake);
+		cvWake.wait(lock, [this] {
+			return stopping || (queued > 0);
+		});
+		if (stopping) {
+			return;
+		}
+	}
+}
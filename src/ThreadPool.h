@@ -0,0 +1,50 @@
+// SciTE - Scintilla based Text Editor
+/** @file ThreadPool.h
+ ** Run many small tasks over a fixed set of threads.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/**
+ * Each thread has its own deque of tasks. Tasks submitted from a pool thread go on that
+ * thread's deque and are taken from the back so related work stays together and is
+ * performed in submission order. Idle threads steal from the front of other deques.
+ * Tasks not yet started when the pool is cancelled or destroyed are discarded.
+ */
+class ThreadPool {
+public:
+	using Task = std::function<void()>;
+private:
+	struct TaskDeque {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+	std::vector<std::unique_ptr<TaskDeque>> deques;
+	std::vector<std::thread> threads;
+	std::mutex mutexWake;
+	std::condition_variable cvWake;
+	std::atomic_size_t queued;
+	std::atomic_size_t submitted;
+	std::atomic_bool stopping;
+	bool TakeTask(size_t index, Task &task);
+	void Run(size_t index);
+public:
+	explicit ThreadPool(size_t threadCount=0);
+	// Deleted so ThreadPool objects can not be copied.
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	ThreadPool &operator=(ThreadPool &&) = delete;
+	~ThreadPool();
+	size_t Size() const noexcept;
+	/// Index of the calling thread in the pool or Size() when called from another thread.
+	size_t CurrentThread() const noexcept;
+	void Submit(Task task);
+	void Cancel() noexcept;
+	static size_t DefaultThreads() noexcept;
+};
+
+#endif
@@ -0,0 +1,224 @@
+// SciTE - Scintilla based Text Editor
+/** @file TrigramIndex.cxx
+ ** Remember which trigrams each file in a tree contains so searches can skip files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <chrono>
+
+#include "GUI.h"
+
+#include "FilePath.h"
+#include "TrigramIndex.h"
+
+namespace {
+
+// Changed when the layout of the index file changes.
+constexpr uint32_t indexVersion = 1;
+constexpr std::string_view indexMagic = "SciTETri";
+
+constexpr size_t minimumFilterBits = 64;
+constexpr size_t maximumFilterBits = 64 * 1024;
+// Gives a false positive rate of about 15% for each trigram of a query.
+constexpr size_t filterBitsPerTrigram = 4;
+
+constexpr unsigned char FoldAZ(unsigned char ch) noexcept {
+	return (ch >= 'A' && ch <= 'Z') ? static_cast<unsigned char>(ch - 'A' + 'a') : ch;
+}
+
+constexpr bool IsLineEnd(unsigned char ch) noexcept {
+	return ch == '\r' || ch == '\n';
+}
+
+void AddTrigrams(std::string_view text, std::vector<Trigram> &trigrams) {
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(text.data());
+	Trigram current = 0;
+	size_t run = 0;
+	for (size_t i = 0; i < text.length(); i++) {
+		const unsigned char ch = bytes[i];
+		if (IsLineEnd(ch)) {
+			run = 0;
+			continue;
+		}
+		current = ((current << 8) | FoldAZ(ch)) & 0xffffff;
+		run++;
+		if (run >= 3) {
+			trigrams.push_back(current);
+		}
+	}
+}
+
+void SortUnique(std::vector<Trigram> &trigrams) {
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+// Two bit positions for each trigram from a 64-bit mix.
+constexpr uint64_t Mix(uint64_t x) noexcept {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+}
+
+std::vector<Trigram> TrigramsOf(std::string_view text) {
+	std::vector<Trigram> trigrams;
+	AddTrigrams(text, trigrams);
+	SortUnique(trigrams);
+	return trigrams;
+}
+
+void TrigramCollector::Add(std::string_view block) {
+	length += block.length();
+	if (Overflowed()) {
+		trigrams.clear();
+		return;
+	}
+	AddTrigrams(block, trigrams);
+	// Trigrams repeat a lot so compact before the vector becomes large
+	if (trigrams.size() > 1024 * 1024) {
+		SortUnique(trigrams);
+	}
+}
+
+std::vector<Trigram> TrigramCollector::Finish() {
+	SortUnique(trigrams);
+	return std::move(trigrams);
+}
+
+TrigramIndex::TrigramIndex(const FilePath &file_) : file(file_) {
+	if (!Load(file.Read())) {
+		// Missing or damaged so start again
+		entries.clear();
+		generation = 1;
+	}
+}
+
+bool TrigramIndex::Load(std::string_view data) {
+	BinaryReader reader(data);
+	std::string_view magic;
+	uint32_t version = 0;
+	uint32_t generationLoaded = 0;
+	uint32_t count = 0;
+	if (!reader.Bytes(indexMagic.length(), magic) || (magic != indexMagic) ||
+		!reader.U32(version) || (version != indexVersion) ||
+		!reader.U32(generationLoaded) || !reader.U32(count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t keyLength = 0;
+		std::string_view key;
+		Entry entry;
+		uint32_t filterLength = 0;
+		std::string_view filter;
+		if (!reader.U32(keyLength) || !reader.Bytes(keyLength, key) ||
+			!reader.I64(entry.modified) || !reader.I64(entry.length) ||
+			!reader.U32(entry.lastSeen) || !reader.U32(entry.flags) ||
+			!reader.U32(filterLength) || !reader.Bytes(filterLength, filter)) {
+			return false;
+		}
+		entry.filter.assign(filter.begin(), filter.end());
+		entries.emplace(key, std::move(entry));
+	}
+	generation = generationLoaded + 1;
+	return reader.AtEnd();
+}
+
+const TrigramIndex::Entry *TrigramIndex::Find(std::string_view key, long long modified, long long length) const {
+	const auto it = entries.find(key);
+	if ((it != entries.end()) && (it->second.modified == modified) && (it->second.length == length)) {
+		return &it->second;
+	}
+	return nullptr;
+}
+
+std::vector<unsigned char> TrigramIndex::FilterOf(const std::vector<Trigram> &trigrams) {
+	const size_t bits = std::clamp(std::bit_ceil(trigrams.size() * filterBitsPerTrigram),
+		minimumFilterBits, maximumFilterBits);
+	std::vector<unsigned char> filter(bits / 8);
+	for (const Trigram trigram : trigrams) {
+		const uint64_t hash = Mix(trigram);
+		const size_t first = hash & (bits - 1);
+		const size_t second = (hash >> 32) & (bits - 1);
+		filter[first / 8] |= 1U << (first % 8);
+		filter[second / 8] |= 1U << (second % 8);
+	}
+	return filter;
+}
+
+bool TrigramIndex::MayContain(const Entry &entry, const std::vector<Trigram> &query) noexcept {
+	const size_t bits = entry.filter.size() * 8;
+	if ((bits == 0) || ((bits & (bits - 1)) != 0)) {
+		return true;
+	}
+	for (const Trigram trigram : query) {
+		const uint64_t hash = Mix(trigram);
+		const size_t first = hash & (bits - 1);
+		const size_t second = (hash >> 32) & (bits - 1);
+		if (!(entry.filter[first / 8] & (1U << (first % 8))) ||
+			!(entry.filter[second / 8] & (1U << (second % 8)))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TrigramIndex::Update(std::string_view key, Entry &&entry) {
+	entry.lastSeen = generation;
+	auto it = entries.find(key);
+	if (it == entries.end()) {
+		entries.emplace(key, std::move(entry));
+	} else {
+		it->second = std::move(entry);
+	}
+}
+
+void TrigramIndex::Touch(std::string_view key) {
+	auto it = entries.find(key);
+	if (it != entries.end()) {
+		it->second.lastSeen = generation;
+	}
+}
+
+bool TrigramIndex::Save() const {
+	std::string data(indexMagic);
+	AppendU32(data, indexVersion);
+	AppendU32(data, generation);
+	const size_t countPosition = data.length();
+	AppendU32(data, 0);
+	uint32_t count = 0;
+	for (const auto &[key, entry] : entries) {
+		if (generation - entry.lastSeen > forgetAfter) {
+			continue;
+		}
+		AppendU32(data, static_cast<uint32_t>(key.length()));
+		data.append(key);
+		AppendI64(data, entry.modified);
+		AppendI64(data, entry.length);
+		AppendU32(data, entry.lastSeen);
+		AppendU32(data, entry.flags);
+		AppendU32(data, static_cast<uint32_t>(entry.filter.size()));
+		data.append(entry.filter.begin(), entry.filter.end());
+		count++;
+	}
+	memcpy(data.data() + countPosition, &count, sizeof(count));
+	// Another instance may be loading the index
+	return WriteReplacing(file, data);
+}
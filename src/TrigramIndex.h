@@ -0,0 +1,74 @@
+// SciTE - Scintilla based Text Editor
+/** @file TrigramIndex.h
+ ** Remember which trigrams each file in a tree contains so searches can skip files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+/// 3 bytes with ASCII letters folded to lower case so one index serves both case modes.
+using Trigram = uint32_t;
+
+/// The trigrams of text that do not contain line ends, sorted and without duplicates.
+std::vector<Trigram> TrigramsOf(std::string_view text);
+
+/**
+ * Accumulates the trigrams of a file that is read in blocks of complete lines.
+ * Gives up on files longer than maximumLength as their filters would match nearly everything.
+ */
+class TrigramCollector {
+	std::vector<Trigram> trigrams;
+	size_t length = 0;
+public:
+	static constexpr size_t maximumLength = 16 * 1024 * 1024;
+	void Add(std::string_view block);
+	bool Overflowed() const noexcept {
+		return length > maximumLength;
+	}
+	std::vector<Trigram> Finish();
+};
+
+/**
+ * For each file below a directory, holds its modification time and length along with a
+ * Bloom filter of its trigrams. A file whose time and length have not changed can only
+ * contain some text if the filter may contain all the trigrams of that text.
+ * Loaded before a search, read concurrently by the searching threads, then updated and
+ * saved by the thread that started the search.
+ */
+class TrigramIndex {
+public:
+	enum Flags : uint32_t {
+		flagBinary = 1,
+		flagLarge = 2,
+	};
+	struct Entry {
+		long long modified = 0;
+		long long length = 0;
+		uint32_t lastSeen = 0;
+		uint32_t flags = 0;
+		/// Empty when the trigrams are unknown so the file must always be read.
+		std::vector<unsigned char> filter;
+	};
+private:
+	FilePath file;
+	std::map<std::string, Entry, std::less<>> entries;
+	uint32_t generation = 1;
+	bool Load(std::string_view data);
+public:
+	// Entries not seen in this many searches are forgotten as their files are probably gone.
+	static constexpr uint32_t forgetAfter = 32;
+
+	explicit TrigramIndex(const FilePath &file_);
+	/// Return the entry for key if it matches modified and length, otherwise nullptr.
+	const Entry *Find(std::string_view key, long long modified, long long length) const;
+	static std::vector<unsigned char> FilterOf(const std::vector<Trigram> &trigrams);
+	static bool MayContain(const Entry &entry, const std::vector<Trigram> &query) noexcept;
+	void Update(std::string_view key, Entry &&entry);
+	/// Record that an unchanged file was seen so it is not forgotten.
+	void Touch(std::string_view key);
+	bool Save() const;
+};
+
+#endif
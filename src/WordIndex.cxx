@@ -0,0 +1,319 @@
+// SciTE - Scintilla based Text Editor
+/** @file WordIndex.cxx
+ ** Count the words in a document so they can be found by prefix.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstdint>
+#include <cstdio>
+
+#include <system_error>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <future>
+
+#include "ScintillaTypes.h"
+#include "ScintillaCall.h"
+
+#include "GUI.h"
+
+#include "StringHelpers.h"
+#include "FilePath.h"
+#include "WordIndex.h"
+
+namespace SA = Scintilla;
+
+namespace {
+
+// Text read from the document at once while scanning.
+constexpr SA::Position sizeChunk = 0x10000;
+
+// Limit the files read from a directory as they are held in memory until switching directory.
+constexpr size_t directoryFilesMaximum = 200;
+// Larger files are more likely to be data than source code.
+constexpr long long directoryFileLengthMaximum = 0x100000;
+
+}
+
+bool WordLess::operator()(std::string_view a, std::string_view b) const noexcept {
+	const size_t common = std::min(a.length(), b.length());
+	for (size_t i = 0; i < common; i++) {
+		const char upperA = MakeUpperCase(a[i]);
+		const char upperB = MakeUpperCase(b[i]);
+		if (upperA != upperB) {
+			return upperA < upperB;
+		}
+	}
+	if (a.length() != b.length()) {
+		return a.length() < b.length();
+	}
+	return a < b;
+}
+
+bool WordIndex::IsWordCharacter(char ch) const noexcept {
+	return isWord[static_cast<unsigned char>(ch)];
+}
+
+void WordIndex::Add(std::string_view text) {
+	size_t position = 0;
+	while (position < text.length()) {
+		while ((position < text.length()) && !IsWordCharacter(text[position])) {
+			position++;
+		}
+		const size_t start = position;
+		while ((position < text.length()) && IsWordCharacter(text[position])) {
+			position++;
+		}
+		if (position > start) {
+			const std::string_view word = text.substr(start, position - start);
+			std::map<std::string, size_t, WordLess>::iterator it = words.find(word);
+			if (it == words.end()) {
+				words.emplace(word, 1);
+			} else {
+				it->second++;
+			}
+		}
+	}
+}
+
+void WordIndex::Remove(std::string_view text) {
+	size_t position = 0;
+	while (position < text.length()) {
+		while ((position < text.length()) && !IsWordCharacter(text[position])) {
+			position++;
+		}
+		const size_t start = position;
+		while ((position < text.length()) && IsWordCharacter(text[position])) {
+			position++;
+		}
+		if (position > start) {
+			std::map<std::string, size_t, WordLess>::iterator it = words.find(text.substr(start, position - start));
+			if (it != words.end()) {
+				it->second--;
+				if (it->second == 0) {
+					words.erase(it);
+				}
+			}
+		}
+	}
+}
+
+void WordIndex::SetWordCharacters(const std::string &wordCharacters_) {
+	if (wordCharacters != wordCharacters_) {
+		wordCharacters = wordCharacters_;
+		isWord.fill(false);
+		for (const char ch : wordCharacters) {
+			isWord[static_cast<unsigned char>(ch)] = true;
+		}
+	}
+}
+
+void WordIndex::Start(SA::ScintillaCall *pSci, const std::string &wordCharacters_) {
+	words.clear();
+	document = pSci->DocPointer();
+	length = pSci->Length();
+	scanned = 0;
+	SetWordCharacters(wordCharacters_);
+}
+
+bool WordIndex::Indexing(SA::ScintillaCall *pSci, const std::string &wordCharacters_) const {
+	return document && (pSci->DocPointer() == document) && (wordCharacters == wordCharacters_);
+}
+
+bool WordIndex::Complete() const noexcept {
+	return document && (scanned >= length);
+}
+
+bool WordIndex::Indexed(const SA::IDocumentEditable *document_) const noexcept {
+	return Complete() && (document == document_);
+}
+
+void WordIndex::Continue(SA::ScintillaCall *pSci, double duration) {
+	if ((pSci->DocPointer() != document) || (pSci->Length() != length)) {
+		Start(pSci, wordCharacters);
+	}
+	GUI::ElapsedTime elapsed;
+	while (scanned < length) {
+		SA::Position end = std::min(scanned + sizeChunk, length);
+		std::string text = pSci->StringOfRange(SA::Span(scanned, end));
+		if (end < length) {
+			// End after the last character that is not in a word
+			size_t last = text.length();
+			while ((last > 0) && IsWordCharacter(text[last - 1])) {
+				last--;
+			}
+			if (last == 0) {
+				// The chunk is within one word so read until the word ends
+				while ((end < length) && IsWordCharacter(static_cast<char>(pSci->CharacterAt(end)))) {
+					end++;
+				}
+				text = pSci->StringOfRange(SA::Span(scanned, end));
+			} else {
+				text.resize(last);
+				end = scanned + last;
+			}
+		}
+		Add(text);
+		scanned = end;
+		if (elapsed.Duration() >= duration) {
+			break;
+		}
+	}
+}
+
+void WordIndex::Modified(SA::ScintillaCall *pSciModified, SA::Position position,
+			 SA::Position lengthInserted, SA::Position lengthDeleted, const char *textDeleted) {
+	if (!document || (pSciModified->DocPointer() != document)) {
+		return;
+	}
+	const SA::Position lengthNow = pSciModified->Length();
+	if ((lengthNow != length + lengthInserted - lengthDeleted) || ((lengthDeleted > 0) && !textDeleted)) {
+		Start(pSciModified, wordCharacters);
+		return;
+	}
+	length = lengthNow;
+	if (position > scanned) {
+		return;
+	}
+	// Words touching the change are removed and added again
+	SA::Position start = position;
+	while ((start > 0) && IsWordCharacter(static_cast<char>(pSciModified->CharacterAt(start - 1)))) {
+		start--;
+	}
+	if (start >= scanned) {
+		return;
+	}
+	SA::Position end = position + lengthInserted;
+	while ((end < length) && IsWordCharacter(static_cast<char>(pSciModified->CharacterAt(end)))) {
+		end++;
+	}
+	const SA::Position endOld = end - lengthInserted + lengthDeleted;
+	std::string textOld = pSciModified->StringOfRange(SA::Span(start, position));
+	if (lengthDeleted > 0) {
+		textOld.append(textDeleted, lengthDeleted);
+	}
+	textOld += pSciModified->StringOfRange(SA::Span(position + lengthInserted, end));
+	if (endOld <= scanned) {
+		Remove(textOld);
+		Add(pSciModified->StringOfRange(SA::Span(start, end)));
+		scanned += lengthInserted - lengthDeleted;
+	} else {
+		// Change extends into the text not yet scanned so scan again from its start
+		Remove(std::string_view(textOld).substr(0, scanned - start));
+		scanned = start;
+	}
+}
+
+void WordIndex::AddText(std::string_view text, const std::string &wordCharacters_) {
+	if (wordCharacters != wordCharacters_) {
+		words.clear();
+		SetWordCharacters(wordCharacters_);
+	}
+	Add(text);
+}
+
+std::vector<WordIndex::WordCount> WordIndex::WordsStarting(std::string_view prefix, bool ignoreCase) const {
+	std::vector<WordCount> found;
+	// Upper case sorts before lower case so this is before every case of prefix
+	std::string prefixUpper(prefix);
+	std::transform(prefixUpper.begin(), prefixUpper.end(), prefixUpper.begin(), MakeUpperCase);
+	for (std::map<std::string, size_t, WordLess>::const_iterator it = words.lower_bound(prefixUpper);
+		it != words.end(); ++it) {
+		const std::string_view word = it->first;
+		if (!EqualCaseInsensitive(word.substr(0, prefix.length()), prefix)) {
+			break;
+		}
+		if (ignoreCase || StartsWith(word, prefix)) {
+			found.push_back({word, it->second});
+		}
+	}
+	return found;
+}
+
+size_t WordIndex::Count() const noexcept {
+	return words.size();
+}
+
+void WordIndex::Stop() noexcept {
+	words.clear();
+	document = nullptr;
+	length = 0;
+	scanned = 0;
+}
+
+DirectoryWords::DirectoryWords() = default;
+
+DirectoryWords::~DirectoryWords() {
+	Wait();
+}
+
+void DirectoryWords::Read(const FilePathSet &excluded) {
+	FilePathSet directories;
+	FilePathSet files;
+	directory.List(directories, files);
+	std::sort(files.begin(), files.end());
+	size_t filesRead = 0;
+	for (const FilePath &file : files) {
+		if (cancelled || (filesRead >= directoryFilesMaximum)) {
+			break;
+		}
+		const bool open = std::any_of(excluded.begin(), excluded.end(), [&file](const FilePath &fileOpen) {
+			return fileOpen.SameNameAs(file);
+		});
+		if (!open && file.Extension().SameNameAs(extension) &&
+			(file.GetFileLength() <= directoryFileLengthMaximum)) {
+			index.AddText(file.Read(), wordCharacters);
+			filesRead++;
+		}
+	}
+}
+
+void DirectoryWords::Wait() noexcept {
+	cancelled = true;
+	if (reading.valid()) {
+		try {
+			reading.get();
+		} catch (...) {
+			// Words from files that could not be read are not needed.
+		}
+	}
+	cancelled = false;
+}
+
+bool DirectoryWords::Reading(const FilePath &directory_, const FilePath &extension_, const std::string &wordCharacters_) const {
+	return directory.SameNameAs(directory_) && extension.SameNameAs(extension_) && (wordCharacters == wordCharacters_);
+}
+
+void DirectoryWords::Start(const FilePath &directory_, const FilePath &extension_, const std::string &wordCharacters_,
+			   const FilePathSet &excluded) {
+	Wait();
+	directory = directory_;
+	extension = extension_;
+	wordCharacters = wordCharacters_;
+	read = false;
+	index.Stop();
+	try {
+		reading = std::async(std::launch::async, [this, excluded]() {
+			Read(excluded);
+		});
+	} catch (std::system_error &) {
+		// No thread available so the files are not read
+	}
+}
+
+const WordIndex *DirectoryWords::Index() {
+	if (reading.valid() && (reading.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+		Wait();
+		read = true;
+	}
+	return read ? &index : nullptr;
+}
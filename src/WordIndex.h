@@ -0,0 +1,93 @@
+// SciTE - Scintilla based Text Editor
+/** @file WordIndex.h
+ ** Count the words in a document so they can be found by prefix.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+/// Orders ignoring ASCII case then exactly so words starting with a prefix in any case are adjacent.
+struct WordLess {
+	using is_transparent = void;
+	bool operator()(std::string_view a, std::string_view b) const noexcept;
+};
+
+/**
+ * Counts of each word in a document, where words are runs of word characters. Text is
+ * scanned in steps of limited duration from the idle loop as the document can only be
+ * read on the main thread. Scanning ends each step after a word so no word spans the
+ * scanned and unscanned text. Once scanned, the counts are maintained from modification
+ * notifications by removing the words around the change and adding them again.
+ */
+class WordIndex {
+	// The document indexed and its length to detect when it changes.
+	Scintilla::IDocumentEditable *document = nullptr;
+	Scintilla::Position length = 0;
+	Scintilla::Position scanned = 0;
+	std::string wordCharacters;
+	std::array<bool, 256> isWord {};
+	std::map<std::string, size_t, WordLess> words;
+	bool IsWordCharacter(char ch) const noexcept;
+	void SetWordCharacters(const std::string &wordCharacters_);
+	void Add(std::string_view text);
+	void Remove(std::string_view text);
+public:
+	struct WordCount {
+		std::string_view word;
+		size_t count;
+	};
+	void Start(Scintilla::ScintillaCall *pSci, const std::string &wordCharacters_);
+	/// Is this indexing the document of pSci with the same word characters.
+	bool Indexing(Scintilla::ScintillaCall *pSci, const std::string &wordCharacters_) const;
+	bool Complete() const noexcept;
+	/// Is this complete for document_ so can be read while another document is current.
+	bool Indexed(const Scintilla::IDocumentEditable *document_) const noexcept;
+	/// Scan for about duration seconds.
+	void Continue(Scintilla::ScintillaCall *pSci, double duration);
+	/// Adjust for text inserted or deleted in pSciModified. textDeleted is the deleted text
+	/// which is needed to remove its words. When that is not possible, scanning starts again.
+	void Modified(Scintilla::ScintillaCall *pSciModified, Scintilla::Position position,
+		      Scintilla::Position lengthInserted, Scintilla::Position lengthDeleted, const char *textDeleted);
+	/// Add the words of text that is not in a document such as the contents of a file.
+	void AddText(std::string_view text, const std::string &wordCharacters_);
+	/// Words starting with prefix in WordLess order. Views are valid until the index changes.
+	std::vector<WordCount> WordsStarting(std::string_view prefix, bool ignoreCase) const;
+	size_t Count() const noexcept;
+	void Stop() noexcept;
+};
+
+/**
+ * Words in the files of a directory with one extension, such as the other source files of
+ * a project. Files are read by a thread so switching files is not delayed and the words
+ * are only available once all the files have been read.
+ */
+class DirectoryWords {
+	FilePath directory;
+	FilePath extension;
+	std::string wordCharacters;
+	std::atomic_bool cancelled {false};
+	std::future<void> reading;
+	bool read = false;
+	WordIndex index;
+	void Read(const FilePathSet &excluded);
+	void Wait() noexcept;
+public:
+	DirectoryWords();
+	// Deleted so DirectoryWords objects can not be copied.
+	DirectoryWords(const DirectoryWords &) = delete;
+	DirectoryWords(DirectoryWords &&) = delete;
+	DirectoryWords &operator=(const DirectoryWords &) = delete;
+	DirectoryWords &operator=(DirectoryWords &&) = delete;
+	~DirectoryWords();
+	/// Is this reading or has read the same files.
+	bool Reading(const FilePath &directory_, const FilePath &extension_, const std::string &wordCharacters_) const;
+	/// Read the files except for those in excluded as they are open and indexed as documents.
+	void Start(const FilePath &directory_, const FilePath &extension_, const std::string &wordCharacters_,
+		   const FilePathSet &excluded);
+	/// The words once all the files have been read, otherwise nullptr.
+	const WordIndex *Index();
+};
+
+#endif
@@ -0,0 +1,38 @@
+/** @file ScintillaCall.h
+ ** Stand-in for a Scintilla instance holding its document text in a string so
+ ** modifications can be made and reported by tests
+ **/
+
+#ifndef SCINTILLACALL_H
+#define SCINTILLACALL_H
+
+namespace Scintilla {
+
+class ScintillaCall {
+	// Only compared, never dereferenced, so any distinct non-null value will do.
+	IDocumentEditable *document;
+public:
+	std::string text;
+	explicit ScintillaCall(std::string_view text_={}) :
+		document(reinterpret_cast<IDocumentEditable *>(this)), text(text_) {
+	}
+	IDocumentEditable *DocPointer() const noexcept {
+		return document;
+	}
+	Position Length() const noexcept {
+		return static_cast<Position>(text.length());
+	}
+	int CharacterAt(Position position) const noexcept {
+		if ((position < 0) || (position >= Length())) {
+			return 0;
+		}
+		return static_cast<unsigned char>(text[position]);
+	}
+	std::string StringOfRange(Span span) const {
+		return text.substr(span.start, span.end - span.start);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,23 @@
+/** @file ScintillaTypes.h
+ ** Stand-in for the Scintilla types needed by the files being tested
+ **/
+
+#ifndef SCINTILLATYPES_H
+#define SCINTILLATYPES_H
+
+namespace Scintilla {
+
+using Position = intptr_t;
+
+struct Span {
+	Position start;
+	Position end;
+	constexpr Span(Position start_, Position end_) noexcept : start(start_), end(end_) {
+	}
+};
+
+class IDocumentEditable;
+
+}
+
+#endif
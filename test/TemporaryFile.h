@@ -0,0 +1,35 @@
+/** @file TemporaryFile.h
+ ** A file in the temporary directory for tests that is removed at the end of the test
+ **/
+
+#ifndef TEMPORARYFILE_H
+#define TEMPORARYFILE_H
+
+class TemporaryFile {
+	std::filesystem::path path;
+public:
+	explicit TemporaryFile(std::string_view name) : path(std::filesystem::temp_directory_path() / name) {
+		std::filesystem::remove(path);
+	}
+	// Deleted so TemporaryFile objects can not be copied.
+	TemporaryFile(const TemporaryFile &) = delete;
+	TemporaryFile(TemporaryFile &&) = delete;
+	TemporaryFile &operator=(const TemporaryFile &) = delete;
+	TemporaryFile &operator=(TemporaryFile &&) = delete;
+	~TemporaryFile() {
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+	}
+	FilePath File() const {
+		return FilePath(path.native());
+	}
+	std::string Contents() const {
+		return File().Read();
+	}
+	void Write(std::string_view contents) const {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << contents;
+	}
+};
+
+#endif
@@ -4,7 +4,7 @@
 DEL = del /q
 EXE = unitTest.exe
 
-INCLUDEDIRS = /I../src
+INCLUDEDIRS = /I. /I../src
 
 CXXFLAGS = /MP /EHsc /std:c++20 $(OPTIMIZATION) /nologo /D_HAS_AUTO_PTR_ETC=1 /wd 4805 $(INCLUDEDIRS)
 
@@ -13,8 +13,19 @@ TESTSRC=test*.cxx
 # Files being tested from scintilla/src directory
 TESTEDSRC=\
  ../src/Cookie.cxx \
+ ../src/EditorConfig.cxx \
+ ../src/FilePath.cxx \
+ ../src/IgnoreRules.cxx \
+ ../src/PathMatch.cxx \
+ ../src/PhaseProfile.cxx \
+ ../src/PropSetFile.cxx \
+ ../src/RegexSearch.cxx \
  ../src/StringHelpers.cxx \
- ../src/Utf8_16.cxx
+ ../src/StringList.cxx \
+ ../src/SubstringSearch.cxx \
+ ../src/TrigramIndex.cxx \
+ ../src/Utf8_16.cxx \
+ ../src/WordIndex.cxx
 
 TESTS=$(EXE)
 
@@ -26,5 +37,5 @@ test: $(TESTS)
 clean:
 	$(DEL) $(TESTS) *.o *.obj *.exe
 
-$(EXE): $(TESTSRC) $(TESTEDSRC) $(@B).obj
+$(EXE): $(TESTSRC) $(TESTEDSRC) GUIStub.cxx $(@B).obj
 	$(CXX) $(CXXFLAGS) /Fe$@ $**
@@ -0,0 +1,171 @@
+/** @file testIgnoreRules.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <chrono>
+
+#include "GUI.h"
+
+#include "FilePath.h"
+#include "IgnoreRules.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+using Decision = IgnoreRules::Decision;
+
+IgnoreRules RulesOf(std::string_view text) {
+	IgnoreRules rules;
+	rules.Add(text);
+	return rules;
+}
+
+}
+
+TEST_CASE("IgnoreRules") {
+
+	SECTION("Lines") {
+		REQUIRE(RulesOf("").Empty());
+		REQUIRE(RulesOf("\n# comment\n   \n\r\n/\n!\n").Empty());
+		const IgnoreRules rules = RulesOf("# comment\r\n*.o\r\nspace  \r\nescaped\\ \n\\#hash\n");
+		REQUIRE(rules.Check("a.o", false) == Decision::ignore);
+		REQUIRE(rules.Check("# comment", false) == Decision::none);
+		// Trailing spaces are removed unless escaped
+		REQUIRE(rules.Check("space", false) == Decision::ignore);
+		REQUIRE(rules.Check("escaped ", false) == Decision::ignore);
+		REQUIRE(rules.Check("escaped", false) == Decision::none);
+		REQUIRE(rules.Check("#hash", false) == Decision::ignore);
+	}
+
+	SECTION("Names") {
+		// Patterns without '/' match the name at any depth
+		const IgnoreRules rules = RulesOf("*.log\nbuild\n");
+		REQUIRE(rules.Check("debug.log", false) == Decision::ignore);
+		REQUIRE(rules.Check("src/deep/debug.log", false) == Decision::ignore);
+		REQUIRE(rules.Check("build", true) == Decision::ignore);
+		REQUIRE(rules.Check("src/build", false) == Decision::ignore);
+		REQUIRE(rules.Check("log", false) == Decision::none);
+		REQUIRE(rules.Check("debug.log.txt", false) == Decision::none);
+		// Only the name is matched so directories above do not count
+		REQUIRE(rules.Check("build/main.c", false) == Decision::none);
+		REQUIRE(rules.Check("x.log/main.c", false) == Decision::none);
+	}
+
+	SECTION("Negation") {
+		const IgnoreRules rules = RulesOf("*.log\n!keep.log\n");
+		REQUIRE(rules.Check("debug.log", false) == Decision::ignore);
+		REQUIRE(rules.Check("keep.log", false) == Decision::include);
+		REQUIRE(rules.Check("src/keep.log", false) == Decision::include);
+		// Later patterns override earlier ones
+		const IgnoreRules reversed = RulesOf("!keep.log\n*.log\n");
+		REQUIRE(reversed.Check("keep.log", false) == Decision::ignore);
+		// An escaped '!' is part of the name
+		const IgnoreRules escaped = RulesOf("\\!important\n");
+		REQUIRE(escaped.Check("!important", false) == Decision::ignore);
+		REQUIRE(escaped.Check("important", false) == Decision::none);
+	}
+
+	SECTION("Anchored") {
+		// A leading '/' or a '/' within the pattern matches from the directory of the rules
+		const IgnoreRules rules = RulesOf("/build\ndoc/*.html\n");
+		REQUIRE(rules.Check("build", true) == Decision::ignore);
+		REQUIRE(rules.Check("src/build", true) == Decision::none);
+		REQUIRE(rules.Check("doc/index.html", false) == Decision::ignore);
+		REQUIRE(rules.Check("src/doc/index.html", false) == Decision::none);
+		// '*' and '?' do not match '/'
+		REQUIRE(rules.Check("doc/api/index.html", false) == Decision::none);
+		const IgnoreRules single = RulesOf("a/*/c\na?b/x\n");
+		REQUIRE(single.Check("a/b/c", false) == Decision::ignore);
+		REQUIRE(single.Check("a/b/b/c", false) == Decision::none);
+		REQUIRE(single.Check("a//c", false) == Decision::ignore);
+		REQUIRE(single.Check("a-b/x", false) == Decision::ignore);
+		REQUIRE(single.Check("a/b/x", false) == Decision::none);
+	}
+
+	SECTION("DirectoryOnly") {
+		const IgnoreRules rules = RulesOf("out/\n/bin/\nlib/cache/\n");
+		REQUIRE(rules.Check("out", true) == Decision::ignore);
+		REQUIRE(rules.Check("out", false) == Decision::none);
+		// A trailing '/' alone does not anchor the pattern
+		REQUIRE(rules.Check("src/out", true) == Decision::ignore);
+		REQUIRE(rules.Check("bin", true) == Decision::ignore);
+		REQUIRE(rules.Check("src/bin", true) == Decision::none);
+		REQUIRE(rules.Check("lib/cache", true) == Decision::ignore);
+		REQUIRE(rules.Check("lib/cache", false) == Decision::none);
+		REQUIRE(rules.Check("src/lib/cache", true) == Decision::none);
+	}
+
+	SECTION("AnyDepth") {
+		// Leading "**/" matches in all directories
+		const IgnoreRules leading = RulesOf("**/foo\n**/foo/bar\n");
+		REQUIRE(leading.Check("foo", false) == Decision::ignore);
+		REQUIRE(leading.Check("a/b/foo", true) == Decision::ignore);
+		REQUIRE(leading.Check("foo/bar", false) == Decision::ignore);
+		REQUIRE(leading.Check("a/b/foo/bar", false) == Decision::ignore);
+		REQUIRE(leading.Check("a/foo/bar/baz", false) == Decision::none);
+		// Trailing "/**" matches everything inside
+		const IgnoreRules trailing = RulesOf("abc/**\n");
+		REQUIRE(trailing.Check("abc/x", false) == Decision::ignore);
+		REQUIRE(trailing.Check("abc/x/y.c", false) == Decision::ignore);
+		REQUIRE(trailing.Check("abc", true) == Decision::none);
+		REQUIRE(trailing.Check("src/abc/x", false) == Decision::none);
+		// "/**/" matches zero or more directories
+		const IgnoreRules middle = RulesOf("a/**/b\nx/**/y/**/z\n");
+		REQUIRE(middle.Check("a/b", false) == Decision::ignore);
+		REQUIRE(middle.Check("a/x/b", false) == Decision::ignore);
+		REQUIRE(middle.Check("a/x/y/b", false) == Decision::ignore);
+		REQUIRE(middle.Check("a/bc", false) == Decision::none);
+		REQUIRE(middle.Check("c/a/b", false) == Decision::none);
+		REQUIRE(middle.Check("x/y/z", false) == Decision::ignore);
+		REQUIRE(middle.Check("x/1/y/z", false) == Decision::ignore);
+		REQUIRE(middle.Check("x/y/1/2/z", false) == Decision::ignore);
+		REQUIRE(middle.Check("x/1/y/2/z", false) == Decision::ignore);
+		REQUIRE(middle.Check("x/z", false) == Decision::none);
+	}
+
+	SECTION("Case") {
+		const IgnoreRules rules = RulesOf("Makefile\n");
+		REQUIRE(rules.Check("Makefile", false) == Decision::ignore);
+		REQUIRE(rules.Check("makefile", false) == (FilePath::CaseSensitive() ? Decision::none : Decision::ignore));
+	}
+}
+
+TEST_CASE("IgnoreStack") {
+
+	SECTION("Nested") {
+		auto top = std::make_shared<const IgnoreStack>(RulesOf("*.log\n/build/\n"), "", nullptr);
+		const IgnoreStack sub(RulesOf("!keep.log\nbuild/\n"), "sub/", top);
+		REQUIRE(top->Ignored("a.log", false));
+		REQUIRE(top->Ignored("build", true));
+		REQUIRE(!top->Ignored("sub/build", true));
+		REQUIRE(!top->Ignored("a.txt", false));
+		// Rules closer to the path take precedence
+		REQUIRE(sub.Ignored("sub/a.log", false));
+		REQUIRE(!sub.Ignored("sub/keep.log", false));
+		REQUIRE(!sub.Ignored("sub/deep/keep.log", false));
+		REQUIRE(sub.Ignored("sub/build", true));
+		REQUIRE(sub.Ignored("sub/deep/build", true));
+		REQUIRE(!sub.Ignored("sub/build", false));
+		REQUIRE(!sub.Ignored("sub/a.txt", false));
+	}
+
+	SECTION("AnchoredBelow") {
+		// Anchored patterns in a lower directory match from that directory
+		auto top = std::make_shared<const IgnoreStack>(IgnoreRules(), "", nullptr);
+		const IgnoreStack sub(RulesOf("/gen\ndoc/*.html\n"), "src/", top);
+		REQUIRE(sub.Ignored("src/gen", true));
+		REQUIRE(!sub.Ignored("src/lib/gen", true));
+		REQUIRE(sub.Ignored("src/doc/a.html", false));
+		REQUIRE(!sub.Ignored("src/doc/api/a.html", false));
+		REQUIRE(!sub.Ignored("src/lib/doc/a.html", false));
+	}
+}
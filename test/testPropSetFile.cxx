@@ -0,0 +1,524 @@
+/** @file testPropSetFile.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "GUI.h"
+
+#include "FilePath.h"
+#include "PropSetFile.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+// A directory of properties files that is removed at the end of the test.
+class PropertiesDirectory {
+	std::filesystem::path directory;
+public:
+	PropertiesDirectory() : directory(std::filesystem::temp_directory_path() / "SciTEUnitTestProperties") {
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directory(directory);
+	}
+	// Deleted so PropertiesDirectory objects can not be copied.
+	PropertiesDirectory(const PropertiesDirectory &) = delete;
+	PropertiesDirectory(PropertiesDirectory &&) = delete;
+	PropertiesDirectory &operator=(const PropertiesDirectory &) = delete;
+	PropertiesDirectory &operator=(PropertiesDirectory &&) = delete;
+	~PropertiesDirectory() {
+		std::error_code ec;
+		std::filesystem::remove_all(directory, ec);
+	}
+	void Add(const char *name, std::string_view text) const {
+		std::ofstream file(directory / name, std::ios::binary);
+		file << text;
+	}
+	FilePath Directory() const {
+		return FilePath(directory.native());
+	}
+	FilePath File(const char *name) const {
+		return FilePath((directory / name).native());
+	}
+};
+
+// Similar to html.properties which uses keywords from the files of languages that can be embedded
+constexpr std::string_view htmlProperties =
+	"file.patterns.html=*.html;*.php\n"
+	"lexer.$(file.patterns.html)=hypertext\n"
+	"keywords.$(file.patterns.html)=$(keywordclass.hypertext)\n"
+	"keywordclass.hypertext=a b body\n"
+	"keywords3.$(file.patterns.html)=$(keywordclass.vb)\n"
+	"keywords4.$(file.patterns.html)=$(keywordclass.python)\n";
+
+constexpr std::string_view pythonProperties =
+	"file.patterns.py=*.py\n"
+	"lexer.$(file.patterns.py)=python\n"
+	"keywordclass.python=and def\n"
+	"keywords.$(file.patterns.py)=$(keywordclass.python)\n";
+
+// Uses a variable from another language so keywords4 of html needs 2 more files
+constexpr std::string_view vbProperties =
+	"file.patterns.vb=*.vb\n"
+	"lexer.$(file.patterns.vb)=vb\n"
+	"keywordclass.vb=dim $(keywordclass.basic)\n"
+	"keywords.$(file.patterns.vb)=$(keywordclass.vb)\n";
+
+constexpr std::string_view basicProperties =
+	"file.patterns.basic=*.bas\n"
+	"lexer.$(file.patterns.basic)=blitzbasic\n"
+	"keywordclass.basic=goto gosub\n";
+
+void AddLanguages(const PropertiesDirectory &directory) {
+	directory.Add("SciTEGlobal.properties", "import *\nkeywords.after=$(keywordclass.python)\n");
+	directory.Add("basic.properties", basicProperties);
+	directory.Add("html.properties", htmlProperties);
+	directory.Add("python.properties", pythonProperties);
+	directory.Add("vb.properties", vbProperties);
+}
+
+// Find key by enumerating each set so no cached results are used.
+std::string UncachedGet(const PropSetFile &props, std::string_view key) {
+	for (const PropSetFile *psf = &props; psf; psf = psf->superPS) {
+		const char *keyEnumerated = nullptr;
+		const char *value = nullptr;
+		for (bool more = psf->GetFirst(keyEnumerated, value); more; more = psf->GetNext(keyEnumerated, value)) {
+			if (key == keyEnumerated) {
+				return value;
+			}
+		}
+	}
+	return {};
+}
+
+// Keys used by the cache tests including one never set.
+constexpr std::string_view keysCached[] = { "a", "b", "c", "d", "missing" };
+
+void RequireSameAsUncached(const PropSetFile &props) {
+	for (const std::string_view key : keysCached) {
+		REQUIRE(props.Get(key) == UncachedGet(props, key));
+	}
+}
+
+// A copy has no cached results so expands without them.
+std::string UncachedExpanded(const PropSetFile &props, std::string_view key) {
+	const PropSetFile propsCopy(props);
+	return propsCopy.GetExpandedString(key);
+}
+
+// Match as GetWild did before patterns were indexed, trying each in turn.
+bool MatchWild(std::string_view pattern, std::string_view text, bool caseSensitive) {
+	if (pattern.empty()) {
+		return text.empty();
+	}
+	if (pattern.front() == '*') {
+		for (size_t start = 0; start <= text.length(); start++) {
+			if (MatchWild(pattern.substr(1), text.substr(start), caseSensitive)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	if (text.empty()) {
+		return false;
+	}
+	const bool same = caseSensitive ? (pattern.front() == text.front()) :
+		(std::toupper(static_cast<unsigned char>(pattern.front())) == std::toupper(static_cast<unsigned char>(text.front())));
+	return ((pattern.front() == '?') || same) && MatchWild(pattern.substr(1), text.substr(1), caseSensitive);
+}
+
+std::string UncachedGetWild(const PropSetFile &props, std::string_view keybase, std::string_view filename, bool caseSensitive) {
+	for (const PropSetFile *psf = &props; psf; psf = psf->superPS) {
+		const char *key = nullptr;
+		const char *value = nullptr;
+		for (bool more = psf->GetFirst(key, value); more; more = psf->GetNext(key, value)) {
+			const std::string_view keyView(key);
+			if (!keyView.starts_with(keybase)) {
+				continue;
+			}
+			std::string patterns(keyView.substr(keybase.length()));
+			if (patterns.empty()) {
+				return value;
+			}
+			if (patterns.starts_with("$(") && (patterns.find(')') != std::string::npos)) {
+				patterns = UncachedExpanded(props, patterns.substr(2, patterns.find(')') - 2));
+			}
+			std::string_view patternSet(patterns);
+			while (!patternSet.empty()) {
+				const size_t separator = patternSet.find(';');
+				if (MatchWild(patternSet.substr(0, separator), filename, caseSensitive)) {
+					return value;
+				}
+				patternSet = (separator == std::string_view::npos) ? "" : patternSet.substr(separator + 1);
+			}
+		}
+	}
+	return {};
+}
+
+constexpr const char *fileNames[] = {
+	"a.cxx", "A.CXX", "a.b.cxx", "a.h", "ab.h", "makefile", "Makefile", "x.cpp", "a.cxx.bak", "readme", "",
+};
+
+void RequireWildSameAsUncached(const PropSetFile &props, std::string_view keybase, bool caseSensitive=false) {
+	for (const char *fileName : fileNames) {
+		REQUIRE(props.GetWild(keybase, fileName) == UncachedGetWild(props, keybase, fileName, caseSensitive));
+	}
+}
+
+void ReadLanguages(PropSetFile &props, const PropertiesDirectory &directory, bool lazy) {
+	ImportFilter filter;
+	filter.lazy = lazy;
+	props.Read(directory.File("SciTEGlobal.properties"), directory.Directory(), filter, nullptr, 0);
+}
+
+}
+
+// Test PropSetFile.
+
+TEST_CASE("PropSetFile") {
+
+	SECTION("CachedGetFollowsBaseSets") {
+		PropSetFile propsGrand;
+		propsGrand.Set("d", "grand");
+		PropSetFile propsBase;
+		propsBase.superPS = &propsGrand;
+		propsBase.Set("a", "1");
+		propsBase.Set("b", "2");
+		PropSetFile props;
+		props.superPS = &propsBase;
+		props.Set("c", "3");
+		RequireSameAsUncached(props);
+		REQUIRE(props.Get("a") == "1");
+		REQUIRE(props.Get("d") == "grand");
+		// Changing a base set must not leave old results
+		propsBase.Set("a", "changed");
+		REQUIRE(props.Get("a") == "changed");
+		propsBase.Unset("b");
+		REQUIRE(props.Get("b").empty());
+		REQUIRE(!props.Exists("b"));
+		propsGrand.Set("d", "grand changed");
+		REQUIRE(props.Get("d") == "grand changed");
+		RequireSameAsUncached(props);
+		// Replacing a base set
+		PropSetFile propsOther;
+		propsOther.Set("a", "other");
+		props.superPS = &propsOther;
+		REQUIRE(props.Get("a") == "other");
+		REQUIRE(props.Get("d").empty());
+		RequireSameAsUncached(props);
+		// Base set changed and changed back to its earlier contents
+		props.superPS = &propsBase;
+		propsBase.Set("a", "1");
+		propsBase.Set("a", "changed");
+		REQUIRE(props.Get("a") == "changed");
+		RequireSameAsUncached(props);
+	}
+
+	SECTION("CachedGetAfterChanges") {
+		PropSetFile propsBase;
+		propsBase.Set("a", "base");
+		PropSetFile props;
+		props.superPS = &propsBase;
+		REQUIRE(props.Get("a") == "base");
+		props.Set("a", "mine");
+		REQUIRE(props.Get("a") == "mine");
+		props.Set("b", "2");
+		// Setting another key keeps the result for a
+		REQUIRE(props.Get("a") == "mine");
+		REQUIRE(props.Get("b") == "2");
+		props.Unset("a");
+		REQUIRE(props.Get("a") == "base");
+		propsBase.Unset("a");
+		REQUIRE(props.Get("a").empty());
+		REQUIRE(!props.Exists("a"));
+		props.Unset("missing");
+		RequireSameAsUncached(props);
+		props.Clear();
+		REQUIRE(props.Get("b").empty());
+		RequireSameAsUncached(props);
+	}
+
+	SECTION("CachedGetWithCopies") {
+		PropSetFile propsBase;
+		propsBase.Set("a", "base");
+		PropSetFile props;
+		props.superPS = &propsBase;
+		props.Set("b", "2");
+		RequireSameAsUncached(props);
+
+		PropSetFile propsCopy(props);
+		propsCopy.Set("b", "copy");
+		REQUIRE(propsCopy.Get("b") == "copy");
+		REQUIRE(props.Get("b") == "2");
+		RequireSameAsUncached(propsCopy);
+		RequireSameAsUncached(props);
+
+		// Assignment replaces contents whose results are cached
+		PropSetFile propsAssigned;
+		propsAssigned.Set("b", "assigned");
+		propsAssigned.Set("c", "assigned");
+		REQUIRE(propsAssigned.Get("b") == "assigned");
+		REQUIRE(propsAssigned.Get("c") == "assigned");
+		propsAssigned = props;
+		REQUIRE(propsAssigned.Get("b") == "2");
+		REQUIRE(propsAssigned.Get("c").empty());
+		REQUIRE(propsAssigned.Get("a") == "base");
+		RequireSameAsUncached(propsAssigned);
+
+		PropSetFile propsMoved(std::move(propsCopy));
+		REQUIRE(propsMoved.Get("b") == "copy");
+		RequireSameAsUncached(propsMoved);
+		// Moved from set is empty but still has its base set
+		REQUIRE(propsCopy.Get("b").empty());
+		REQUIRE(propsCopy.Get("a") == "base");
+		RequireSameAsUncached(propsCopy);
+
+		PropSetFile propsMoveAssigned;
+		propsMoveAssigned.Set("a", "replaced");
+		REQUIRE(propsMoveAssigned.Get("a") == "replaced");
+		propsMoveAssigned = std::move(propsMoved);
+		REQUIRE(propsMoveAssigned.Get("a") == "base");
+		REQUIRE(propsMoveAssigned.Get("b") == "copy");
+		RequireSameAsUncached(propsMoveAssigned);
+		propsMoveAssigned.Set("b", "after move");
+		REQUIRE(propsMoveAssigned.Get("b") == "after move");
+		RequireSameAsUncached(propsMoveAssigned);
+
+		// Base set switched between buffers' sets then back, as with SciTE's discovered properties
+		PropSetFile bufferA;
+		bufferA.Set("k", "A");
+		PropSetFile bufferB;
+		bufferB.Set("j", "B");
+		bufferB.Set("k", "B");
+		bufferB.Set("l", "B");
+		PropSetFile discovered;
+		PropSetFile propsDerived;
+		propsDerived.superPS = &discovered;
+		discovered = bufferA;
+		REQUIRE(propsDerived.Get("k") == "A");
+		discovered = bufferB;
+		REQUIRE(propsDerived.Get("k") == "B");
+		discovered = bufferA;
+		REQUIRE(propsDerived.Get("k") == "A");
+		discovered = bufferB;
+		discovered = bufferA;
+		REQUIRE(propsDerived.Get("k") == "A");
+		bufferA.Set("k", "A2");
+		discovered = std::move(bufferA);
+		REQUIRE(propsDerived.Get("k") == "A2");
+		RequireSameAsUncached(propsDerived);
+	}
+
+	SECTION("CachedExpansionFollowsVariables") {
+		PropSetFile propsBase;
+		propsBase.Set("c", "C");
+		PropSetFile props;
+		props.superPS = &propsBase;
+		props.Set("a", "$(b)-$(c)");
+		props.Set("b", "B");
+		REQUIRE(props.GetExpandedString("a") == "B-C");
+		props.Set("b", "B2");
+		REQUIRE(props.GetExpandedString("a") == "B2-C");
+		REQUIRE(props.Expand("[$(a)]") == "[B2-C]");
+		propsBase.Set("c", "C2");
+		REQUIRE(props.GetExpandedString("a") == "B2-C2");
+		props.Unset("b");
+		REQUIRE(props.GetExpandedString("a") == "-C2");
+		// Variable defined later in a derived set hides the base set
+		props.Set("c", "mine");
+		REQUIRE(props.GetExpandedString("a") == "-mine");
+		REQUIRE(props.GetExpandedString("a") == UncachedExpanded(props, "a"));
+		// Nested variable names depend on both variables
+		props.Set("d", "$(x$(b))");
+		props.Set("b", "1");
+		props.Set("x1", "one");
+		props.Set("x2", "two");
+		REQUIRE(props.GetExpandedString("d") == "one");
+		props.Set("b", "2");
+		REQUIRE(props.GetExpandedString("d") == "two");
+		props.Set("x2", "TWO");
+		REQUIRE(props.GetExpandedString("d") == "TWO");
+		REQUIRE(props.GetExpandedString("d") == UncachedExpanded(props, "d"));
+	}
+
+	SECTION("CachedExpansionOfFunctions") {
+		PropSetFile props;
+		props.Set("b", "it's");
+		props.Set("escaped", "$(escape b)");
+		REQUIRE(props.GetExpandedString("escaped") == "it\\'s");
+		props.Set("b", "plain");
+		REQUIRE(props.GetExpandedString("escaped") == "plain");
+		// star depends on every key with a prefix so is evaluated each time
+		props.Set("options", "$(star opt.)");
+		props.Set("opt.1", "x");
+		REQUIRE(props.GetExpandedString("options") == "x");
+		props.Set("opt.2", "y");
+		REQUIRE(props.GetExpandedString("options") == "xy");
+		props.Set("same", "$(= $(b);plain)");
+		REQUIRE(props.GetExpandedString("same") == "1");
+		props.Set("b", "other");
+		REQUIRE(props.GetExpandedString("same") == "0");
+		for (const char *key : { "escaped", "options", "same" }) {
+			REQUIRE(props.GetExpandedString(key) == UncachedExpanded(props, key));
+		}
+	}
+
+	SECTION("CachedExpansionWithBlankedSelfReferences") {
+		PropSetFile propsBase;
+		propsBase.Set("x", "base");
+		PropSetFile props;
+		props.superPS = &propsBase;
+		// Self references expand to nothing instead of the base value
+		props.Set("x", "$(x) more");
+		REQUIRE(props.GetExpandedString("x") == " more");
+		REQUIRE(props.Expand("$(x)") == " more");
+		// Within a cycle, the value of c depends on where expansion started so expanding
+		// c inside a must not be reused when expanding c itself
+		props.Set("a", "$(b)-$(c)");
+		props.Set("b", "$(c)");
+		props.Set("c", "$(a)X");
+		REQUIRE(props.GetExpandedString("a") == "X-X");
+		REQUIRE(props.GetExpandedString("c") == "-X");
+		REQUIRE(props.GetExpandedString("b") == "-X");
+		REQUIRE(props.GetExpandedString("a") == "X-X");
+		for (const char *key : { "a", "b", "c", "x" }) {
+			REQUIRE(props.GetExpandedString(key) == UncachedExpanded(props, key));
+		}
+		// Breaking the cycle
+		props.Set("c", "C");
+		REQUIRE(props.GetExpandedString("a") == "C-C");
+		REQUIRE(props.GetExpandedString("b") == "C");
+	}
+
+	SECTION("CachedExpansionWithLimit") {
+		PropSetFile props;
+		props.Set("v1", "$(v2)");
+		props.Set("v2", "$(v3)");
+		props.Set("v3", "$(v4)");
+		props.Set("v4", "end");
+		REQUIRE(props.GetExpandedString("v1") == "end");
+		// A cached complete expansion is not used when fewer expansions are allowed
+		const PropSetFile propsCopy(props);
+		for (int maxExpands = 0; maxExpands < 6; maxExpands++) {
+			REQUIRE(props.Expand("$(v1)", maxExpands) == PropSetFile(propsCopy).Expand("$(v1)", maxExpands));
+		}
+		REQUIRE(props.Expand("$(v1)", 1) != "end");
+	}
+
+	SECTION("WildPatternOrder") {
+		PropSetFile propsGrand;
+		propsGrand.Set("x.*", "base always");
+		PropSetFile propsBase;
+		propsBase.superPS = &propsGrand;
+		propsBase.Set("x.*.h", "base h");
+		PropSetFile props;
+		props.superPS = &propsBase;
+		// '?' sorts before letters so the glob is tried before the extension
+		props.Set("x.*.c?x", "glob c?x");
+		props.Set("x.*.cxx", "extension cxx");
+		// '*' sorts before letters so the extension is tried before these globs
+		props.Set("x.a*.cxx", "glob a*");
+		props.Set("x.a?.h", "glob a?.h");
+		props.Set("x.*.b.cxx", "extension b.cxx");
+		props.Set("x.makefile", "name");
+		props.Set("x.*.bak;readme", "extension bak or name");
+		RequireWildSameAsUncached(props, "x.");
+		REQUIRE(props.GetWild("x.", "a.cxx") == "glob c?x");
+		REQUIRE(props.GetWild("x.", "a.b.cxx") == "extension b.cxx");
+		REQUIRE(props.GetWild("x.", "ab.h") == "glob a?.h");
+		REQUIRE(props.GetWild("x.", "a.h") == "base h");
+		REQUIRE(props.GetWild("x.", "x.cpp") == "base always");
+		REQUIRE(props.GetWild("x.", "Makefile") == "name");
+		props.Unset("x.*.c?x");
+		REQUIRE(props.GetWild("x.", "a.cxx") == "extension cxx");
+		REQUIRE(props.GetWild("x.", "A.CXX") == "extension cxx");
+		RequireWildSameAsUncached(props, "x.");
+		// An always matching key in the derived set is found before the base set's keys
+		props.Set("x.", "derived always");
+		REQUIRE(props.GetWild("x.", "a.h") == "derived always");
+		RequireWildSameAsUncached(props, "x.");
+		PropSetFile::SetCaseSensitiveFilenames(true);
+		props.Unset("x.");
+		REQUIRE(props.GetWild("x.", "A.CXX") == "base always");
+		REQUIRE(props.GetWild("x.", "makefile") == "name");
+		REQUIRE(props.GetWild("x.", "Makefile") == "base always");
+		RequireWildSameAsUncached(props, "x.", true);
+		PropSetFile::SetCaseSensitiveFilenames(false);
+		RequireWildSameAsUncached(props, "x.");
+	}
+
+	SECTION("WildVariableKeys") {
+		PropSetFile propsBase;
+		propsBase.Set("ext.cpp", "*.cxx");
+		PropSetFile props;
+		props.superPS = &propsBase;
+		props.Set("file.patterns.cpp", "$(ext.cpp);*.h");
+		props.Set("keywords.$(file.patterns.cpp)", "int");
+		props.Set("keywords.$(file.patterns.make)", "include");
+		props.Set("file.patterns.make", "makefile");
+		RequireWildSameAsUncached(props, "keywords.");
+		REQUIRE(props.GetWild("keywords.", "a.cxx") == "int");
+		REQUIRE(props.GetWild("keywords.", "x.cpp").empty());
+		// Changing a variable used by a key changes the patterns
+		props.Set("file.patterns.cpp", "*.cpp");
+		REQUIRE(props.GetWild("keywords.", "a.cxx").empty());
+		REQUIRE(props.GetWild("keywords.", "x.cpp") == "int");
+		RequireWildSameAsUncached(props, "keywords.");
+		// Including a variable from a base set used by that variable
+		props.Set("file.patterns.cpp", "$(ext.cpp)");
+		REQUIRE(props.GetWild("keywords.", "a.cxx") == "int");
+		propsBase.Set("ext.cpp", "*.h");
+		REQUIRE(props.GetWild("keywords.", "a.cxx").empty());
+		REQUIRE(props.GetWild("keywords.", "a.h") == "int");
+		RequireWildSameAsUncached(props, "keywords.");
+		props.Unset("file.patterns.make");
+		REQUIRE(props.GetWild("keywords.", "makefile").empty());
+		RequireWildSameAsUncached(props, "keywords.");
+		// Values found by GetWild are expanded using GetWild for each variable
+		props.Set("word.$(file.patterns.cpp)", "$(keywords.) long");
+		REQUIRE(props.GetNewExpandString("word.", "a.h") == "int long");
+		REQUIRE(props.GetNewExpandString("word.", "makefile").empty());
+	}
+
+	SECTION("LazyImportUsesVariablesFromOtherFiles") {
+		const PropertiesDirectory directory;
+		AddLanguages(directory);
+		PropSetFile propsEager;
+		ReadLanguages(propsEager, directory, false);
+		PropSetFile propsLazy;
+		ReadLanguages(propsLazy, directory, true);
+		// Python is used by a line after the imports so is read along with any language
+		propsLazy.ReadLanguage("null");
+		REQUIRE(propsLazy.GetExpandedString("keywords.after") == "and def");
+		// Not read until html is used
+		REQUIRE(propsLazy.Get("keywordclass.vb").empty());
+		REQUIRE(propsLazy.Get("keywordclass.basic").empty());
+		propsLazy.ReadLanguage("hypertext");
+		for (const char *keyBase : { "keywords.", "keywords3.", "keywords4." }) {
+			for (const char *fileName : { "a.html", "a.php" }) {
+				REQUIRE(propsLazy.GetNewExpandString(keyBase, fileName) ==
+					propsEager.GetNewExpandString(keyBase, fileName));
+			}
+		}
+		REQUIRE(propsLazy.GetNewExpandString("keywords3.", "a.html") == "dim goto gosub");
+		REQUIRE(propsLazy.GetNewExpandString("keywords4.", "a.php") == "and def");
+	}
+
+}
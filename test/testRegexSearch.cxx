@@ -0,0 +1,179 @@
+/** @file testRegexSearch.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <bitset>
+#include <map>
+#include <memory>
+
+#include "SubstringSearch.h"
+#include "RegexSearch.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+// Return whether text, treated as a single line, matches pattern.
+bool Matches(std::string_view pattern, std::string_view text, bool matchCase=true, bool wholeWord=false, bool posix=false) {
+	const RegexProgram program(pattern, matchCase, wholeWord, posix);
+	REQUIRE(program.IsValid());
+	RegexSearch search(program);
+	return search.Find(text) != npos;
+}
+
+std::string Error(std::string_view pattern, bool posix=false) {
+	const RegexProgram program(pattern, true, false, posix);
+	return program.error;
+}
+
+}
+
+TEST_CASE("RegexProgram") {
+
+	SECTION("Errors") {
+		REQUIRE(Error("abc").empty());
+		REQUIRE(Error("[abc") == "Missing ]");
+		REQUIRE(Error("\\(abc") == "Unmatched (");
+		REQUIRE(Error("abc\\)") == "Unmatched )");
+		REQUIRE(Error("(abc", true) == "Unmatched (");
+		REQUIRE(Error("\\(a\\)\\1") == "Back references are not supported");
+		REQUIRE(Error("^*") == "Illegal closure");
+		REQUIRE(Error("[z-a]") == "Bad range in []");
+	}
+
+	SECTION("Literal") {
+		REQUIRE(RegexProgram("abc", true, false, false).literal == "abc");
+		REQUIRE(RegexProgram("x*abcd.ef", true, false, false).literal == "abcd");
+		REQUIRE(RegexProgram("AbC", false, false, false).literal == "abc");
+		REQUIRE(RegexProgram("[Aa]bc", true, false, false).literal == "bc");
+		REQUIRE(RegexProgram("a|b", true, false, true).literal.empty());
+		REQUIRE(RegexProgram("a\\nb", true, false, false).literal == "a");
+	}
+}
+
+TEST_CASE("RegexSearch") {
+
+	SECTION("Basic") {
+		REQUIRE(Matches("abc", "xxabcxx"));
+		REQUIRE(!Matches("abc", "xxabxcx"));
+		REQUIRE(Matches("a.c", "abc"));
+		REQUIRE(Matches("ab*c", "ac"));
+		REQUIRE(Matches("ab*c", "abbbc"));
+		REQUIRE(!Matches("ab+c", "ac"));
+		REQUIRE(Matches("ab?c", "abc"));
+		REQUIRE(!Matches("ab?c", "abbc"));
+		REQUIRE(Matches("*a", "x*a"));
+		REQUIRE(Matches("a^b$c", "a^b$c"));
+		REQUIRE(Matches("", "abc"));
+	}
+
+	SECTION("Sets") {
+		REQUIRE(Matches("[a-c]x", "bx"));
+		REQUIRE(!Matches("[a-c]x", "dx"));
+		REQUIRE(Matches("[^a-c]x", "dx"));
+		REQUIRE(Matches("[]]", "]"));
+		REQUIRE(Matches("[a-]", "-"));
+		REQUIRE(Matches("[\\d]+z", "12z"));
+		REQUIRE(Matches("\\d\\s\\w", "1 _"));
+		REQUIRE(!Matches("\\D", "123"));
+		REQUIRE(Matches("\\x41", "A"));
+		REQUIRE(Matches("\\t", "a\tb"));
+	}
+
+	SECTION("Anchors") {
+		REQUIRE(Matches("^abc", "abcd"));
+		REQUIRE(!Matches("^abc", "xabc"));
+		REQUIRE(Matches("abc$", "xabc"));
+		REQUIRE(!Matches("abc$", "abcx"));
+		REQUIRE(Matches("^$", "\n"));
+		REQUIRE(Matches("\\<abc\\>", "x abc y"));
+		REQUIRE(!Matches("\\<abc", "xabc"));
+		REQUIRE(!Matches("abc\\>", "abcx"));
+	}
+
+	SECTION("WordCharacters") {
+		// Like a document where '-' and bytes from 0x80 are word characters
+		std::string wordCharacters = "abcxyz-";
+		for (int ch = 0x80; ch < 0x100; ch++) {
+			wordCharacters.push_back(static_cast<char>(ch));
+		}
+		const auto FindWords = [&wordCharacters](std::string_view pattern, std::string_view text) {
+			const RegexProgram program(pattern, true, false, false, wordCharacters);
+			REQUIRE(program.IsValid());
+			RegexSearch search(program);
+			return search.Find(text) != npos;
+		};
+		REQUIRE(FindWords("\\<abc\\>", "x-abc y") == false);
+		REQUIRE(FindWords("\\<abc\\>", "x_abc y") == true);
+		REQUIRE(FindWords("abc\\>", "abc\xC3\xA9") == false);
+		REQUIRE(FindWords("a\\wc", "a\xC3" "c") == true);
+		REQUIRE(FindWords("a\\wc", "a_c") == false);
+		REQUIRE(FindWords("a\\Wc", "a_c") == true);
+		// Default is ASCII letters, digits and '_'
+		REQUIRE(Matches("\\<abc\\>", "x-abc y"));
+		REQUIRE(Matches("a\\wc", "a_c"));
+	}
+
+	SECTION("Groups") {
+		REQUIRE(Matches("a\\(bc\\)*d", "abcbcd"));
+		REQUIRE(Matches("a(bc)*d", "abcbcd", true, false, true));
+		REQUIRE(Matches("a(bc)d", "a(bc)d"));
+		REQUIRE(Matches("a\\(bc\\)d", "a(bc)d", true, false, true));
+		REQUIRE(Matches("cat\\|dog", "hotdog"));
+		REQUIRE(Matches("^(cat|dog)$", "dog", true, false, true));
+		REQUIRE(!Matches("^(cat|dog)$", "dogs", true, false, true));
+	}
+
+	SECTION("Options") {
+		REQUIRE(Matches("AbC", "xabcx", false));
+		REQUIRE(!Matches("AbC", "xabcx", true));
+		REQUIRE(Matches("[a-c]", "B", false));
+		REQUIRE(!Matches("[^a-c]", "B", false));
+		REQUIRE(Matches("ab", "x ab y", true, true));
+		REQUIRE(!Matches("ab", "x abc y", true, true));
+		REQUIRE(Matches("a.", "ab a_ ac", true, true));
+	}
+
+	SECTION("Lines") {
+		const RegexProgram program("^b+$", true, false, false);
+		RegexSearch search(program);
+		const std::string_view text = "abc\nbb\r\n\r\nbbb\rbx\nb";
+		size_t position = search.Find(text);
+		REQUIRE(position >= 4);
+		REQUIRE(position <= 6);
+		position = search.Find(text, 8);
+		REQUIRE(position >= 10);
+		REQUIRE(position <= 13);
+		// Last line has no line end
+		REQUIRE(search.Find(text, 17) == 17);
+		REQUIRE(search.Find(text.substr(0, 17), 14) == npos);
+	}
+
+	SECTION("EmptyLines") {
+		// "\r\n" is a single line end so does not contain an empty line
+		const RegexProgram program("^$", true, false, false);
+		RegexSearch search(program);
+		REQUIRE(search.Find("a\r\nb\r\n") == npos);
+		REQUIRE(search.Find("a\r\rb") == 2);
+		REQUIRE(search.Find("a\n\nb") == 2);
+	}
+
+	SECTION("Prefilter") {
+		// Literal "xyz" found on the line after a line that only matches the prefix
+		const RegexProgram program("a+xyz", true, false, false);
+		RegexSearch search(program);
+		const size_t position = search.Find("bxyz\naaxyz\n");
+		REQUIRE(position >= 5);
+		REQUIRE(position <= 10);
+		REQUIRE(search.Find("bxyz\nxyz\n") == npos);
+	}
+}
@@ -0,0 +1,481 @@
+/** @file testStringList.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "GUI.h"
+#include "StringHelpers.h"
+
+#include "FilePath.h"
+#include "StringList.h"
+
+#include "TemporaryFile.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+const std::string apiText =
+	"printf(const char *format, ...)\n"
+	"puts(const char *s)\n"
+	"putchar(int c)\n"
+	"Print(text)\n"
+	"strlen(const char *s)\n"
+	"strcmp(const char *s1, const char *s2)\n"
+	"strncmp(const char *s1, const char *s2, size_t n)\n";
+
+constexpr std::string_view apiKey = "api.txt 100";
+
+// Save apiText into file then wait for the background thread by destroying the list.
+void SaveIndex(const TemporaryFile &indexFile, bool onlyLineEnds) {
+	StringList list(onlyLineEnds);
+	list.Set(apiText.c_str());
+	list.IndexInBackground(indexFile.File(), apiKey);
+}
+
+// Every kind of search over the whole list so damage that passed Load is read.
+void SearchAll(StringList &list) {
+	for (const bool ignoreCase : {false, true}) {
+		list.GetNearestWords("", 0, ignoreCase);
+		list.GetNearestWords("", 0, ignoreCase, '(', true);
+		list.GetNearestWords("put", 3, ignoreCase);
+		list.GetNearestWord("str", 3, ignoreCase, "abcdefghijklmnopqrstuvwxyz", 1);
+	}
+	list.GetFuzzyWords("sc", 2, '(', 10);
+}
+
+// The original searches over pointers to words, sorted when first needed, kept to check
+// that the sorted offsets, stored lengths and index files give the same results.
+class ReferenceList {
+	std::string text;
+	std::vector<char *> words;
+	std::vector<char *> wordsNoCase;
+
+	static int CompareNCaseInsensitive(const char *a, const char *b, size_t len) noexcept {
+		while (*a && *b && len) {
+			if (*a != *b) {
+				const char upperA = MakeUpperCase(*a);
+				const char upperB = MakeUpperCase(*b);
+				if (upperA != upperB)
+					return upperA - upperB;
+			}
+			a++;
+			b++;
+			len--;
+		}
+		if (len == 0)
+			return 0;
+		return *a - *b;
+	}
+
+	static size_t LengthWord(const char *word, char otherSeparator) noexcept {
+		const char *endWord = nullptr;
+		if (otherSeparator)
+			endWord = strchr(word, otherSeparator);
+		if (!endWord)
+			endWord = strchr(word, '(');
+		if (!endWord)
+			endWord = word + strlen(word);
+		if (endWord > word) {
+			endWord--;
+			while ((endWord > word) && (IsASpace(*endWord))) {
+				endWord--;
+			}
+		}
+		return endWord - word + 1;
+	}
+
+	struct CompareString {
+		size_t searchLen;
+		bool operator()(const char *a, const char *b) const noexcept {
+			return strncmp(a, b, searchLen) < 0;
+		}
+	};
+
+	struct CompareStringInsensitive {
+		size_t searchLen;
+		bool operator()(const char *a, const char *b) const noexcept {
+			return CompareNCaseInsensitive(a, b, searchLen) < 0;
+		}
+	};
+
+	// The original continued past the matching words when wordIndex was beyond them,
+	// returning words without the prefix, so this stops at the last match.
+	template<typename Compare>
+	static std::string GetMatch(const std::vector<char *> &sorted, const char *wordStart,
+		const std::string &wordCharacters, ptrdiff_t wordIndex, Compare comp) {
+		for (auto elem = std::lower_bound(sorted.begin(), sorted.end(), wordStart, comp);
+			(elem < sorted.end()) && !comp(wordStart, *elem) && !comp(*elem, wordStart); ++elem) {
+			const char *word = *elem;
+			if (!word[comp.searchLen] || !Contains(wordCharacters, word[comp.searchLen])) {
+				if (wordIndex <= 0) {
+					return std::string(word);
+				}
+				wordIndex--;
+			}
+		}
+		return std::string();
+	}
+
+	template<typename Compare>
+	static std::string GetMatches(const std::vector<char *> &sorted, const char *wordStart,
+		char otherSeparator, bool exactLen, Compare comp) {
+		std::string wordList;
+		const size_t wordStartLength = LengthWord(wordStart, otherSeparator);
+		for (auto elem = std::lower_bound(sorted.begin(), sorted.end(), wordStart, comp); elem < sorted.end(); ++elem) {
+			if (comp(wordStart, *elem) || comp(*elem, wordStart))
+				break;
+			const size_t wordlen = LengthWord(*elem, otherSeparator);
+			if (!exactLen || (wordlen == wordStartLength)) {
+				if (wordList.length() > 0)
+					wordList.append(" ", 1);
+				wordList.append(*elem, wordlen);
+			}
+		}
+		return wordList;
+	}
+
+public:
+	ReferenceList(std::string_view list, bool onlyLineEnds) : text(list) {
+		bool wordSeparator[256] = {};
+		wordSeparator[static_cast<unsigned int>('\r')] = true;
+		wordSeparator[static_cast<unsigned int>('\n')] = true;
+		if (!onlyLineEnds) {
+			wordSeparator[static_cast<unsigned int>(' ')] = true;
+			wordSeparator[static_cast<unsigned int>('\t')] = true;
+		}
+		bool prevSeparator = true;
+		for (char &ch : text) {
+			const bool separator = wordSeparator[static_cast<unsigned char>(ch)];
+			if (separator) {
+				ch = '\0';
+			} else if (prevSeparator) {
+				words.push_back(&ch);
+			}
+			prevSeparator = separator;
+		}
+		wordsNoCase = words;
+		std::sort(words.begin(), words.end(), [](const char *a, const char *b) noexcept {
+			return strcmp(a, b) < 0;
+		});
+		std::sort(wordsNoCase.begin(), wordsNoCase.end(), [](const char *a, const char *b) noexcept {
+			return CompareNoCase(a, b) < 0;
+		});
+	}
+	const std::vector<char *> &Words() const noexcept {
+		return words;
+	}
+	std::string GetNearestWord(const char *wordStart, size_t searchLen, bool ignoreCase,
+		const std::string &wordCharacters, ptrdiff_t wordIndex) const {
+		if (ignoreCase) {
+			return GetMatch(wordsNoCase, wordStart, wordCharacters, wordIndex, CompareStringInsensitive{searchLen});
+		}
+		return GetMatch(words, wordStart, wordCharacters, wordIndex, CompareString{searchLen});
+	}
+	std::string GetNearestWords(const char *wordStart, size_t searchLen, bool ignoreCase,
+		char otherSeparator, bool exactLen) const {
+		if (ignoreCase) {
+			return GetMatches(wordsNoCase, wordStart, otherSeparator, exactLen, CompareStringInsensitive{searchLen});
+		}
+		return GetMatches(words, wordStart, otherSeparator, exactLen, CompareString{searchLen});
+	}
+};
+
+// API lines with overloads, case variants, spaces before '(', other separators, non-ASCII
+// and identifiers too long for their length to be stored.
+std::string NearestText() {
+	std::string text =
+		"abs\nAbs\nABS\nabsolute\nabs_value\nabs(int)\nabs (double)\nabs(long)\nAbsolute(x)\n"
+		"acos(x)\na.b.c\na.b\nab.cd(e)\nZed\nzed\n_under\nx1\nx10\nx2\n\xC3\xA9lan(\xC3\xA9)\n"
+		"get value(key)\nget\tindex\n";
+	text += std::string(70000, 'L') + "ong(x)\n";
+	text += std::string(70000, 'l') + ".member\n";
+	text += std::string(65535, 'm') + "\n";
+	text += std::string(65534, 'm') + "(n)\n";
+	return text;
+}
+
+// Compare prefixes of each word, in its own and the opposite case, with the original.
+void CompareNearest(StringList &list, const ReferenceList &reference) {
+	const std::string wordCharacters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+	for (const char *wordReference : reference.Words()) {
+		std::string word = wordReference;
+		std::string flipped = word;
+		for (char &ch : flipped) {
+			ch = IsUpperCase(ch) ? MakeLowerCase(ch) : MakeUpperCase(ch);
+		}
+		const size_t lengths[] = { 0, 1, 2, 3, word.length() / 2, word.length() - 1, word.length() };
+		for (const std::string &wordStart : { word, flipped }) {
+			for (const size_t searchLen : lengths) {
+				if (searchLen > wordStart.length()) {
+					continue;
+				}
+				for (const bool ignoreCase : { false, true }) {
+					for (const char otherSeparator : { '\0', '(', '.', ' ' }) {
+						for (const bool exactLen : { false, true }) {
+							REQUIRE(list.GetNearestWords(wordStart.c_str(), searchLen, ignoreCase, otherSeparator, exactLen) ==
+								reference.GetNearestWords(wordStart.c_str(), searchLen, ignoreCase, otherSeparator, exactLen));
+						}
+					}
+					for (ptrdiff_t wordIndex = 0; wordIndex < 4; wordIndex++) {
+						REQUIRE(list.GetNearestWord(wordStart.c_str(), searchLen, ignoreCase, wordCharacters, wordIndex) ==
+							reference.GetNearestWord(wordStart.c_str(), searchLen, ignoreCase, wordCharacters, wordIndex));
+					}
+				}
+			}
+		}
+	}
+}
+
+// Identifiers for fuzzy matching with camelCase, '_' and '.' boundaries, digits,
+// non-ASCII and overloads.
+const std::string fuzzyText =
+	"getNextWord(int)\ngnaw\nget_next_word\nGetNextWord()\nsignwave\nnew_window\nwindow.open\n"
+	"x86_64\nitem2\nitem10\n_private\n\xC3\xA9t\xC3\xA9(x)\nabs(int)\nabs(long)\nabs (double)\nabsolute\n";
+
+std::vector<std::string> Split(std::string_view words) {
+	std::vector<std::string> result;
+	while (!words.empty()) {
+		const size_t space = words.find(' ');
+		result.emplace_back(words.substr(0, space));
+		words.remove_prefix(std::min(space, words.length() - 1) + 1);
+	}
+	return result;
+}
+
+}
+
+TEST_CASE("StringList") {
+
+	SECTION("SaveLoad") {
+		const TemporaryFile indexFile("SciTEUnitTestApi.index");
+		SaveIndex(indexFile, true);
+		// The index was written beside then moved into place
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		REQUIRE(!std::filesystem::exists(directory / ".SciTEUnitTestApi.index.saving"));
+
+		StringList fresh(true);
+		fresh.Set(apiText.c_str());
+		StringList loaded(true);
+		REQUIRE(loaded.Load(indexFile.File(), apiKey));
+		REQUIRE(loaded.Length() == 7);
+		REQUIRE(loaded.Length() == fresh.Length());
+		for (const bool ignoreCase : {false, true}) {
+			REQUIRE(loaded.GetNearestWords("", 0, ignoreCase, '(') == fresh.GetNearestWords("", 0, ignoreCase, '('));
+			REQUIRE(loaded.GetNearestWords("put", 3, ignoreCase) == fresh.GetNearestWords("put", 3, ignoreCase));
+		}
+		REQUIRE(loaded.GetNearestWords("pr", 2, false, '(') == "printf");
+		REQUIRE(loaded.GetNearestWords("pr", 2, true, '(') == "Print printf");
+		REQUIRE(loaded.GetNearestWord("strn", 4, false, "", 0) == "strncmp(const char *s1, const char *s2, size_t n)");
+		REQUIRE(loaded.GetFuzzyWords("sc", 2, '(', 10) == fresh.GetFuzzyWords("sc", 2, '(', 10));
+
+		// Setting a loaded list stops using the index file
+		loaded.Set("alpha\nbeta");
+		REQUIRE(loaded.Length() == 2);
+		REQUIRE(loaded.GetNearestWords("b", 1, false) == "beta");
+	}
+
+	SECTION("NearestWords") {
+		for (const bool onlyLineEnds : { true, false }) {
+			const std::string text = NearestText();
+			StringList list(onlyLineEnds);
+			list.Set(text.c_str());
+			const ReferenceList reference(text, onlyLineEnds);
+			REQUIRE(list.Length() == reference.Words().size());
+			CompareNearest(list, reference);
+		}
+
+		StringList list(true);
+		list.Set(NearestText().c_str());
+		REQUIRE(list.GetNearestWords("abs", 3, false) == "abs abs abs abs abs_value absolute");
+		REQUIRE(list.GetNearestWords("abs", 3, false, '\0', true) == "abs abs abs abs");
+		// Each case of "abs" and its overloads, with equal words in no particular order
+		REQUIRE(list.GetNearestWords("ABS", 3, true, '\0', true).length() == 6 * 4 - 1);
+		REQUIRE(list.GetNearestWords("a.b", 3, false, '.') == "a a");
+		REQUIRE(list.GetNearestWords("get", 3, false) == "get\tindex get value");
+		REQUIRE(list.GetNearestWord("abs", 3, false, "_abcdefghijklmnopqrstuvwxyz", 1) == "abs (double)");
+		REQUIRE(list.GetNearestWord("abs", 3, false, "_abcdefghijklmnopqrstuvwxyz", 3) == "abs(long)");
+		// Beyond the matching words
+		REQUIRE(list.GetNearestWord("abs", 3, false, "_abcdefghijklmnopqrstuvwxyz", 4).empty());
+		REQUIRE(list.GetNearestWords("q", 1, true).empty());
+		// Identifiers longer than a stored length are measured again
+		REQUIRE(list.GetNearestWords("LLL", 3, false) == std::string(70000, 'L') + "ong");
+		REQUIRE(list.GetNearestWords("mmm", 3, false) == std::string(65534, 'm') + " " + std::string(65535, 'm'));
+	}
+
+	SECTION("NearestWordsLoaded") {
+		const TemporaryFile indexFile("SciTEUnitTestApi.index");
+		const std::string text = NearestText();
+		{
+			StringList list(true);
+			list.Set(text.c_str());
+			list.IndexInBackground(indexFile.File(), apiKey);
+		}
+		StringList loaded(true);
+		REQUIRE(loaded.Load(indexFile.File(), apiKey));
+		CompareNearest(loaded, ReferenceList(text, true));
+	}
+
+	SECTION("FuzzyMatches") {
+		REQUIRE(FuzzyMatches("gnw", "getNextWord"));
+		REQUIRE(FuzzyMatches("GNW", "gnaw"));
+		REQUIRE(FuzzyMatches("", "gnaw"));
+		REQUIRE(FuzzyMatches("\xC3\xA9", "\xC3\xA9t\xC3\xA9"));
+		// In order
+		REQUIRE(!FuzzyMatches("wng", "getNextWord"));
+		// Each character of the word matches only once
+		REQUIRE(!FuzzyMatches("gg", "getNextWord"));
+		REQUIRE(!FuzzyMatches("x", ""));
+		REQUIRE(!FuzzyMatches("_", "getNextWord"));
+	}
+
+	SECTION("FuzzyWords") {
+		StringList list(true);
+		list.Set(fuzzyText.c_str());
+		// Boundaries of camelCase and '_' words rank above the same characters elsewhere
+		// then shorter words are preferred
+		REQUIRE(list.GetFuzzyWords("gnw", 3, '(', 10) == "getNextWord GetNextWord get_next_word gnaw signwave");
+		// Boundaries are preferred over the first occurrence of each character
+		REQUIRE(list.GetFuzzyWords("nw", 2, '(', 10) == "new_window GetNextWord getNextWord get_next_word signwave gnaw window.open");
+		// Equal scores and lengths are in sorted order
+		REQUIRE(list.GetFuzzyWords("wo", 2, '.', 2) == "window GetNextWord");
+		// Overloads are listed once
+		REQUIRE(list.GetFuzzyWords("abs", 3, '(', 10) == "abs absolute");
+		REQUIRE(list.GetFuzzyWords("abs", 3, '\0', 10) == "abs absolute");
+		REQUIRE(list.GetFuzzyWords("i1", 2, '(', 10) == "item10");
+		REQUIRE(list.GetFuzzyWords("zz", 2, '(', 10).empty());
+		REQUIRE(list.GetFuzzyWords("gnw", 3, '(', 0).empty());
+	}
+
+	SECTION("FuzzyMaximum") {
+		StringList list(true);
+		list.Set(fuzzyText.c_str());
+		for (const std::string_view pattern : { "gnw"sv, "w"sv, "e"sv, "i"sv, ""sv }) {
+			const std::vector<std::string> all = Split(list.GetFuzzyWords(pattern.data(), pattern.length(), '(', SIZE_MAX));
+			for (size_t maximum = 1; maximum <= all.size() + 1; maximum++) {
+				// The best maximum of all the matches in the same order
+				const std::vector<std::string> best = Split(list.GetFuzzyWords(pattern.data(), pattern.length(), '(', maximum));
+				REQUIRE(best.size() == std::min(maximum, all.size()));
+				REQUIRE(std::equal(best.begin(), best.end(), all.begin()));
+			}
+		}
+		REQUIRE(list.GetFuzzyWords("gnw", 3, '(', 2) == "getNextWord GetNextWord");
+	}
+
+	SECTION("FuzzyMask") {
+		// The character masks must not reject any word that matches so the result is
+		// every distinct word for which FuzzyMatches is true.
+		StringList list(true);
+		list.Set(fuzzyText.c_str());
+		const std::vector<std::string> identifiers = Split(list.GetNearestWords("", 0, false, '('));
+		const std::string_view alphabet = "aAgGnNwWxX_08.\xC3\xA9-";
+		std::vector<std::string> patterns;
+		for (const char first : alphabet) {
+			patterns.emplace_back(1, first);
+			for (const char second : alphabet) {
+				patterns.push_back({ first, second });
+			}
+		}
+		for (const std::string &pattern : patterns) {
+			std::set<std::string> expected;
+			for (const std::string &identifier : identifiers) {
+				if (FuzzyMatches(pattern, identifier)) {
+					expected.insert(identifier);
+				}
+			}
+			const std::vector<std::string> found = Split(list.GetFuzzyWords(pattern.c_str(), pattern.length(), '(', SIZE_MAX));
+			REQUIRE(std::set<std::string>(found.begin(), found.end()) == expected);
+			REQUIRE(found.size() == expected.size());
+		}
+	}
+
+	SECTION("Mismatch") {
+		const TemporaryFile indexFile("SciTEUnitTestApi.index");
+		SaveIndex(indexFile, true);
+		StringList list(true);
+		REQUIRE(!list.Load(indexFile.File(), "api.txt 101"));
+		REQUIRE(!list.Load(indexFile.File(), "api.txt 10"));
+		REQUIRE(!list.Load(indexFile.File(), ""));
+		REQUIRE(!list);
+		// Split into words differently
+		StringList words(false);
+		REQUIRE(!words.Load(indexFile.File(), apiKey));
+		// A failed load leaves the list unchanged
+		list.Set("one two");
+		REQUIRE(!list.Load(TemporaryFile("SciTEUnitTestMissing.index").File(), apiKey));
+		REQUIRE(list.Length() == 1);
+		REQUIRE(list.GetNearestWords("o", 1, false) == "one two");
+	}
+
+	SECTION("Truncated") {
+		const TemporaryFile indexFile("SciTEUnitTestApi.index");
+		SaveIndex(indexFile, true);
+		const std::string saved = indexFile.Contents();
+		REQUIRE(StringList(true).Load(indexFile.File(), apiKey));
+		for (size_t length = 0; length < saved.length(); length++) {
+			indexFile.Write(std::string_view(saved).substr(0, length));
+			StringList list(true);
+			REQUIRE(!list.Load(indexFile.File(), apiKey));
+		}
+		// Trailing data
+		indexFile.Write(saved + "x");
+		REQUIRE(!StringList(true).Load(indexFile.File(), apiKey));
+	}
+
+	SECTION("Corrupted") {
+		const TemporaryFile indexFile("SciTEUnitTestApi.index");
+		SaveIndex(indexFile, false);
+		const std::string saved = indexFile.Contents();
+		// Damage each byte in turn. Loading may succeed when only the order or text of
+		// words changes but searching must then stay inside the file.
+		size_t loaded = 0;
+		for (size_t position = 0; position < saved.length(); position++) {
+			for (const char damage : {'\0', '\x7f', '\xff'}) {
+				if (saved[position] == damage) {
+					continue;
+				}
+				std::string corrupted = saved;
+				corrupted[position] = damage;
+				indexFile.Write(corrupted);
+				StringList list(false);
+				if (list.Load(indexFile.File(), apiKey)) {
+					loaded++;
+					SearchAll(list);
+				}
+			}
+		}
+		REQUIRE(loaded > 0);
+
+		// A count too large for the file
+		std::string manyWords = saved;
+		manyWords[18] = '\x7f';
+		indexFile.Write(manyWords);
+		REQUIRE(!StringList(false).Load(indexFile.File(), apiKey));
+
+		// Text not terminated
+		std::string unterminated = saved;
+		unterminated.back() = 'x';
+		indexFile.Write(unterminated);
+		REQUIRE(!StringList(false).Load(indexFile.File(), apiKey));
+
+		// Garbage
+		indexFile.Write("not an index of an API file");
+		REQUIRE(!StringList(false).Load(indexFile.File(), apiKey));
+	}
+}
@@ -0,0 +1,135 @@
+/** @file testSubstringSearch.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+#include <cstring>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+#include "SubstringSearch.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+std::string LowerAZ(std::string s) {
+	for (char &ch : s) {
+		if (ch >= 'A' && ch <= 'Z') {
+			ch = static_cast<char>(ch - 'A' + 'a');
+		}
+	}
+	return s;
+}
+
+}
+
+TEST_CASE("SubstringSearch") {
+
+	SECTION("Literal") {
+		const SubstringSearch ss("abc", true);
+		REQUIRE(ss.Length() == 3);
+		REQUIRE(ss.Find("abc") == 0);
+		REQUIRE(ss.Find("xabc") == 1);
+		REQUIRE(ss.Find("ab") == std::string_view::npos);
+		REQUIRE(ss.Find("") == std::string_view::npos);
+		REQUIRE(ss.Find("ABC") == std::string_view::npos);
+		REQUIRE(ss.Find("abcabc", 1) == 3);
+		REQUIRE(ss.Find("abcabc", 4) == std::string_view::npos);
+	}
+
+	SECTION("IgnoreCase") {
+		const SubstringSearch ss("aBc", false);
+		REQUIRE(ss.Find("ABC") == 0);
+		REQUIRE(ss.Find("--abc") == 2);
+		// Only ASCII letters are folded: '@' and '[' surround 'A'..'Z'
+		const SubstringSearch brackets("@a[", false);
+		REQUIRE(brackets.Find("@A[") == 0);
+		REQUIRE(brackets.Find("`a{") == std::string_view::npos);
+		const SubstringSearch high("\xC0", false);
+		REQUIRE(high.Find("\xE0") == std::string_view::npos);
+	}
+
+	SECTION("Lengths") {
+		const SubstringSearch one("z", true);
+		REQUIRE(one.Find(std::string(40, 'a') + "z") == 40);
+		const SubstringSearch empty("", true);
+		REQUIRE(empty.Find("abc", 2) == 2);
+	}
+
+	SECTION("BlockBoundaries") {
+		// Place needle at each position of texts around the vector widths
+		for (const std::string_view needle : {"q"sv, "qr"sv, "qrs"sv, "qrstuvwxyz0123456789ABCDEFGH"sv}) {
+			for (size_t length = needle.length(); length < 100; length++) {
+				for (size_t position = 0; position + needle.length() <= length; position++) {
+					std::string text(length, '.');
+					text.replace(position, needle.length(), needle);
+					const SubstringSearch ssCase(needle, true);
+					REQUIRE(ssCase.Find(text) == position);
+					const SubstringSearch ssNoCase(needle, false);
+					REQUIRE(ssNoCase.Find(text) == position);
+				}
+			}
+		}
+	}
+
+	SECTION("Random") {
+		// Compare with std::string::find on text with many partial matches
+		unsigned int seed = 1;
+		auto next = [&seed]() {
+			seed = seed * 1103515245 + 12345;
+			return (seed >> 16) & 0x7fff;
+		};
+		constexpr std::string_view alphabet = "abAB\r\n";
+		std::string text;
+		for (int i = 0; i < 5000; i++) {
+			text.push_back(alphabet[next() % alphabet.length()]);
+		}
+		const std::string lowered = LowerAZ(text);
+		for (int trial = 0; trial < 200; trial++) {
+			std::string needle;
+			const size_t length = 1 + next() % 6;
+			for (size_t i = 0; i < length; i++) {
+				needle.push_back(alphabet[next() % 4]);
+			}
+			const SubstringSearch ssCase(needle, true);
+			const SubstringSearch ssNoCase(needle, false);
+			const std::string needleLowered = LowerAZ(needle);
+			for (size_t start = 0; start < text.length(); start += 97) {
+				REQUIRE(ssCase.Find(text, start) == text.find(needle, start));
+				REQUIRE(ssNoCase.Find(text, start) == lowered.find(needleLowered, start));
+			}
+		}
+	}
+}
+
+TEST_CASE("CountLineEnds") {
+
+	SECTION("Simple") {
+		REQUIRE(CountLineEnds("") == 0);
+		REQUIRE(CountLineEnds("a") == 0);
+		REQUIRE(CountLineEnds("a\n") == 1);
+		REQUIRE(CountLineEnds("a\r\nb\rc\n") == 3);
+		REQUIRE(CountLineEnds("\r") == 1);
+		REQUIRE(CountLineEnds("\n\r") == 2);
+		REQUIRE(CountLineEnds("\r\r\n") == 2);
+	}
+
+	SECTION("Long") {
+		std::string text;
+		for (int i = 0; i < 100; i++) {
+			text += "abcdefghijklm\r\n";
+			text += "nopqrstuvwxyz\n";
+			text += "x\r";
+		}
+		REQUIRE(CountLineEnds(text) == 300);
+		// "\r\n" split at the end of the text counts as a line end
+		REQUIRE(CountLineEnds(std::string_view(text).substr(0, 14)) == 1);
+		REQUIRE(CountLineEnds(std::string_view(text).substr(0, 15)) == 1);
+	}
+}
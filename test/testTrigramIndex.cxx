@@ -0,0 +1,196 @@
+/** @file testTrigramIndex.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "GUI.h"
+
+#include "FilePath.h"
+#include "TrigramIndex.h"
+
+#include "TemporaryFile.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+TrigramIndex::Entry EntryOf(std::string_view text, long long modified) {
+	TrigramIndex::Entry entry;
+	entry.modified = modified;
+	entry.length = text.length();
+	entry.filter = TrigramIndex::FilterOf(TrigramsOf(text));
+	return entry;
+}
+
+}
+
+TEST_CASE("TrigramIndex") {
+
+	SECTION("TrigramsOf") {
+		REQUIRE(TrigramsOf("ab").empty());
+		const std::vector<Trigram> abc = TrigramsOf("abc");
+		REQUIRE(abc == std::vector<Trigram>{0x616263});
+		// ASCII letters are folded so both case modes use the same trigrams
+		REQUIRE(TrigramsOf("ABC") == abc);
+		REQUIRE(TrigramsOf("a1C") == std::vector<Trigram>{0x613163});
+		// Sorted without duplicates
+		REQUIRE(TrigramsOf("abcabc") == std::vector<Trigram>{0x616263, 0x626361, 0x636162});
+		// Trigrams do not span line ends
+		REQUIRE(TrigramsOf("ab\ncd\r\nef").empty());
+		REQUIRE(TrigramsOf("xyz\nabc") == std::vector<Trigram>{0x616263, 0x78797a});
+	}
+
+	SECTION("TrigramCollector") {
+		TrigramCollector collector;
+		collector.Add("one two\n");
+		collector.Add("two three\n");
+		REQUIRE(!collector.Overflowed());
+		REQUIRE(collector.Finish() == TrigramsOf("one two\ntwo three\n"));
+	}
+
+	SECTION("FilterOf") {
+		// At least 64 bits, growing in powers of 2 then limited to 64K bits
+		REQUIRE(TrigramIndex::FilterOf({}).size() == 8);
+		REQUIRE(TrigramIndex::FilterOf(TrigramsOf("abcdefghij")).size() == 8);
+		std::vector<Trigram> many;
+		for (Trigram trigram = 0; trigram < 100; trigram++) {
+			many.push_back(trigram);
+		}
+		REQUIRE(TrigramIndex::FilterOf(many).size() == 512 / 8);
+		for (Trigram trigram = 100; trigram < 100000; trigram++) {
+			many.push_back(trigram);
+		}
+		REQUIRE(TrigramIndex::FilterOf(many).size() == 64 * 1024 / 8);
+	}
+
+	SECTION("MayContain") {
+		const std::string_view text = "The quick brown fox\njumps over the lazy dog\n";
+		const TrigramIndex::Entry entry = EntryOf(text, 1);
+		// No false negatives for any text of the file in either case
+		REQUIRE(TrigramIndex::MayContain(entry, TrigramsOf("quick")));
+		REQUIRE(TrigramIndex::MayContain(entry, TrigramsOf("LAZY DOG")));
+		REQUIRE(TrigramIndex::MayContain(entry, TrigramsOf(text)));
+		// Queries shorter than a trigram can not be excluded
+		REQUIRE(TrigramIndex::MayContain(entry, TrigramsOf("zq")));
+		// Some absent text is excluded although any one query may be a false positive
+		size_t excluded = 0;
+		for (const std::string_view absent : {"xylophone", "zebra", "qwerty", "vortex", "mnemonic"}) {
+			if (!TrigramIndex::MayContain(entry, TrigramsOf(absent))) {
+				excluded++;
+			}
+		}
+		REQUIRE(excluded > 0);
+		// Files without a valid filter must always be read
+		TrigramIndex::Entry unknown;
+		REQUIRE(TrigramIndex::MayContain(unknown, TrigramsOf("xylophone")));
+		unknown.filter.resize(3);
+		REQUIRE(TrigramIndex::MayContain(unknown, TrigramsOf("xylophone")));
+	}
+
+	SECTION("SaveLoad") {
+		const TemporaryFile indexFile("SciTEUnitTestTrigrams.index");
+		{
+			TrigramIndex index(indexFile.File());
+			REQUIRE(!index.Find("a.txt", 1, 0));
+			index.Update("a.txt", EntryOf("alpha beta", 100));
+			TrigramIndex::Entry binary = EntryOf("", 200);
+			binary.flags = TrigramIndex::flagBinary;
+			binary.filter.clear();
+			index.Update("dir/b.bin", std::move(binary));
+			REQUIRE(index.Save());
+		}
+		// The index was written beside then moved into place
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		REQUIRE(!std::filesystem::exists(directory / ".SciTEUnitTestTrigrams.index.saving"));
+
+		const TrigramIndex index(indexFile.File());
+		const TrigramIndex::Entry *entryA = index.Find("a.txt", 100, 10);
+		REQUIRE(entryA);
+		REQUIRE(entryA->filter == EntryOf("alpha beta", 100).filter);
+		REQUIRE(entryA->flags == 0);
+		REQUIRE(TrigramIndex::MayContain(*entryA, TrigramsOf("beta")));
+		// Changed time or length is a different file
+		REQUIRE(!index.Find("a.txt", 101, 10));
+		REQUIRE(!index.Find("a.txt", 100, 11));
+		const TrigramIndex::Entry *entryB = index.Find("dir/b.bin", 200, 0);
+		REQUIRE(entryB);
+		REQUIRE(entryB->flags == TrigramIndex::flagBinary);
+		REQUIRE(entryB->filter.empty());
+		REQUIRE(!index.Find("missing", 0, 0));
+	}
+
+	SECTION("Damaged") {
+		const TemporaryFile indexFile("SciTEUnitTestTrigrams.index");
+		{
+			TrigramIndex index(indexFile.File());
+			index.Update("a.txt", EntryOf("alpha beta", 100));
+			index.Update("b.txt", EntryOf("gamma delta", 100));
+			REQUIRE(index.Save());
+		}
+		const std::string saved = indexFile.Contents();
+		REQUIRE(TrigramIndex(indexFile.File()).Find("b.txt", 100, 11));
+
+		// Any truncation discards the whole index
+		for (size_t length = 0; length < saved.length(); length++) {
+			indexFile.Write(std::string_view(saved).substr(0, length));
+			const TrigramIndex index(indexFile.File());
+			REQUIRE(!index.Find("a.txt", 100, 10));
+			REQUIRE(!index.Find("b.txt", 100, 11));
+		}
+
+		// Trailing data
+		indexFile.Write(saved + "x");
+		REQUIRE(!TrigramIndex(indexFile.File()).Find("a.txt", 100, 10));
+
+		// A different version, as when written by a machine with another byte order
+		std::string otherVersion = saved;
+		otherVersion[8] = 2;
+		indexFile.Write(otherVersion);
+		REQUIRE(!TrigramIndex(indexFile.File()).Find("a.txt", 100, 10));
+
+		// A key length beyond the end of the file
+		std::string longKey = saved;
+		longKey[20] = '\x7f';
+		indexFile.Write(longKey);
+		REQUIRE(!TrigramIndex(indexFile.File()).Find("a.txt", 100, 10));
+
+		// Garbage
+		indexFile.Write("not an index");
+		REQUIRE(!TrigramIndex(indexFile.File()).Find("a.txt", 100, 10));
+	}
+
+	SECTION("Forget") {
+		const TemporaryFile indexFile("SciTEUnitTestTrigrams.index");
+		{
+			TrigramIndex index(indexFile.File());
+			index.Update("seen.txt", EntryOf("seen", 100));
+			index.Update("gone.txt", EntryOf("gone", 100));
+			REQUIRE(index.Save());
+		}
+		// Each load is a new generation so entries not touched are eventually forgotten
+		for (uint32_t search = 0; search <= TrigramIndex::forgetAfter; search++) {
+			TrigramIndex index(indexFile.File());
+			REQUIRE(index.Find("gone.txt", 100, 4));
+			index.Touch("seen.txt");
+			REQUIRE(index.Save());
+		}
+		TrigramIndex index(indexFile.File());
+		REQUIRE(index.Find("seen.txt", 100, 4));
+		REQUIRE(!index.Find("gone.txt", 100, 4));
+	}
+}
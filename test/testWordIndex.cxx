@@ -0,0 +1,252 @@
+/** @file testWordIndex.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <map>
+#include <set>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <future>
+
+#include "ScintillaTypes.h"
+#include "ScintillaCall.h"
+
+#include "GUI.h"
+
+#include "FilePath.h"
+#include "WordIndex.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace SA = Scintilla;
+
+namespace {
+
+const std::string asciiWordCharacters =
+	"0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+
+// Long enough to need more than one scanning step
+constexpr size_t lengthSeveralSteps = 0x28000;
+
+using Counts = std::vector<std::pair<std::string, size_t>>;
+
+Counts AllWords(const WordIndex &index) {
+	Counts counts;
+	for (const WordIndex::WordCount &wordCount : index.WordsStarting("", false)) {
+		counts.emplace_back(wordCount.word, wordCount.count);
+	}
+	return counts;
+}
+
+Counts CountsOfText(std::string_view text) {
+	WordIndex index;
+	index.AddText(text, asciiWordCharacters);
+	return AllWords(index);
+}
+
+void ScanAll(WordIndex &index, SA::ScintillaCall &sci) {
+	while (!index.Complete()) {
+		index.Continue(&sci, 1.0);
+	}
+}
+
+// Where the first scanning step ends: after the last character not in a word in the first chunk.
+SA::Position FirstStep(std::string_view text) {
+	return text.find_last_not_of(asciiWordCharacters, 0x10000 - 1) + 1;
+}
+
+void Insert(WordIndex &index, SA::ScintillaCall &sci, SA::Position position, std::string_view inserted) {
+	sci.text.insert(position, inserted);
+	index.Modified(&sci, position, inserted.length(), 0, nullptr);
+}
+
+void Delete(WordIndex &index, SA::ScintillaCall &sci, SA::Position position, SA::Position length) {
+	const std::string deleted = sci.text.substr(position, length);
+	sci.text.erase(position, length);
+	index.Modified(&sci, position, 0, length, deleted.c_str());
+}
+
+// Text of numbered words so each word is easy to find and most are unique.
+std::string NumberedWords(size_t length) {
+	std::string text;
+	int number = 0;
+	while (text.length() < length) {
+		number++;
+		text += "w" + std::to_string(number) + ((number % 8) ? " " : ".\n");
+	}
+	return text;
+}
+
+}
+
+TEST_CASE("WordIndex") {
+
+	SECTION("AddText") {
+		WordIndex index;
+		index.AddText("one two, one (three) one", asciiWordCharacters);
+		REQUIRE(index.Count() == 3);
+		REQUIRE(AllWords(index) == Counts{{"one", 3}, {"three", 1}, {"two", 1}});
+		index.AddText("two", asciiWordCharacters);
+		REQUIRE(AllWords(index) == Counts{{"one", 3}, {"three", 1}, {"two", 2}});
+		// Changing word characters starts again
+		index.AddText("a-b", asciiWordCharacters + "-");
+		REQUIRE(AllWords(index) == Counts{{"a-b", 1}});
+	}
+
+	SECTION("WordsStarting") {
+		WordIndex index;
+		index.AddText("Apple apple apricot APEX banana apple", asciiWordCharacters);
+		std::vector<std::string> words;
+		for (const WordIndex::WordCount &wordCount : index.WordsStarting("ap", false)) {
+			words.emplace_back(wordCount.word);
+		}
+		REQUIRE(words == std::vector<std::string>{"apple", "apricot"});
+		words.clear();
+		// Every case is adjacent with upper case first
+		for (const WordIndex::WordCount &wordCount : index.WordsStarting("ap", true)) {
+			words.emplace_back(wordCount.word);
+		}
+		REQUIRE(words == std::vector<std::string>{"APEX", "Apple", "apple", "apricot"});
+		REQUIRE(index.WordsStarting("apple", false).front().count == 2);
+		REQUIRE(index.WordsStarting("c", true).empty());
+		REQUIRE(index.WordsStarting("bananas", true).empty());
+	}
+
+	SECTION("Scan") {
+		SA::ScintillaCall sci(NumberedWords(lengthSeveralSteps));
+		WordIndex index;
+		REQUIRE(!index.Complete());
+		index.Start(&sci, asciiWordCharacters);
+		REQUIRE(index.Indexing(&sci, asciiWordCharacters));
+		REQUIRE(!index.Indexing(&sci, "abc"));
+		index.Continue(&sci, 0.0);
+		REQUIRE(!index.Complete());
+		REQUIRE(AllWords(index) == CountsOfText(std::string_view(sci.text).substr(0, FirstStep(sci.text))));
+		ScanAll(index, sci);
+		REQUIRE(index.Indexed(sci.DocPointer()));
+		REQUIRE(AllWords(index) == CountsOfText(sci.text));
+	}
+
+	SECTION("ModifiedSplitJoin") {
+		SA::ScintillaCall sci("one two three two");
+		WordIndex index;
+		index.Start(&sci, asciiWordCharacters);
+		ScanAll(index, sci);
+		// Join "one" and "two"
+		Delete(index, sci, 3, 1);
+		REQUIRE(sci.text == "onetwo three two");
+		REQUIRE(AllWords(index) == Counts{{"onetwo", 1}, {"three", 1}, {"two", 1}});
+		// Split "three"
+		Insert(index, sci, 10, " ");
+		REQUIRE(sci.text == "onetwo thr ee two");
+		REQUIRE(AllWords(index) == CountsOfText(sci.text));
+		// Extend a word at the end of the document
+		Insert(index, sci, sci.Length(), "s");
+		REQUIRE(AllWords(index) == Counts{{"ee", 1}, {"onetwo", 1}, {"thr", 1}, {"twos", 1}});
+		// Join across several words and a deletion containing punctuation
+		Insert(index, sci, 0, "x.");
+		Delete(index, sci, 1, 6);
+		REQUIRE(sci.text == "xo thr ee twos");
+		REQUIRE(AllWords(index) == CountsOfText(sci.text));
+		// Replace by deleting then inserting inside a word
+		Delete(index, sci, 4, 2);
+		Insert(index, sci, 4, "-a-");
+		REQUIRE(sci.text == "xo t-a- ee twos");
+		REQUIRE(AllWords(index) == CountsOfText(sci.text));
+		REQUIRE(index.Complete());
+	}
+
+	SECTION("ModifiedStraddlingScanned") {
+		const std::string original = NumberedWords(lengthSeveralSteps);
+		const SA::Position scanned = FirstStep(original);
+		REQUIRE(scanned > 10);
+
+		// Delete across the end of the scanned text
+		{
+			SA::ScintillaCall sci(original);
+			WordIndex index;
+			index.Start(&sci, asciiWordCharacters);
+			index.Continue(&sci, 0.0);
+			Delete(index, sci, scanned - 6, 12);
+			ScanAll(index, sci);
+			REQUIRE(AllWords(index) == CountsOfText(sci.text));
+		}
+
+		// Insert into the word before the end of the scanned text, joining it with the next word
+		{
+			SA::ScintillaCall sci(original);
+			WordIndex index;
+			index.Start(&sci, asciiWordCharacters);
+			index.Continue(&sci, 0.0);
+			Delete(index, sci, scanned - 1, 1);
+			Insert(index, sci, scanned - 2, "joined");
+			ScanAll(index, sci);
+			REQUIRE(AllWords(index) == CountsOfText(sci.text));
+		}
+
+		// Split a word that starts at the end of the scanned text
+		{
+			SA::ScintillaCall sci(original);
+			WordIndex index;
+			index.Start(&sci, asciiWordCharacters);
+			index.Continue(&sci, 0.0);
+			Insert(index, sci, scanned + 1, " ");
+			Insert(index, sci, scanned, "x");
+			ScanAll(index, sci);
+			REQUIRE(AllWords(index) == CountsOfText(sci.text));
+		}
+
+		// Changes inside the scanned text move its end and changes after it are ignored
+		{
+			SA::ScintillaCall sci(original);
+			WordIndex index;
+			index.Start(&sci, asciiWordCharacters);
+			index.Continue(&sci, 0.0);
+			Insert(index, sci, 0, "first ");
+			Delete(index, sci, 10, 4);
+			Insert(index, sci, scanned + 100, " later ");
+			Delete(index, sci, scanned + 200, 20);
+			ScanAll(index, sci);
+			REQUIRE(AllWords(index) == CountsOfText(sci.text));
+		}
+	}
+
+	SECTION("ModifiedWithoutText") {
+		SA::ScintillaCall sci("alpha beta gamma");
+		WordIndex index;
+		index.Start(&sci, asciiWordCharacters);
+		ScanAll(index, sci);
+		// Without the deleted text its words can not be removed so scanning starts again
+		sci.text.erase(5, 5);
+		index.Modified(&sci, 5, 0, 5, nullptr);
+		REQUIRE(!index.Complete());
+		REQUIRE(index.Count() == 0);
+		ScanAll(index, sci);
+		REQUIRE(AllWords(index) == Counts{{"alpha", 1}, {"gamma", 1}});
+
+		// A length that does not match the change also starts again
+		sci.text += " delta";
+		index.Modified(&sci, 0, 1, 0, nullptr);
+		REQUIRE(!index.Complete());
+		ScanAll(index, sci);
+		REQUIRE(AllWords(index) == CountsOfText(sci.text));
+
+		// Changes to other documents are ignored
+		SA::ScintillaCall sciOther("epsilon");
+		index.Modified(&sciOther, 0, 7, 0, nullptr);
+		REQUIRE(index.Complete());
+		REQUIRE(AllWords(index) == CountsOfText(sci.text));
+	}
+}
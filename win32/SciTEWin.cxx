@@ -855,7 +855,8 @@ void SciTEWin::ExecuteNext() {
 }
 
 void SciTEWin::ExecuteGrep(const Job &jobToRun) {
-	// jobToRun.command is "(w|~)(c|~)(d|~)(b|~)\0files\0excluded\0text"
+	// jobToRun.command is "(w|~)(c|~)(d|~)(b|~)(r|~)(p|~)(i|~)(g|~)(s|~)[:size:depth]\0files\0excluded\0text"
+	// followed by "\0replacement" when replacing
 	std::string_view grepCmd = jobToRun.command;
 	GrepFlags gf = GrepFlags::none;
 	if (grepCmd.front() == 'w')
@@ -870,8 +871,28 @@ void SciTEWin::ExecuteGrep(const Job &jobToRun) {
 	if (grepCmd.front() == 'b')
 		gf = gf | GrepFlags::binary;
 	grepCmd.remove_prefix(1);
-	assert(grepCmd.front() == '\0');
+	if (grepCmd.front() == 'r')
+		gf = gf | GrepFlags::regularExpression;
 	grepCmd.remove_prefix(1);
+	if (grepCmd.front() == 'p')
+		gf = gf | GrepFlags::posix;
+	grepCmd.remove_prefix(1);
+	if (grepCmd.front() == 'i')
+		gf = gf | GrepFlags::index;
+	grepCmd.remove_prefix(1);
+	if (grepCmd.front() == 'g')
+		gf = gf | GrepFlags::ignoreFiles;
+	grepCmd.remove_prefix(1);
+	if (grepCmd.front() == 's')
+		gf = gf | GrepFlags::replace;
+	grepCmd.remove_prefix(1);
+	const size_t endFlags = grepCmd.find('\0');
+	if (endFlags == std::string_view::npos) {
+		// Failure - must have NUL to separate flags and files
+		return;
+	}
+	const GrepLimits limits = GrepLimitsFromText(grepCmd.substr(0, endFlags));
+	grepCmd.remove_prefix(endFlags + 1);
 
 	const size_t endFiles = grepCmd.find('\0');
 	if (endFiles == std::string_view::npos) {
@@ -889,13 +910,23 @@ void SciTEWin::ExecuteGrep(const Job &jobToRun) {
 	const std::string_view excluded = grepCmd.substr(0, endExcluded);
 	grepCmd.remove_prefix(endExcluded + 1);
 
-	const std::string_view text = grepCmd;
+	std::string_view text = grepCmd;
+	std::string_view replacement;
+	if (FlagIsSet(gf, GrepFlags::replace)) {
+		const size_t endText = grepCmd.find('\0');
+		if (endText == std::string_view::npos) {
+			// Failure - must have NUL to separate text and replacement
+			return;
+		}
+		text = grepCmd.substr(0, endText);
+		replacement = grepCmd.substr(endText + 1);
+	}
 
 	if (cmdWorker.outputScroll == 1)
 		gf = gf | GrepFlags::scroll;
 	SA::Position positionEnd = wOutput.Send(SCI_GETCURRENTPOS);
-	InternalGrep(gf, jobToRun.directory, GUI::StringFromUTF8(files), GUI::StringFromUTF8(excluded),
-		text, positionEnd);
+	InternalGrep(gf, limits, jobToRun.directory, GUI::StringFromUTF8(files), GUI::StringFromUTF8(excluded),
+		text, replacement, positionEnd);
 	if (FlagIsSet(gf, GrepFlags::scroll) && returnOutputToCommand)
 		wOutput.Send(SCI_GOTOPOS, positionEnd);
 }
@@ -1448,6 +1479,7 @@ void SciTEWin::RestorePosition() {
 }
 
 void SciTEWin::CreateUI() {
+	const PhaseTimer timer("CreateUI");
 	CreateBuffers();
 
 	int left = props.GetInt("position.left", CW_USEDEFAULT);
@@ -33,6 +33,7 @@
 #include <iomanip>
 #include <atomic>
 #include <mutex>
+#include <thread>
 
 #include <fcntl.h>
 
@@ -84,6 +85,7 @@ typedef void *HTHEME;
 #include "StringList.h"
 #include "StringHelpers.h"
 #include "FilePath.h"
+#include "PhaseProfile.h"
 #include "StyleDefinition.h"
 #include "PropSetFile.h"
 #include "StyleWriter.h"
@@ -95,6 +97,7 @@ typedef void *HTHEME;
 #include "Utf8_16.h"
 #include "FileWorker.h"
 #include "MatchMarker.h"
+#include "BufferReplacer.h"
 #include "Searcher.h"
 #include "SciTEBase.h"
 #include "UniqueInstance.h"
@@ -336,7 +339,7 @@ protected:
 	BOOL ReplaceMessage(HWND hDlg, UINT message, WPARAM wParam);
 	static INT_PTR CALLBACK ReplaceDlg(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam);
 	void UIClosed() override;
-	void PerformGrep();
+	void PerformGrep(bool replace);
 	void FillCombos(Dialog &dlg);
 	void FillCombosForGrep(Dialog &dlg);
 	BOOL GrepMessage(HWND hDlg, UINT message, WPARAM wParam);
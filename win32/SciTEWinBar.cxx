@@ -934,6 +934,19 @@ void SciTEWin::Creation() {
 	wOutput.SetMarginWidthN(1, 0);
 	//wOutput.SetCaretPeriod(0);
 	wOutput.UsePopUp(SA::PopUp::Never);
+
+	// Message-only so never shown and its notifications are not seen
+	wReplacer.SetScintilla(::CreateWindowEx(
+				     0,
+				     TEXT("Scintilla"),
+				     TEXT("Replacer"),
+				     0,
+				     0, 0,
+				     100, 100,
+				     HWND_MESSAGE,
+				     {},
+				     hInstance,
+				     nullptr));
 	::DragAcceptFiles(MainHWND(), true);
 
 	HWND hwndToolBar = ::CreateWindowEx(
@@ -1182,7 +1182,7 @@ static int __stdcall BrowseCallbackProc(HWND hwnd, UINT uMsg, LPARAM, LPARAM pDa
 	return 0;
 }
 
-void SciTEWin::PerformGrep() {
+void SciTEWin::PerformGrep(bool replace) {
 	SelectionIntoProperties();
 
 	std::string findInput;
@@ -1192,22 +1192,36 @@ void SciTEWin::PerformGrep() {
 		flags += jobHasInput;
 	}
 
-	std::string findCommand = props.GetNewExpandString("find.command");
+	// Only the internal search can replace
+	std::string findCommand = replace ? std::string() : props.GetNewExpandString("find.command");
 	if (findCommand == "") {
 		// Call InternalGrep in a new thread
-		// searchParams is "(w|~)(c|~)(d|~)(b|~)\0files\0text"
-		// A "w" indicates whole word, "c" case sensitive, "d" dot directories, "b" binary files
+		// searchParams is "(w|~)(c|~)(d|~)(b|~)(r|~)(p|~)(i|~)(g|~)(s|~)[:size:depth]\0files\0excluded\0text[\0replacement]"
+		// A "w" indicates whole word, "c" case sensitive, "d" dot directories, "b" binary files,
+		// "r" regular expression, "p" POSIX regular expression syntax, "i" use a trigram index,
+		// "g" skip what .gitignore and .ignore files exclude, "s" replace with the text after the
+		// search text, then optional size and depth limits
 		std::string searchParams;
 		searchParams.append(wholeWord ? "w" : "~");
 		searchParams.append(matchCase ? "c" : "~");
 		searchParams.append(props.GetInt("find.in.dot") ? "d" : "~");
 		searchParams.append(props.GetInt("find.in.binary") ? "b" : "~");
+		searchParams.append(regExp ? "r" : "~");
+		searchParams.append(props.GetInt("find.replace.regexp.posix") ? "p" : "~");
+		searchParams.append(props.GetInt("find.in.files.index") ? "i" : "~");
+		searchParams.append(props.GetInt("find.in.files.ignore") ? "g" : "~");
+		searchParams.append(replace ? "s" : "~");
+		searchParams.append(GrepLimitsText());
 		searchParams.append("\0", 1);
 		searchParams.append(props.GetString("find.files"));
 		searchParams.append("\0", 1);
 		searchParams.append(props.GetString("find.exclude"));
 		searchParams.append("\0", 1);
 		searchParams.append(props.GetString("find.what"));
+		if (replace) {
+			searchParams.append("\0", 1);
+			searchParams.append(replaceWhat);
+		}
 		AddCommand(searchParams, props.GetString("find.directory"), JobSubsystem::grep, findInput, flags);
 	} else {
 		AddCommand(findCommand,
@@ -1242,9 +1256,13 @@ BOOL SciTEWin::GrepMessage(HWND hDlg, UINT message, WPARAM wParam) {
 		FillCombos(dlg);
 		FillCombosForGrep(dlg);
 		dlg.SetItemTextU(IDFINDWHAT, props.GetString("find.what"));
+		dlg.SetItemTextU(IDREPLACEWITH, replaceWhat);
 		dlg.SetItemTextU(IDDIRECTORY, props.GetString("find.directory"));
 		dlg.SetCheck(IDWHOLEWORD, wholeWord);
 		dlg.SetCheck(IDMATCHCASE, matchCase);
+		dlg.SetCheck(IDREGEXP, regExp);
+		// An empty search matches at every position so there is nothing sensible to replace
+		dlg.Enable(IDREPLACEALL, !props.GetString("find.what").empty());
 		return TRUE;
 
 	case WM_CLOSE:
@@ -1257,7 +1275,23 @@ BOOL SciTEWin::GrepMessage(HWND hDlg, UINT message, WPARAM wParam) {
 			wFindInFiles.Destroy();
 			return FALSE;
 
-		} else if (ControlIDOfWParam(wParam) == IDOK) {
+		} else if (ControlIDOfWParam(wParam) == IDFINDWHAT) {
+			if (HIWORD(wParam) == CBN_EDITCHANGE) {
+				dlg.Enable(IDREPLACEALL, !dlg.ItemTextG(IDFINDWHAT).empty());
+			} else if (HIWORD(wParam) == CBN_SELCHANGE) {
+				// The edit text is not yet updated so check the chosen item
+				HWND wFindWhat = dlg.Item(IDFINDWHAT);
+				const LRESULT item = ::SendMessage(wFindWhat, CB_GETCURSEL, 0, 0);
+				const LRESULT length = (item == CB_ERR) ? 0 : ::SendMessage(wFindWhat, CB_GETLBTEXTLEN, item, 0);
+				dlg.Enable(IDREPLACEALL, (length != CB_ERR) && (length > 0));
+			}
+			return FALSE;
+
+		} else if ((ControlIDOfWParam(wParam) == IDOK) || (ControlIDOfWParam(wParam) == IDREPLACEALL)) {
+			const bool replace = ControlIDOfWParam(wParam) == IDREPLACEALL;
+			if (replace && dlg.ItemTextG(IDFINDWHAT).empty()) {
+				return FALSE;
+			}
 			if (jobQueue.IsExecuting()) {
 				GUI::gui_string msgBuf = LocaliseMessage("Job is currently executing. Wait until it finishes.");
 				WindowMessageBox(wFindInFiles, msgBuf);
@@ -1266,6 +1300,9 @@ BOOL SciTEWin::GrepMessage(HWND hDlg, UINT message, WPARAM wParam) {
 			findWhat = dlg.ItemTextU(IDFINDWHAT);
 			props.Set("find.what", findWhat);
 			InsertFindInMemory();
+			if (replace) {
+				SetReplace(dlg.ItemTextU(IDREPLACEWITH));
+			}
 
 			std::string files = dlg.ItemTextU(IDFILES);
 			props.Set("find.files", files);
@@ -1277,13 +1314,14 @@ BOOL SciTEWin::GrepMessage(HWND hDlg, UINT message, WPARAM wParam) {
 
 			wholeWord = dlg.Checked(IDWHOLEWORD);
 			matchCase = dlg.Checked(IDMATCHCASE);
+			regExp = dlg.Checked(IDREGEXP);
 
 			SetFindInFilesOptions();
 
 			FillCombos(dlg);
 			FillCombosForGrep(dlg);
 
-			PerformGrep();
+			PerformGrep(replace);
 			if (props.GetInt("find.in.files.close.on.find", 1)) {
 				::EndDialog(hDlg, IDOK);
 				wFindInFiles.Destroy();
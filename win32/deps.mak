@@ -43,6 +43,7 @@ SciTEWin.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -82,6 +83,7 @@ Sc1.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -121,6 +123,7 @@ SciTEWinBar.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -156,6 +159,7 @@ SciTEWinDlg.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -192,6 +196,7 @@ Strips.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -228,6 +233,7 @@ UniqueInstance.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -245,6 +251,14 @@ UniqueInstance.o: \
 	../src/StripDefinition.h \
 	Strips.h \
 	../src/SciTEKeys.h
+BufferReplacer.o: \
+	../src/BufferReplacer.cxx \
+	../../scintilla/include/ILoader.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/ScintillaTypes.h \
+	../../scintilla/include/ScintillaCall.h \
+	../src/GUI.h \
+	../src/BufferReplacer.h
 Cookie.o: \
 	../src/Cookie.cxx \
 	../src/GUI.h \
@@ -270,6 +284,7 @@ Credits.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 EditorConfig.o: \
@@ -299,6 +314,7 @@ ExportHTML.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportPDF.o: \
@@ -321,6 +337,7 @@ ExportPDF.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportRTF.o: \
@@ -343,6 +360,7 @@ ExportRTF.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportTEX.o: \
@@ -365,6 +383,7 @@ ExportTEX.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportXML.o: \
@@ -387,6 +406,7 @@ ExportXML.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 FilePath.o: \
@@ -404,11 +424,31 @@ FileWorker.o: \
 	../src/Worker.h \
 	../src/Utf8_16.h \
 	../src/FileWorker.h
+Grep.o: \
+	../src/Grep.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/Cookie.h \
+	../src/Utf8_16.h \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h \
+	../src/TrigramIndex.h \
+	../src/IgnoreRules.h \
+	../src/ThreadPool.h \
+	../src/Grep.h
 IFaceTable.o: \
 	../src/IFaceTable.cxx \
 	../src/GUI.h \
 	../src/StringHelpers.h \
 	../src/IFaceTable.h
+IgnoreRules.o: \
+	../src/IgnoreRules.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/PathMatch.h \
+	../src/IgnoreRules.h
 JobQueue.o: \
 	../src/JobQueue.cxx \
 	../src/GUI.h \
@@ -440,6 +480,10 @@ MatchMarker.o: \
 	../../scintilla/include/ScintillaTypes.h \
 	../../scintilla/include/ScintillaCall.h \
 	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h \
+	../src/ThreadPool.h \
 	../src/MatchMarker.h
 MultiplexExtension.o: \
 	../src/MultiplexExtension.cxx \
@@ -454,14 +498,29 @@ PathMatch.o: \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
 	../src/PathMatch.h
+PhaseProfile.o: \
+	../src/PhaseProfile.cxx \
+	../src/GUI.h \
+	../src/PhaseProfile.h
 PropSetFile.o: \
 	../src/PropSetFile.cxx \
 	../src/GUI.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
 	../src/PathMatch.h \
+	../src/PhaseProfile.h \
 	../src/PropSetFile.h \
 	../src/EditorConfig.h
+PropSetSnapshot.o: \
+	../src/PropSetSnapshot.cxx \
+	../src/GUI.h \
+	../src/FilePath.h \
+	../src/PropSetFile.h \
+	../src/PropSetSnapshot.h
+RegexSearch.o: \
+	../src/RegexSearch.cxx \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h
 ScintillaWindow.o: \
 	../src/ScintillaWindow.cxx \
 	../../scintilla/include/ScintillaTypes.h \
@@ -485,6 +544,7 @@ SciTEBase.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -496,6 +556,8 @@ SciTEBase.o: \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
+	../src/WordIndex.h \
 	../src/EditorConfig.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
@@ -511,6 +573,7 @@ SciTEBuffers.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -522,6 +585,7 @@ SciTEBuffers.o: \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 SciTEIO.o: \
@@ -545,7 +609,9 @@ SciTEIO.o: \
 	../src/Worker.h \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
+	../src/Grep.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 SciTEProps.o: \
@@ -564,8 +630,10 @@ SciTEProps.o: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
+	../src/PropSetSnapshot.h \
 	../src/StyleWriter.h \
 	../src/Extender.h \
 	../src/SciTE.h \
@@ -573,6 +641,7 @@ SciTEProps.o: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/EditorConfig.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h \
@@ -585,7 +654,8 @@ StringList.o: \
 	../src/StringList.cxx \
 	../src/GUI.h \
 	../src/StringList.h \
-	../src/StringHelpers.h
+	../src/StringHelpers.h \
+	../src/FilePath.h
 StyleDefinition.o: \
 	../src/StyleDefinition.cxx \
 	../../scintilla/include/ScintillaTypes.h \
@@ -599,10 +669,31 @@ StyleWriter.o: \
 	../../scintilla/include/ScintillaStructures.h \
 	../src/GUI.h \
 	../src/StyleWriter.h
+SubstringSearch.o: \
+	../src/SubstringSearch.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/SubstringSearch.h
+ThreadPool.o: \
+	../src/ThreadPool.cxx \
+	../src/ThreadPool.h
+TrigramIndex.o: \
+	../src/TrigramIndex.cxx \
+	../src/GUI.h \
+	../src/FilePath.h \
+	../src/TrigramIndex.h
 Utf8_16.o: \
 	../src/Utf8_16.cxx \
 	../src/Cookie.h \
 	../src/Utf8_16.h
+WordIndex.o: \
+	../src/WordIndex.cxx \
+	../../scintilla/include/ScintillaTypes.h \
+	../../scintilla/include/ScintillaCall.h \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/WordIndex.h
 lapi.o: \
 	../lua/src/lapi.c \
 	../lua/src/lprefix.h \
@@ -43,6 +43,7 @@ SciTEWin.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -82,6 +83,7 @@ Sc1.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -121,6 +123,7 @@ SciTEWinBar.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -156,6 +159,7 @@ SciTEWinDlg.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -192,6 +196,7 @@ Strips.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -228,6 +233,7 @@ UniqueInstance.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -245,6 +251,14 @@ UniqueInstance.obj: \
 	../src/StripDefinition.h \
 	Strips.h \
 	../src/SciTEKeys.h
+BufferReplacer.obj: \
+	../src/BufferReplacer.cxx \
+	../../scintilla/include/ILoader.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/ScintillaTypes.h \
+	../../scintilla/include/ScintillaCall.h \
+	../src/GUI.h \
+	../src/BufferReplacer.h
 Cookie.obj: \
 	../src/Cookie.cxx \
 	../src/GUI.h \
@@ -270,6 +284,7 @@ Credits.obj: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 EditorConfig.obj: \
@@ -299,6 +314,7 @@ ExportHTML.obj: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportPDF.obj: \
@@ -321,6 +337,7 @@ ExportPDF.obj: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportRTF.obj: \
@@ -343,6 +360,7 @@ ExportRTF.obj: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportTEX.obj: \
@@ -365,6 +383,7 @@ ExportTEX.obj: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 ExportXML.obj: \
@@ -387,6 +406,7 @@ ExportXML.obj: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 FilePath.obj: \
@@ -404,11 +424,31 @@ FileWorker.obj: \
 	../src/Worker.h \
 	../src/Utf8_16.h \
 	../src/FileWorker.h
+Grep.obj: \
+	../src/Grep.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/Cookie.h \
+	../src/Utf8_16.h \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h \
+	../src/TrigramIndex.h \
+	../src/IgnoreRules.h \
+	../src/ThreadPool.h \
+	../src/Grep.h
 IFaceTable.obj: \
 	../src/IFaceTable.cxx \
 	../src/GUI.h \
 	../src/StringHelpers.h \
 	../src/IFaceTable.h
+IgnoreRules.obj: \
+	../src/IgnoreRules.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/PathMatch.h \
+	../src/IgnoreRules.h
 JobQueue.obj: \
 	../src/JobQueue.cxx \
 	../src/GUI.h \
@@ -440,6 +480,10 @@ MatchMarker.obj: \
 	../../scintilla/include/ScintillaTypes.h \
 	../../scintilla/include/ScintillaCall.h \
 	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h \
+	../src/ThreadPool.h \
 	../src/MatchMarker.h
 MultiplexExtension.obj: \
 	../src/MultiplexExtension.cxx \
@@ -454,14 +498,29 @@ PathMatch.obj: \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
 	../src/PathMatch.h
+PhaseProfile.obj: \
+	../src/PhaseProfile.cxx \
+	../src/GUI.h \
+	../src/PhaseProfile.h
 PropSetFile.obj: \
 	../src/PropSetFile.cxx \
 	../src/GUI.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
 	../src/PathMatch.h \
+	../src/PhaseProfile.h \
 	../src/PropSetFile.h \
 	../src/EditorConfig.h
+PropSetSnapshot.obj: \
+	../src/PropSetSnapshot.cxx \
+	../src/GUI.h \
+	../src/FilePath.h \
+	../src/PropSetFile.h \
+	../src/PropSetSnapshot.h
+RegexSearch.obj: \
+	../src/RegexSearch.cxx \
+	../src/SubstringSearch.h \
+	../src/RegexSearch.h
 ScintillaWindow.obj: \
 	../src/ScintillaWindow.cxx \
 	../../scintilla/include/ScintillaTypes.h \
@@ -485,6 +544,7 @@ SciTEBase.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -496,6 +556,8 @@ SciTEBase.obj: \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
+	../src/WordIndex.h \
 	../src/EditorConfig.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
@@ -511,6 +573,7 @@ SciTEBuffers.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
 	../src/StyleWriter.h \
@@ -522,6 +585,7 @@ SciTEBuffers.obj: \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 SciTEIO.obj: \
@@ -545,7 +609,9 @@ SciTEIO.obj: \
 	../src/Worker.h \
 	../src/Utf8_16.h \
 	../src/FileWorker.h \
+	../src/Grep.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h
 SciTEProps.obj: \
@@ -564,8 +630,10 @@ SciTEProps.obj: \
 	../src/StringList.h \
 	../src/StringHelpers.h \
 	../src/FilePath.h \
+	../src/PhaseProfile.h \
 	../src/StyleDefinition.h \
 	../src/PropSetFile.h \
+	../src/PropSetSnapshot.h \
 	../src/StyleWriter.h \
 	../src/Extender.h \
 	../src/SciTE.h \
@@ -573,6 +641,7 @@ SciTEProps.obj: \
 	../src/Cookie.h \
 	../src/Worker.h \
 	../src/MatchMarker.h \
+	../src/BufferReplacer.h \
 	../src/EditorConfig.h \
 	../src/Searcher.h \
 	../src/SciTEBase.h \
@@ -585,7 +654,8 @@ StringList.obj: \
 	../src/StringList.cxx \
 	../src/GUI.h \
 	../src/StringList.h \
-	../src/StringHelpers.h
+	../src/StringHelpers.h \
+	../src/FilePath.h
 StyleDefinition.obj: \
 	../src/StyleDefinition.cxx \
 	../../scintilla/include/ScintillaTypes.h \
@@ -599,10 +669,31 @@ StyleWriter.obj: \
 	../../scintilla/include/ScintillaStructures.h \
 	../src/GUI.h \
 	../src/StyleWriter.h
+SubstringSearch.obj: \
+	../src/SubstringSearch.cxx \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/SubstringSearch.h
+ThreadPool.obj: \
+	../src/ThreadPool.cxx \
+	../src/ThreadPool.h
+TrigramIndex.obj: \
+	../src/TrigramIndex.cxx \
+	../src/GUI.h \
+	../src/FilePath.h \
+	../src/TrigramIndex.h
 Utf8_16.obj: \
 	../src/Utf8_16.cxx \
 	../src/Cookie.h \
 	../src/Utf8_16.h
+WordIndex.obj: \
+	../src/WordIndex.cxx \
+	../../scintilla/include/ScintillaTypes.h \
+	../../scintilla/include/ScintillaCall.h \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/WordIndex.h
 lapi.obj: \
 	../lua/src/lapi.c \
 	../lua/src/lprefix.h \
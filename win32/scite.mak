@@ -61,6 +61,7 @@ CCFLAGS=$(CCFLAGS) $(CXXNDEBUG)
 INCLUDEDIRS=-I../../lexilla/include -I../../lexilla/access -I../../scintilla/include -I../src
 
 SHAREDOBJS=\
+	BufferReplacer.obj \
 	Cookie.obj \
 	Credits.obj \
 	DirectorExtension.obj \
@@ -72,14 +73,19 @@ SHAREDOBJS=\
 	ExportXML.obj \
 	FilePath.obj \
 	FileWorker.obj \
+	Grep.obj \
 	GUIWin.obj \
 	IFaceTable.obj \
+	IgnoreRules.obj \
 	JobQueue.obj \
 	LexillaAccess.obj \
 	MatchMarker.obj \
 	MultiplexExtension.obj \
 	PathMatch.obj \
+	PhaseProfile.obj \
 	PropSetFile.obj \
+	PropSetSnapshot.obj \
+	RegexSearch.obj \
 	ScintillaCall.obj \
 	ScintillaWindow.obj \
 	SciTEBase.obj \
@@ -93,8 +99,12 @@ SHAREDOBJS=\
 	Strips.obj \
 	StyleDefinition.obj \
 	StyleWriter.obj \
+	SubstringSearch.obj \
+	ThreadPool.obj \
+	TrigramIndex.obj \
 	UniqueInstance.obj \
-	Utf8_16.obj
+	Utf8_16.obj \
+	WordIndex.obj
 
 OBJS=\
 	$(SHAREDOBJS) \